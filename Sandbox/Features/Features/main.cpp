@@ -1,5 +1,6 @@
 #define TEST(name, fnc) void name () { NET_LOG(CSTRING("---------------------------------------")); NET_LOG(CSTRING("Test Case: " #name)); NET_LOG(CSTRING("----------------------------------------")); fnc NET_LOG(CSTRING("----------------------------------------")); }
 #define RUN(name) name ();
+#define CHECK(expr) if (!(expr)) { NET_LOG_ERROR(CSTRING("FAILED: %s (line %d)"), CSTRING(#expr), __LINE__); ++failures; } else { NET_LOG(CSTRING("passed: %s"), CSTRING(#expr)); }
 #define NTP_HOST "129.250.35.251"
 
 #include <Net/Net/Net.h>
@@ -34,11 +35,21 @@
 // Protocol
 #include <Net/Protocol/NTP.h>
 
+// network input
+#include <Net/Net/NetRateLimit.h>
+#include <Net/Net/NetFraming.h>
+#include <Net/Net/NetTaskPool.h>
+
+#include <thread>
+
 #ifndef BUILD_LINUX
 #pragma comment(lib, "NetCore_static.lib")
 #pragma comment(lib, "NetClient_static.lib")
 #endif
 
+/* checks that failed, the exit code */
+static int failures = 0;
+
 TEST(Basic,
 );
 
@@ -308,11 +319,282 @@ TEST(JSON,
 	NET_LOG(doc.Serialize(Net::Json::SerializeType::FORMATTED));
 );
 
+TEST(RateLimit,
+	// rate 0 disables the bucket
+	Net::RateLimit::Bucket_t disabled;
+	CHECK(!disabled.enabled());
+	CHECK(disabled.allow(1e12));
+
+	// a new bucket starts full
+	Net::RateLimit::Bucket_t bucket;
+	bucket.set(10, 5);
+	CHECK(bucket.allow(5));
+	bucket.take(5);
+	CHECK(!bucket.allow(1));
+
+	// the refill stops at the burst, waiting longer does not save up tokens
+	Net::RateLimit::Bucket_t capped;
+	capped.set(100, 5);
+	capped.take(5);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	CHECK(capped.allow(5));
+	capped.take(5);
+	CHECK(!capped.allow(1));
+
+	// an amount bigger than the burst passes once the bucket is full, the debt has to be refilled afterwards
+	Net::RateLimit::Bucket_t debt;
+	debt.set(100, 4);
+	CHECK(debt.allow(100));
+	debt.take(100);
+	CHECK(!debt.allow(1));
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	CHECK(!debt.allow(1));
+
+	// the burst is atleast one token
+	Net::RateLimit::Bucket_t minimum;
+	minimum.set(1, 0);
+	CHECK(minimum.allow(1));
+);
+
+TEST(BinaryFraming,
+	// little endian writer, the frame is built by hand soo every field can be broken on purpose
+	auto put = [](byte* out, uint64_t value, size_t len) { for (size_t i = 0; i < len; ++i) out[i] = static_cast<byte>(value >> (i * 8)); };
+
+	// {RAW_DATA "k" = "ab"}{DATA "xyz"}
+	const size_t size = NET_FRAMING_V2_HEADER_LEN + 2 * NET_FRAMING_V2_SECTION_LEN + 7;
+	byte valid[size] = {};
+	memcpy(valid, NET_FRAMING_V2_MAGIC, NET_FRAMING_V2_MAGIC_LEN);
+	put(&valid[6], 2, 2);
+	put(&valid[8], 42, 4);
+	put(&valid[16], size, 8);
+	valid[24] = static_cast<byte>(Net::Framing::Section_t::RAW_DATA);
+	put(&valid[28], 2, 4);
+	put(&valid[32], 2, 8);
+	put(&valid[40], 2, 8);
+	valid[48] = static_cast<byte>(Net::Framing::Section_t::DATA);
+	put(&valid[56], 3, 8);
+	put(&valid[64], 3, 8);
+	memcpy(&valid[72], "k\0abxyz", 7);
+
+	byte frame[size];
+	Net::Framing::View_t view;
+	Net::Framing::section_t section;
+
+	memcpy(frame, valid, size);
+	CHECK(Net::Framing::is_binary(frame, size));
+	CHECK(!Net::Framing::is_binary(frame, NET_FRAMING_V2_MAGIC_LEN - 1));
+	CHECK(Net::Framing::frame_size(frame) == size);
+	CHECK(Net::Framing::table_size(frame) == size - 7);
+	CHECK(view.parse(frame, size));
+	CHECK(view.id() == 42);
+	CHECK(view.next(section) && section.type == Net::Framing::Section_t::RAW_DATA && !strcmp(section.key, "k") && section.size == 2);
+	CHECK(view.next(section) && section.type == Net::Framing::Section_t::DATA && section.size == 3 && !memcmp(section.data, "xyz", 3));
+	CHECK(!view.next(section));
+
+	// truncated: every prefix of the frame is rejected
+	bool truncated = false;
+	for (size_t len = NET_FRAMING_V2_MAGIC_LEN; len < size; ++len)
+		truncated |= view.parse(frame, len);
+	CHECK(!truncated);
+
+	// the frame size does not match the received bytes
+	put(&frame[16], size + 1, 8);
+	CHECK(!view.parse(frame, size));
+	put(&frame[16], UINT64_MAX, 8);
+	CHECK(!view.parse(frame, size));
+
+	// the section table does not fit into the frame
+	memcpy(frame, valid, size);
+	put(&frame[6], 0xFFFF, 2);
+	CHECK(!view.parse(frame, size));
+
+	// a section size that runs past the end of the frame, or overflows once the offset is added
+	memcpy(frame, valid, size);
+	put(&frame[56], 4, 8);
+	CHECK(!view.parse(frame, size));
+	put(&frame[56], UINT64_MAX, 8);
+	CHECK(!view.parse(frame, size));
+
+	// the payloads do not fill up the frame
+	memcpy(frame, valid, size);
+	put(&frame[56], 2, 8);
+	CHECK(!view.parse(frame, size));
+
+	// raw data keys: empty, bigger than the limit or not terminated
+	memcpy(frame, valid, size);
+	put(&frame[28], 0, 4);
+	CHECK(!view.parse(frame, size));
+	put(&frame[28], 257, 4);
+	CHECK(!view.parse(frame, size));
+	memcpy(frame, valid, size);
+	frame[73] = 'x';
+	CHECK(!view.parse(frame, size));
+
+	// only raw data has a key, unknown section types are rejected
+	memcpy(frame, valid, size);
+	put(&frame[52], 1, 4);
+	CHECK(!view.parse(frame, size));
+	memcpy(frame, valid, size);
+	frame[48] = 0;
+	CHECK(!view.parse(frame, size));
+	frame[48] = 5;
+	CHECK(!view.parse(frame, size));
+
+	// ids above INT32_MAX can not be handed to the callbacks
+	memcpy(frame, valid, size);
+	put(&frame[8], 0x80000000u, 4);
+	CHECK(Net::Framing::frame_id(frame) == -1);
+
+	// the reader validates the table the same way, the payload is handed out byte by byte
+	Net::Framing::Reader_t reader;
+	memcpy(frame, valid, size);
+	CHECK(reader.begin(frame));
+	std::string payload;
+	size_t offset = NET_FRAMING_V2_HEADER_LEN + 2 * NET_FRAMING_V2_SECTION_LEN;
+	bool ok = true;
+	while (ok && !reader.done() && offset < size)
+	{
+		size_t consumed = 0;
+		Net::Framing::piece_t piece;
+		ok = reader.read(&frame[offset], 1, consumed, piece);
+		offset += consumed;
+		if (piece.data) payload.append(reinterpret_cast<char*>(piece.data), piece.size);
+	}
+	CHECK(ok && reader.done() && offset == size && payload == "abxyz");
+
+	put(&frame[56], 4, 8);
+	CHECK(!reader.begin(frame));
+	memcpy(frame, valid, size);
+	put(&frame[28], 257, 4);
+	CHECK(!reader.begin(frame));
+	memcpy(frame, valid, size);
+	frame[73] = 'x';
+	CHECK(reader.begin(frame));
+	size_t consumed = 0;
+	Net::Framing::piece_t piece;
+	CHECK(!reader.read(&frame[72], 2, consumed, piece));
+	reader.end();
+);
+
+TEST(TextFraming,
+	// {BP}{PS}{<size>}<body>{EP}, the size covers the whole frame including its own digits
+	auto build = [](const std::string& body)
+	{
+		size_t size = 0;
+		for (int i = 0; i < 3; ++i)
+			size = strlen(NET_PACKET_HEADER) + strlen(NET_PACKET_SIZE) + std::to_string(size).size() + 2 + body.size() + strlen(NET_PACKET_FOOTER);
+
+		return std::string(NET_PACKET_HEADER) + NET_PACKET_SIZE + "{" + std::to_string(size) + "}" + body + NET_PACKET_FOOTER;
+	};
+
+	// the view points into the frame, it is only used for the result
+	auto parse = [](Net::Framing::View_t& view, std::string frame) { return view.parse(reinterpret_cast<byte*>(&frame[0]), frame.size()); };
+
+	Net::Framing::View_t view;
+	Net::Framing::section_t section;
+
+	auto valid = build(std::string("{RDK}{5}file") + '\0' + "{RD}{5}hello{D}{7}{\"a\":1}");
+	CHECK(!Net::Framing::is_binary(reinterpret_cast<const byte*>(valid.data()), valid.size()));
+	CHECK(view.parse(reinterpret_cast<byte*>(&valid[0]), valid.size()));
+	CHECK(view.id() == -1 && view.flags() == 0);
+	CHECK(view.next(section) && section.type == Net::Framing::Section_t::RAW_DATA && !strcmp(section.key, "file") && section.size == 5 && !memcmp(section.data, "hello", 5));
+	CHECK(view.next(section) && section.type == Net::Framing::Section_t::DATA && section.size == 7);
+	CHECK(!view.next(section));
+
+	// the flags are derived from the tags being used
+	auto compressed = build("{POS}{9}{D}{7}{\"a\":1}");
+	CHECK(view.parse(reinterpret_cast<byte*>(&compressed[0]), compressed.size()) && view.flags() == NET_FRAMING_V2_FLAG_COMPRESSION);
+	CHECK(view.next(section) && section.original_size == 9);
+	CHECK(parse(view, build("{AK}{3}KEY{AV}{2}IV{D}{7}{\"a\":1}")) && view.flags() == NET_FRAMING_V2_FLAG_CIPHER);
+
+	// truncated: every prefix of the frame is rejected
+	bool truncated = false;
+	for (size_t len = 0; len < valid.size(); ++len)
+		truncated |= view.parse(reinterpret_cast<byte*>(&valid[0]), len);
+	CHECK(!truncated);
+
+	// the frame size does not match the received bytes
+	auto resized = valid;
+	resized.replace(resized.find("{PS}{") + 5, 1, "9");
+	CHECK(!parse(view, resized));
+	CHECK(!parse(view, valid + "junk"));
+	CHECK(!parse(view, build("{D}{7}{\"a\":1}junk")));
+
+	// numbers: missing, not terminated, not decimal or too long to fit
+	CHECK(!parse(view, build("{D}{}{\"a\":1}")));
+	CHECK(!parse(view, build("{D}{7{\"a\":1}")));
+	CHECK(!parse(view, build("{D}{7x}{\"a\":1}")));
+	CHECK(!parse(view, build("{D}{-7}{\"a\":1}")));
+	CHECK(!parse(view, build("{D}{99999999999999999999}{\"a\":1}")));
+	CHECK(!parse(view, build("{POS}{}{D}{7}{\"a\":1}")));
+
+	// a section size that runs past the end of the frame
+	CHECK(!parse(view, build("{D}{70}{\"a\":1}")));
+	CHECK(!parse(view, build("{D}{18446744073709551615}{\"a\":1}")));
+
+	// raw data keys: empty, bigger than the limit or not terminated
+	CHECK(!parse(view, build("{RDK}{0}{RD}{5}hello")));
+	CHECK(!parse(view, build("{RDK}{257}" + std::string(256, 'k') + '\0' + "{RD}{5}hello")));
+	CHECK(!parse(view, build("{RDK}{4}file{RD}{5}hello")));
+	CHECK(!parse(view, build(std::string("{RDK}{5}file") + '\0' + "{5}hello")));
+
+	// unknown tags
+	CHECK(!parse(view, build("{X}{7}{\"a\":1}")));
+	CHECK(!parse(view, "{BP}{D}{7}{\"a\":1}{EP}"));
+);
+
+TEST(TaskPool,
+	// a full key only holds back its own producer, the tasks of the other keys are still executed
+	Net::TaskPool::TaskPool_t pool;
+	pool.set_num_threads(2);
+	pool.set_max_depth(4);
+	CHECK(pool.start());
+
+	static std::atomic<bool> release;
+	static std::atomic<int> executed_a;
+	static std::atomic<int> executed_b;
+	release = false;
+	executed_a = 0;
+	executed_b = 0;
+
+	int a = 0;
+	int b = 0;
+	auto task_a = [](void*) { while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1)); ++executed_a; };
+	auto task_b = [](void*) { ++executed_b; };
+
+	// posting never blocks, the key reports being full instead
+	for (int i = 0; i < 8; ++i)
+		CHECK(pool.post(&a, task_a, nullptr));
+
+	CHECK(pool.full(&a));
+	CHECK(!pool.full(&b));
+	CHECK(pool.post(&b, task_b, nullptr));
+
+	for (int i = 0; i < 1000 && executed_b != 1; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(executed_b == 1);
+	CHECK(executed_a == 0);
+	CHECK(pool.throttled() == 1);
+
+	release = true;
+	pool.throttle(&a);
+	pool.wait(&a);
+	CHECK(!pool.full(&a));
+	CHECK(executed_a == 8);
+
+	pool.stop();
+);
+
 int main()
 {
 	NET_INITIALIZE(Net::ENABLE_LOGGING);
 
 	RUN(Basic);
+	RUN(RateLimit);
+	RUN(BinaryFraming);
+	RUN(TextFraming);
+	RUN(TaskPool);
 	RUN(Hex);
 	RUN(Base32);
 	RUN(Base64);
@@ -331,5 +613,5 @@ int main()
 
 	NET_UNLOAD;
 
-	return 0;
+	return failures ? 1 : 0;
 }
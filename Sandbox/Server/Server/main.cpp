@@ -9,6 +9,77 @@
 #pragma comment(lib, "NetServer_static.lib")
 #endif
 
+#ifdef BUILD_LINUX
+#include <vector>
+
+/* amount of idle connections the footprint is measured with */
+#define SANDBOX_IDLE_PEERS 256
+
+/* resident memory of the process in bytes */
+static size_t ResidentMemory()
+{
+	FILE* file = fopen(CSTRING("/proc/self/statm"), CSTRING("r"));
+	if (!file)
+		return 0;
+
+	long pages = 0;
+	long resident = 0;
+	if (fscanf(file, CSTRING("%ld %ld"), &pages, &resident) != 2)
+		resident = 0;
+
+	fclose(file);
+	return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/* memory held by one connected peer that is not sending anything, measured using loopback connections that stay silent */
+static void MeasureIdlePeers(Server& server)
+{
+	const auto peers = server.count_peers_all();
+	const auto before = ResidentMemory();
+
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SANDBOX_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	std::vector<int> sockets;
+	for (size_t i = 0; i < SANDBOX_IDLE_PEERS; ++i)
+	{
+		const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd == -1)
+			break;
+
+		if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+		{
+			close(fd);
+			break;
+		}
+
+		sockets.emplace_back(fd);
+	}
+
+	// the server accepts them and sends its part of the handshake
+	for (int i = 0; i < 2000 && server.count_peers_all() < peers + sockets.size(); ++i)
+		usleep(1000);
+
+	usleep(100 * 1000);
+
+	const auto accepted = server.count_peers_all() - peers;
+	const auto after = ResidentMemory();
+	if (accepted > 0 && after > before)
+	{
+		NET_LOG(CSTRING("Idle peer footprint: %llu bytes resident per connection (%llu connections)"), static_cast<unsigned long long>((after - before) / accepted), static_cast<unsigned long long>(accepted));
+	}
+	else
+	{
+		NET_LOG(CSTRING("Idle peer footprint: not measurable (%llu connections)"), static_cast<unsigned long long>(accepted));
+	}
+
+	for (const auto fd : sockets)
+		close(fd);
+}
+#endif
+
 int main()
 {
 	Net::load(Net::ENABLE_LOGGING);
@@ -27,6 +98,11 @@ int main()
 	if (!server.Run())
 		NET_LOG_ERROR(CSTRING("UNABLE TO RUN SERVER"));
 
+#ifdef BUILD_LINUX
+	if (server.IsRunning())
+		MeasureIdlePeers(server);
+#endif
+
 	while (server.IsRunning())
 	{
 #ifdef BUILD_LINUX
@@ -33,10 +33,12 @@ namespace Net
 			IV = RUNTIMEXOR();
 			Key = RUNTIMEXOR();
 			KeyLength = NULL;
+			Stream = nullptr;
 		}
 
 		AES::~AES()
 		{
+			endStream();
 			IV.free();
 			Key.free();
 		}
@@ -184,5 +186,45 @@ namespace Net
 
 			return false;
 		}
+
+		bool AES::beginStream()
+		{
+			endStream();
+
+			try
+			{
+				Stream = ALLOC<CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption>(1, reinterpret_cast<const CryptoPP::byte*>(Key.revert().get()), KeyLength, reinterpret_cast<const CryptoPP::byte*>(IV.revert().get()));
+			}
+			catch (const CryptoPP::Exception& ex)
+			{
+				NET_LOG_ERROR(CSTRING("[NET_AES][DECRPYT] - %s"), ex.what());
+				Stream = nullptr;
+			}
+
+			return Stream != nullptr;
+		}
+
+		bool AES::decryptStream(CryptoPP::byte* data, const size_t size)
+		{
+			if (!Stream)
+				return false;
+
+			try
+			{
+				Stream->ProcessData(data, data, size);
+				return true;
+			}
+			catch (const CryptoPP::Exception& ex)
+			{
+				NET_LOG_ERROR(CSTRING("[NET_AES][DECRPYT] - %s"), ex.what());
+				return false;
+			}
+		}
+
+		void AES::endStream()
+		{
+			FREE<CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption>(Stream);
+			Stream = nullptr;
+		}
 	}
 }
\ No newline at end of file
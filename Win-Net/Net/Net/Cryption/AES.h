@@ -51,6 +51,9 @@ namespace Net
 			RUNTIMEXOR IV;
 			size_t KeyLength;
 
+			/* CFB decryptor kept between the calls of decryptStream */
+			CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption* Stream;
+
 			/* ACTUALL ENC/DEC FUNC */
 			bool encrypt(CryptoPP::byte*, const size_t, const char*, const char*) const;
 			bool decrypt(CryptoPP::byte*, const size_t, const char*, const char*) const;
@@ -73,6 +76,11 @@ namespace Net
 			bool decryptHex(CryptoPP::byte*&, size_t&);
 			bool decryptBase64(CryptoPP::byte*&, size_t&);
 			bool decryptBase64(CryptoPP::byte*, CryptoPP::byte*&, size_t&);
+
+			/* CFB is a stream mode, a section can be decrypted piece by piece - every section starts over with beginStream */
+			bool beginStream();
+			bool decryptStream(CryptoPP::byte*, size_t);
+			void endStream();
 		};
 	}
 }
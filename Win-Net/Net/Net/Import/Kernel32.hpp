@@ -118,6 +118,12 @@ MAKE_IMPORT(hThread);
 DEFINE_IMPORT(HANDLE, GetCurrentThread);
 MAKE_IMPORT();
 
+DEFINE_IMPORT(DWORD_PTR, SetThreadAffinityMask, HANDLE hThread, DWORD_PTR dwThreadAffinityMask);
+MAKE_IMPORT(hThread, dwThreadAffinityMask);
+
+DEFINE_IMPORT(BOOL, SetThreadPriority, HANDLE hThread, int nPriority);
+MAKE_IMPORT(hThread, nPriority);
+
 DEFINE_IMPORT(PVOID, AddVectoredExceptionHandler, ULONG First, PVECTORED_EXCEPTION_HANDLER Handler);
 MAKE_IMPORT(First, Handler);
 
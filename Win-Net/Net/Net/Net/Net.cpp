@@ -101,6 +101,28 @@ int Net::SocketOpt(SOCKET s, int level, int optname, SOCKET_OPT_TYPE optval, SOC
 #endif
 }
 
+byte* Net::ReceiveBuffer()
+{
+	struct receive_buffer_t
+	{
+		byte* data;
+
+		receive_buffer_t()
+		{
+			data = ALLOC<byte>(NET_OPT_DEFAULT_MAX_PACKET_SIZE + 1);
+		}
+
+		~receive_buffer_t()
+		{
+			FREE<byte>(data);
+		}
+	};
+
+	// allocated on first use, released as soon as the thread exits
+	thread_local static receive_buffer_t buffer;
+	return buffer.data;
+}
+
 std::string Net::sock_err::getString(const int err, const bool is_ssl)
 {
 	if (is_ssl)
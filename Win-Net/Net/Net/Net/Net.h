@@ -58,6 +58,7 @@
 #include <algorithm>
 #include <map>
 #include <vector>
+#include <deque>
 #include <memory>
 #include <chrono>
 
@@ -127,6 +128,7 @@ typedef unsigned __int64 uint64;
 #define SOCKET_OPT_TYPE char*
 #define SOCKET_OPT_LEN int
 #define MSG_NOSIGNAL 0
+#define MSG_DONTWAIT 0
 #endif
 
 ///////////////////////////////////
@@ -160,6 +162,7 @@ virtual type name(__VA_ARGS__)
 #define NET_UNLOAD Net::unload()
 
 /* DATA STRUCTURE ALIGNEMNT */
+/* atomics and mutexes have to keep their natural alignment, the structures holding them are declared outside of it */
 #ifndef BUILD_LINUX
 #define NET_DSA_BEGIN __pragma("pack(push)") \
  __pragma("pack(1)")
@@ -354,12 +357,12 @@ public:
 class OptionInterface_t
 {
 public:
-	OptionInterface_t(DWORD opt)
+	OptionInterface_t(uint64_t opt)
 	{
 		this->opt = opt;
 	}
 
-	DWORD opt;
+	uint64_t opt;
 
 	virtual int optlen() = 0;
 };
@@ -370,7 +373,7 @@ class Option_t : public OptionInterface_t
 	T _value;
 
 public:
-	Option_t(DWORD opt, T value) : OptionInterface_t(opt)
+	Option_t(uint64_t opt, T value) : OptionInterface_t(opt)
 	{
 		this->_value = value;
 	}
@@ -407,6 +410,13 @@ namespace Net
 
 	int SocketOpt(SOCKET, int, int, SOCKET_OPT_TYPE, SOCKET_OPT_LEN);
 
+	/*
+	* scratch space to read from a socket, one buffer per thread
+	* holds NET_OPT_DEFAULT_MAX_PACKET_SIZE bytes plus a null terminator
+	* received bytes must be copied into the peer's own buffer before the thread reads again
+	*/
+	byte* ReceiveBuffer();
+
 	namespace sock_err
 	{
 		std::string getString(const int, bool = false);
@@ -700,13 +710,178 @@ namespace WebServerHandshake
 /* Server & Client Option */
 
 /*
-* this option will force the library to spawn a thread to execute the packet in there
+* this option will hand the packet over to a fixed set of worker threads to execute it in there
 * without this option, any callback that might perform some big job will block the socket from further execution
-* enable this option to perform the job in a seperate thread
+* packets of the same peer are still being executed in the order they have been received
 */
 #define NET_OPT_EXECUTE_PACKET_ASYNC (1 << 26)
 #define NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC false
 
+/* Server Option */
+
+/*
+* linux only: replace the sleep-polled peer thread pool by an edge-triggered epoll reactor
+* peers are only processed as soon as their socket becomes readable
+*/
+#define NET_OPT_USE_REACTOR (1 << 27)
+#define NET_OPT_DEFAULT_USE_REACTOR false
+
+/* amount of worker threads being spawned by the reactor or the peer pool - 0 will use one thread per core */
+#define NET_OPT_WORKER_THREADS (1 << 28)
+#define NET_OPT_DEFAULT_WORKER_THREADS 0
+
+/*
+* linux only, requires NET_OPT_USE_REACTOR
+* every reactor worker owns its own listen socket bound with SO_REUSEPORT and accepts as soon as it becomes readable
+*/
+#define NET_OPT_REUSEPORT (1 << 29)
+#define NET_OPT_DEFAULT_REUSEPORT false
+
+/*
+* high-water mark in bytes of the per-peer outbound queue
+* as soon as the queued bytes exceed it OnPeerSendQueueFull gets called
+*/
+#define NET_OPT_SEND_QUEUE_LIMIT (1 << 30)
+#define NET_OPT_DEFAULT_SEND_QUEUE_LIMIT (4 * 1024 * 1024)
+
+/* options are stored in a 64 bit flag, use 1ULL from here on */
+
+/* Server & Client Option */
+
+/*
+* linux only (kernel 6.0+): receive using io_uring (multishot recv into provided buffers)
+* server: requires NET_OPT_USE_REACTOR, every reactor worker owns a ring and accepts using multishot accept
+* client: the receive thread waits on its own ring instead of polling the socket
+*/
+#define NET_OPT_USE_URING (1ULL << 31)
+#define NET_OPT_DEFAULT_USE_URING false
+
+/* Server Option */
+
+/*
+* linux only: frames carrying atleast this amount of raw data are sent using MSG_ZEROCOPY - 0 disables it
+* only raw data that is handed over (free_after_sent) and sent without cipher, compression and TOTP is affected
+*/
+#define NET_OPT_ZEROCOPY_THRESHOLD (1ULL << 32)
+#define NET_OPT_DEFAULT_ZEROCOPY_THRESHOLD 0
+
+/*
+* amount of bytes being read from one peer before the next peer gets its turn - 0 reads until the socket has been drained
+* the peer continues where it stopped on the next iteration
+*/
+#define NET_OPT_RECEIVE_BUDGET (1ULL << 33)
+#define NET_OPT_DEFAULT_RECEIVE_BUDGET (1024 * 1024)
+
+/*
+* linux only: listen on an AF_UNIX stream socket at this path instead of the TCP port
+* meant for processes on the same host, the client connects using ConnectUnix
+*/
+#define NET_OPT_UNIX_PATH (1ULL << 34)
+#define NET_OPT_DEFAULT_UNIX_PATH nullptr
+
+/* Server & Client Option */
+
+/* amount of threads executing packets (NET_OPT_EXECUTE_PACKET_ASYNC) - 0 will use one thread per core, the client always uses one */
+#define NET_OPT_EXECUTE_PACKET_THREADS (1ULL << 35)
+#define NET_OPT_DEFAULT_EXECUTE_PACKET_THREADS 0
+
+/*
+* maximum of packets per peer waiting for their execution (NET_OPT_EXECUTE_PACKET_ASYNC) or decoding (NET_OPT_PIPELINE) - 0 is unlimited
+* as soon as a peer reached it, nothing more is read from it until the workers caught up - the other peers are not affected
+*/
+#define NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT (1ULL << 36)
+#define NET_OPT_DEFAULT_EXECUTE_PACKET_QUEUE_LIMIT 4096
+
+/* Server Option */
+
+/*
+* the receiving thread only delimits the frames, decryption, decompression and parsing are done by a set of pipeline workers
+* frames of the same peer are still being decoded and executed in the order they have been received
+*/
+#define NET_OPT_PIPELINE (1ULL << 37)
+#define NET_OPT_DEFAULT_PIPELINE false
+
+/* amount of pipeline workers - 0 will use one thread per core */
+#define NET_OPT_PIPELINE_THREADS (1ULL << 38)
+#define NET_OPT_DEFAULT_PIPELINE_THREADS 0
+
+/*
+* cores the workers are allowed to run on, e.g. "0-7,16-23" to keep them on the first socket
+* reactor and peer pool workers are pinned to one core each (round robin), packet and pipeline workers share the set
+* memory is placed on the numa node of the core that touches it first, soo the buffers of a worker stay local
+*/
+#define NET_OPT_WORKER_CPUS (1ULL << 39)
+#define NET_OPT_DEFAULT_WORKER_CPUS nullptr
+
+/*
+* packets are queued per priority class (see SetPacketLane), the higher classes are executed and sent first
+* after this amount of packets in a row one packet of the lowest waiting class is served, soo it can not starve - 0 disables it
+*/
+#define NET_OPT_LANE_BURST (1ULL << 40)
+#define NET_OPT_DEFAULT_LANE_BURST 16
+
+/*
+* per peer token buckets, checked as soon as the size of a frame has been read - before anything gets allocated or decrypted
+* bytes and frames per second a peer is allowed to send - 0 is unlimited
+*/
+#define NET_OPT_RATE_LIMIT_BYTES (1ULL << 41)
+#define NET_OPT_DEFAULT_RATE_LIMIT_BYTES 0
+
+#define NET_OPT_RATE_LIMIT_PACKETS (1ULL << 42)
+#define NET_OPT_DEFAULT_RATE_LIMIT_PACKETS 0
+
+/* the buckets hold the tokens of this amount of milliseconds, a peer is allowed to burst up to it */
+#define NET_OPT_RATE_LIMIT_BURST (1ULL << 43)
+#define NET_OPT_DEFAULT_RATE_LIMIT_BURST 1000
+
+/* over-limit behaviour */
+#define NET_RATE_LIMIT_DROP 0 /* the frame is discarded without storing it */
+#define NET_RATE_LIMIT_DELAY 1 /* the frame waits, the socket is not read until the peer got new tokens */
+#define NET_RATE_LIMIT_DISCONNECT 2
+
+#define NET_OPT_RATE_LIMIT_ACTION (1ULL << 44)
+#define NET_OPT_DEFAULT_RATE_LIMIT_ACTION NET_RATE_LIMIT_DELAY
+
+/* biggest frame size a peer is allowed to declare - 0 is unlimited, an oversized frame is dropped or the peer gets disconnected */
+#define NET_OPT_MAX_FRAME_SIZE (1ULL << 45)
+#define NET_OPT_DEFAULT_MAX_FRAME_SIZE 0
+
+/* connections accepted from the same ip address - 0 is unlimited */
+#define NET_OPT_MAX_CONNECTIONS_PER_IP (1ULL << 46)
+#define NET_OPT_DEFAULT_MAX_CONNECTIONS_PER_IP 0
+
+/*
+* offer (client) or accept (server) the binary framing during the version exchange
+* peers that do not know it keep on using the text framing, it is never used together with TOTP
+*/
+#define NET_OPT_BINARY_FRAMING (1ULL << 47)
+#define NET_OPT_DEFAULT_BINARY_FRAMING true
+
+/*
+* binary framing: the packet id is part of the header, a frame of an id without packet definition disconnects the peer before its body has been received
+* opt-in: the packet definitions get asked using a probing packet (PKG.IsProbe()), only enable it if all of them are written using the NET_DEFINE_PACKET macros
+* or if the ones written by hand return true for a probing packet without executing it
+*/
+#define NET_OPT_REJECT_UNKNOWN_PACKETS (1ULL << 48)
+#define NET_OPT_DEFAULT_REJECT_UNKNOWN_PACKETS false
+
+/*
+* write coalescing, the default of new peers - see SetCoalescing
+* queued frames are not written right away, they go out together as soon as the window has passed or the threshold has been reached,
+* or once the executed packet has returned or the peer got visited - Flush writes them right away
+* linux: the writes of one flush are chained using MSG_MORE
+*/
+#define NET_OPT_COALESCE (1ULL << 49)
+#define NET_OPT_DEFAULT_COALESCE false
+
+/* milliseconds a queued frame waits for more frames */
+#define NET_OPT_COALESCE_WINDOW (1ULL << 50)
+#define NET_OPT_DEFAULT_COALESCE_WINDOW 1
+
+/* queued bytes that are written without waiting for the window */
+#define NET_OPT_COALESCE_BYTES (1ULL << 51)
+#define NET_OPT_DEFAULT_COALESCE_BYTES (16 * 1024)
+
 /* DEFAULT OPTION VALUES */
 #define NET_OPT_DEFAULT_MAX_PACKET_SIZE 65535
 #define NET_OPT_DEFAULT_RSA_SIZE 1024
@@ -50,6 +50,9 @@ NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_DataInvalid, "Data of frame is invalid"
 NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_NoMemberID, "Missing member ID in frame");
 NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_MemberIDInvalid, "Member ID is less than zero");
 NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_NoMemberContent, "Missing member Content in frame");
+NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_RateLimit, "Exceeded the rate limit");
+NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_FrameTooBig, "Frame exceeds the maximum frame size");
+NET_DEFINE_ERROR(NET_ERROR_CODE::NET_ERR_StreamAborted, "Stream has been aborted by the handler");
 NET_ERROR_LIST_END
 
 void Net::Codes::NetUnloadErrorCodes()
@@ -93,6 +93,9 @@ namespace Net
 			NET_ERR_NoMemberID,
 			NET_ERR_MemberIDInvalid,
 			NET_ERR_NoMemberContent,
+			NET_ERR_RateLimit,
+			NET_ERR_FrameTooBig,
+			NET_ERR_StreamAborted,
 
 			LAST_NET_ERROR_CODE
 		};
@@ -0,0 +1,334 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+#include <Net/Net/NetCoroutine.h>
+
+#ifdef NET_USE_COROUTINES
+#include <Net/assets/manager/logmanager.h>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace Net
+{
+	namespace Coroutine
+	{
+		/*
+		* process wide, created on first use and never destroyed
+		* suspended coroutines might still reference it while static objects are being torn down
+		*/
+		struct service_t
+		{
+			/* strands for contexts without a running pool and the blocking calls (every call gets its own key) */
+			Net::TaskPool::TaskPool_t resume_pool;
+			Net::TaskPool::TaskPool_t blocking_pool;
+
+			std::mutex timer_mutex;
+			std::condition_variable timer_cv;
+			std::multimap<std::chrono::steady_clock::time_point, std::pair<Context_t, std::coroutine_handle<>>> timers;
+
+			std::mutex inflight_mutex;
+			std::condition_variable inflight_cv;
+			std::unordered_map<void*, size_t> inflight;
+
+			/* WhenFinished, guarded by inflight_mutex */
+			std::unordered_map<void*, std::pair<void (*)(void*), void*>> deferred;
+		};
+
+		static thread_local Context_t current_context = { nullptr, nullptr, nullptr };
+
+		static NET_THREAD(timer_thread)
+		{
+			const auto service = (service_t*)parameter;
+
+			std::unique_lock<std::mutex> lock(service->timer_mutex);
+			for (;;)
+			{
+				if (service->timers.empty())
+				{
+					service->timer_cv.wait(lock);
+					continue;
+				}
+
+				const auto it = service->timers.begin();
+				if (it->first > std::chrono::steady_clock::now())
+				{
+					// a new timer might expire earlier, wake up for it
+					service->timer_cv.wait_until(lock, it->first);
+					continue;
+				}
+
+				const auto entry = it->second;
+				service->timers.erase(it);
+
+				lock.unlock();
+				Resume(entry.first, entry.second);
+				lock.lock();
+			}
+
+			return 0;
+		}
+
+		static service_t* service()
+		{
+			static service_t* instance = nullptr;
+			static std::once_flag once;
+			std::call_once(once, []
+				{
+					instance = new service_t();
+
+					instance->resume_pool.set_thread_attributes(Net::Thread::Attributes_t(CSTRING("net-co")));
+					instance->resume_pool.start();
+
+					instance->blocking_pool.set_num_threads(NET_COROUTINE_BLOCKING_THREADS);
+					instance->blocking_pool.set_thread_attributes(Net::Thread::Attributes_t(CSTRING("net-co-block")));
+					instance->blocking_pool.start();
+
+					Net::Thread::Create(timer_thread, instance, Net::Thread::Attributes_t(CSTRING("net-co-timer")));
+				});
+
+			return instance;
+		}
+
+		static void resume_handle(void* address)
+		{
+			std::coroutine_handle<>::from_address(address).resume();
+		}
+	}
+}
+
+Net::Coroutine::Inbox_t::Inbox_t()
+{
+	active = 0;
+	closed = false;
+}
+
+bool Net::Coroutine::Inbox_t::post(std::coroutine_handle<> handle)
+{
+	const std::lock_guard<std::mutex> lock(mutex);
+	if (closed)
+		return false;
+
+	handles.emplace_back(handle);
+	return true;
+}
+
+void Net::Coroutine::Inbox_t::drain()
+{
+	if (!active)
+		return;
+
+	std::vector<std::coroutine_handle<>> resumable;
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		resumable.swap(handles);
+	}
+
+	for (const auto handle : resumable)
+		handle.resume();
+}
+
+bool Net::Coroutine::Inbox_t::pending() const
+{
+	return active > 0;
+}
+
+void Net::Coroutine::Inbox_t::close(void* key)
+{
+	std::vector<std::coroutine_handle<>> resumable;
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		resumable.swap(handles);
+	}
+
+	for (const auto handle : resumable)
+		Resume({ nullptr, key, nullptr }, handle);
+}
+
+void Net::Coroutine::Inbox_t::started()
+{
+	active++;
+}
+
+void Net::Coroutine::Inbox_t::finished()
+{
+	active--;
+}
+
+Net::Coroutine::Scope_t::Scope_t(Net::TaskPool::TaskPool_t* pool, void* key, Inbox_t* inbox)
+{
+	previous = current_context;
+	current_context.pool = pool;
+	current_context.key = key;
+	current_context.inbox = (pool ? nullptr : inbox);
+}
+
+Net::Coroutine::Scope_t::~Scope_t()
+{
+	current_context = previous;
+}
+
+Net::Coroutine::Packet_t::Packet_t(Net::Packet& other)
+	: packet(other)
+{
+	// the raw data either points into the received frame or belongs to the dispatcher
+	for (auto& entry : packet.GetRawData())
+	{
+		if (!entry.valid() || entry.is_file())
+			continue;
+
+		const auto buffer = ALLOC<byte>(entry.size() + 1);
+		if (!buffer)
+		{
+			entry = Net::RawData_t();
+			continue;
+		}
+
+		memcpy(buffer, entry.value(), entry.size());
+		entry.set_free(false);
+		entry.set(buffer);
+		entry.set_free(true);
+	}
+
+	packet.SetFreeRaw(true);
+}
+
+Net::Coroutine::Packet_t::Packet_t(Packet_t&& other)
+	: packet(other.packet)
+{
+	// the raw data moves along, only this one frees it
+	other.packet.GetRawData().clear();
+}
+
+Net::Packet& Net::Coroutine::Packet_t::get()
+{
+	return packet;
+}
+
+Net::Coroutine::Context_t Net::Coroutine::Current()
+{
+	return current_context;
+}
+
+void Net::Coroutine::Resume(const Context_t& context, std::coroutine_handle<> handle)
+{
+	// posting never blocks and a full key is not checked in here, the timer and the blocking workers are never held up by a peer
+	if (context.pool && context.pool->post(context.key, &resume_handle, handle.address()))
+		return;
+
+	if (context.inbox && context.inbox->post(handle))
+		return;
+
+	if (service()->resume_pool.post(context.key, &resume_handle, handle.address()))
+		return;
+
+	handle.resume();
+}
+
+void Net::Coroutine::Wait(void* key)
+{
+	const auto instance = service();
+	std::unique_lock<std::mutex> lock(instance->inflight_mutex);
+	instance->inflight_cv.wait(lock, [instance, key] { return instance->inflight.find(key) == instance->inflight.end(); });
+}
+
+void Net::Coroutine::Started(void* key)
+{
+	const auto instance = service();
+	const std::lock_guard<std::mutex> lock(instance->inflight_mutex);
+	instance->inflight[key]++;
+}
+
+void Net::Coroutine::WhenFinished(void* key, void (*fnc)(void* param), void* param)
+{
+	const auto instance = service();
+	{
+		const std::lock_guard<std::mutex> lock(instance->inflight_mutex);
+		if (instance->inflight.find(key) != instance->inflight.end())
+		{
+			instance->deferred[key] = std::make_pair(fnc, param);
+			return;
+		}
+	}
+
+	fnc(param);
+}
+
+void Net::Coroutine::Finished(void* key)
+{
+	const auto instance = service();
+	std::pair<void (*)(void*), void*> deferred = { nullptr, nullptr };
+	{
+		const std::lock_guard<std::mutex> lock(instance->inflight_mutex);
+
+		const auto it = instance->inflight.find(key);
+		if (it == instance->inflight.end())
+			return;
+
+		if (--it->second != 0)
+			return;
+
+		instance->inflight.erase(it);
+		instance->inflight_cv.notify_all();
+
+		const auto entry = instance->deferred.find(key);
+		if (entry != instance->deferred.end())
+		{
+			deferred = entry->second;
+			instance->deferred.erase(entry);
+		}
+	}
+
+	// outside of the lock, it might create coroutines on its own
+	if (deferred.first)
+		deferred.first(deferred.second);
+}
+
+void Net::Coroutine::Offload(void (*fnc)(void* param), void* param)
+{
+	// the awaiter is unique while it is suspended, soo the calls run in parallel
+	if (!service()->blocking_pool.post(param, fnc, param))
+		fnc(param);
+}
+
+void Net::Coroutine::Schedule(const DWORD ms, const Context_t& context, std::coroutine_handle<> handle)
+{
+	const auto instance = service();
+	{
+		const std::lock_guard<std::mutex> lock(instance->timer_mutex);
+		instance->timers.emplace(std::chrono::steady_clock::now() + std::chrono::milliseconds(ms), std::make_pair(context, handle));
+	}
+
+	instance->timer_cv.notify_one();
+}
+
+void Net::Coroutine::Task_t::promise_type::unhandled_exception()
+{
+	// there is nobody to rethrow it to
+	NET_LOG_ERROR(CSTRING("[Net::Coroutine] - packet handler terminated by an exception"));
+}
+#endif
@@ -0,0 +1,252 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+#pragma once
+
+/*
+* opt-in (NET_USE_COROUTINES, requires C++20): packet handlers declared using NET_DECLARE_PACKET_CO are coroutines
+* they co_await timers (Sleep) and blocking calls (Async, e.g. MYSQL::query or HTTPS::Get) without blocking the worker that dispatched them
+* a suspended handler is resumed on the strand of its peer, soo it never runs concurrently with the other packets of that peer
+* the handler owns a copy of its packet (Packet_t), it stays valid across every co_await
+*/
+#define NET_COROUTINE_BLOCKING_THREADS 16
+
+#include <Net/Net/Net.h>
+#include <Net/Net/NetPacket.h>
+#include <Net/Net/NetTaskPool.h>
+
+#ifdef NET_USE_COROUTINES
+#if !defined(__cpp_impl_coroutine) && !defined(__cpp_lib_coroutine)
+#error "NET_USE_COROUTINES requires C++20"
+#endif
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace Net
+{
+	namespace Coroutine
+	{
+		/*
+		* resumes waiting for the thread that executes the packets of the key inline, e.g. the receiving worker of a peer
+		* the owner drains it between the packets, soo a resumed handler never runs concurrently with them
+		*/
+		class Inbox_t
+		{
+			std::mutex mutex;
+			std::vector<std::coroutine_handle<>> handles;
+			std::atomic<size_t> active;
+			bool closed;
+
+		public:
+			Inbox_t();
+
+			/* returns false if the owner is gone */
+			bool post(std::coroutine_handle<> handle);
+
+			/* owner: resumes everything that has been posted */
+			void drain();
+
+			/* owner: coroutines of this inbox that have not finished yet, the owner has to keep on draining */
+			bool pending() const;
+
+			/* owner: it stops draining, the coroutines continue on the coroutine workers from now on */
+			void close(void* key);
+
+			void started();
+			void finished();
+		};
+
+		/*
+		* the packet of a handler, it lives inside of the coroutine frame until the handler has finished
+		* the dispatcher releases its own packet as soon as the handler suspends, soo the json and the raw data are copied
+		*/
+		class Packet_t
+		{
+			Net::Packet packet;
+
+		public:
+			Packet_t(Net::Packet& packet);
+			Packet_t(Packet_t&& other);
+			~Packet_t() = default;
+
+			Packet_t(const Packet_t&) = delete;
+			Packet_t& operator=(const Packet_t&) = delete;
+
+			Net::Packet& get();
+		};
+
+		/* where a suspended coroutine continues: the strand (key) of a task pool or the inbox of its owner */
+		struct Context_t
+		{
+			Net::TaskPool::TaskPool_t* pool;
+			void* key;
+			Inbox_t* inbox;
+		};
+
+		/* the dispatcher sets the context handlers are being created with for the time it executes a packet, the pool is preferred if it is running */
+		class Scope_t
+		{
+			Context_t previous;
+
+		public:
+			Scope_t(Net::TaskPool::TaskPool_t* pool, void* key, Inbox_t* inbox = nullptr);
+			~Scope_t();
+		};
+
+		Context_t Current();
+
+		/* continues the coroutine on the strand of its context, falls back to the coroutine workers if the pool is not running */
+		void Resume(const Context_t& context, std::coroutine_handle<> handle);
+
+		/* blocks until every coroutine that has been created with this key has finished, never call it from one of them */
+		void Wait(void* key);
+
+		/* calls fnc as soon as every coroutine that has been created with this key has finished - right away if there is none, otherwise on the thread finishing the last one */
+		void WhenFinished(void* key, void (*fnc)(void* param), void* param);
+
+		void Started(void* key);
+		void Finished(void* key);
+
+		/* executes a blocking call on the blocking workers */
+		void Offload(void (*fnc)(void* param), void* param);
+
+		/* resumes the coroutine after the amount of milliseconds, one timer thread serves all of them */
+		void Schedule(DWORD ms, const Context_t& context, std::coroutine_handle<> handle);
+
+		/* fire and forget, the frame destroys itself as soon as the handler has finished */
+		class Task_t
+		{
+		public:
+			struct promise_type
+			{
+				Context_t context;
+
+				promise_type()
+				{
+					context = Current();
+					if (context.inbox) context.inbox->started();
+					Started(context.key);
+				}
+
+				~promise_type()
+				{
+					if (context.inbox) context.inbox->finished();
+					Finished(context.key);
+				}
+
+				Task_t get_return_object() { return {}; }
+				std::suspend_never initial_suspend() noexcept { return {}; }
+				std::suspend_never final_suspend() noexcept { return {}; }
+				void return_void() {}
+				void unhandled_exception();
+			};
+		};
+
+		/* co_await Net::Coroutine::Sleep(ms); */
+		class Sleep
+		{
+			DWORD ms;
+
+		public:
+			explicit Sleep(DWORD ms) : ms(ms) {}
+
+			bool await_ready() const noexcept { return ms == 0; }
+			void await_suspend(std::coroutine_handle<Task_t::promise_type> handle) { Schedule(ms, handle.promise().context, handle); }
+			void await_resume() const noexcept {}
+		};
+
+		/* auto result = co_await Net::Coroutine::Async([&] { return query(); }); */
+		template <typename T>
+		class Async_t
+		{
+			std::function<T()> fnc;
+			std::optional<T> result;
+			Context_t context;
+			std::coroutine_handle<> handle;
+
+			static void run(void* param)
+			{
+				// the awaiter lives inside of the suspended frame until it has been resumed
+				auto self = (Async_t*)param;
+				self->result.emplace(self->fnc());
+				Resume(self->context, self->handle);
+			}
+
+		public:
+			explicit Async_t(std::function<T()> fnc) : fnc(std::move(fnc)), context() {}
+
+			bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<Task_t::promise_type> handle)
+			{
+				this->context = handle.promise().context;
+				this->handle = handle;
+				Offload(&run, this);
+			}
+
+			T await_resume() { return std::move(*result); }
+		};
+
+		template <>
+		class Async_t<void>
+		{
+			std::function<void()> fnc;
+			Context_t context;
+			std::coroutine_handle<> handle;
+
+			static void run(void* param)
+			{
+				auto self = (Async_t*)param;
+				self->fnc();
+				Resume(self->context, self->handle);
+			}
+
+		public:
+			explicit Async_t(std::function<void()> fnc) : fnc(std::move(fnc)), context() {}
+
+			bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<Task_t::promise_type> handle)
+			{
+				this->context = handle.promise().context;
+				this->handle = handle;
+				Offload(&run, this);
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+		template <typename F>
+		Async_t<decltype(std::declval<F>()())> Async(F&& fnc)
+		{
+			return Async_t<decltype(std::declval<F>()())>(std::forward<F>(fnc));
+		}
+	}
+}
+#endif
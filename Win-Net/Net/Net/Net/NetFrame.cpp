@@ -0,0 +1,416 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <Net/Net/NetFrame.h>
+
+#ifdef BUILD_LINUX
+#include <sys/sendfile.h>
+#endif
+
+Net::Frame::Shared_t::Shared_t(byte* data, const size_t size)
+{
+	_data = data;
+	_size = size;
+	_refs = 1;
+}
+
+Net::Frame::Shared_t::~Shared_t()
+{
+	FREE<byte>(_data);
+}
+
+Net::Frame::Shared_t* Net::Frame::Shared_t::create(byte* data, const size_t size)
+{
+	if (!data)
+		return nullptr;
+
+	return new Shared_t(data, size);
+}
+
+void Net::Frame::Shared_t::acquire()
+{
+	_refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Net::Frame::Shared_t::release()
+{
+	// the last frame is done with it, every other write happened before its release
+	if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this;
+}
+
+byte* Net::Frame::Shared_t::data() const
+{
+	return _data;
+}
+
+size_t Net::Frame::Shared_t::size() const
+{
+	return _size;
+}
+
+Net::Frame::Frame_t::Frame_t()
+{
+	_inline = nullptr;
+	_inline_size = 0;
+	_inline_capacity = 0;
+	_size = 0;
+	_has_file = false;
+	_zerocopy = false;
+	_sent = 0;
+	_sent_segment = 0;
+	_sent_segment_offset = 0;
+}
+
+Net::Frame::Frame_t::~Frame_t()
+{
+	free();
+}
+
+byte* Net::Frame::Frame_t::segment_data(const segment_t& segment) const
+{
+	return segment.data ? segment.data : _inline + segment.offset;
+}
+
+bool Net::Frame::Frame_t::reserve(const size_t capacity)
+{
+	if (capacity <= _inline_capacity)
+		return true;
+
+	auto data = ALLOC<byte>(capacity);
+	if (!data)
+		return false;
+
+	// segments only store offsets into the inline buffer, soo it is safe to move it
+	if (_inline)
+	{
+		memcpy(data, _inline, _inline_size);
+		FREE<byte>(_inline);
+	}
+
+	_inline = data;
+	_inline_capacity = capacity;
+	return true;
+}
+
+void Net::Frame::Frame_t::append(const char* data, const size_t size)
+{
+	append(reinterpret_cast<const byte*>(data), size);
+}
+
+void Net::Frame::Frame_t::append(const byte* data, const size_t size)
+{
+	if (!data || size == 0)
+		return;
+
+	if (_inline_size + size > _inline_capacity)
+	{
+		if (!reserve(std::max(_inline_size + size, _inline_capacity * 2)))
+			return;
+	}
+
+	memcpy(_inline + _inline_size, data, size);
+
+	// extend the previous segment if it is the tail of the inline buffer
+	if (!_segments.empty() && !_segments.back().data && _segments.back().fd == SOCKET_ERROR && _segments.back().offset + _segments.back().size == _inline_size)
+	{
+		_segments.back().size += size;
+	}
+	else
+	{
+		segment_t segment = {};
+		segment.data = nullptr;
+		segment.offset = _inline_size;
+		segment.size = size;
+		segment.owned = false;
+		segment.fd = SOCKET_ERROR;
+		segment.shared = nullptr;
+		_segments.emplace_back(segment);
+	}
+
+	_inline_size += size;
+	_size += size;
+}
+
+void Net::Frame::Frame_t::append(const std::string& data)
+{
+	append(data.data(), data.length());
+}
+
+void Net::Frame::Frame_t::attach(byte* data, const size_t size)
+{
+	if (!data)
+		return;
+
+	if (size == 0)
+	{
+		FREE<byte>(data);
+		return;
+	}
+
+	segment_t segment = {};
+	segment.data = data;
+	segment.offset = 0;
+	segment.size = size;
+	segment.owned = true;
+	segment.fd = SOCKET_ERROR;
+	segment.shared = nullptr;
+	_segments.emplace_back(segment);
+
+	_size += size;
+}
+
+void Net::Frame::Frame_t::share(Shared_t* shared)
+{
+	if (!shared || shared->size() == 0)
+		return;
+
+	shared->acquire();
+
+	segment_t segment = {};
+	segment.data = shared->data();
+	segment.offset = 0;
+	segment.size = shared->size();
+	segment.owned = false;
+	segment.fd = SOCKET_ERROR;
+	segment.shared = shared;
+	_segments.emplace_back(segment);
+
+	_size += shared->size();
+}
+
+byte* Net::Frame::Frame_t::flatten() const
+{
+	if (_has_file)
+		return nullptr;
+
+	auto data = ALLOC<byte>(_size + 1);
+	if (!data)
+		return nullptr;
+
+	size_t offset = 0;
+	for (const auto& segment : _segments)
+	{
+		memcpy(data + offset, segment_data(segment), segment.size);
+		offset += segment.size;
+	}
+
+	return data;
+}
+
+#ifdef BUILD_LINUX
+void Net::Frame::Frame_t::attach_file(const int fd, const size_t offset, const size_t size, const bool owned)
+{
+	if (fd == SOCKET_ERROR)
+		return;
+
+	if (size == 0)
+	{
+		if (owned) close(fd);
+		return;
+	}
+
+	segment_t segment = {};
+	segment.data = nullptr;
+	segment.offset = offset;
+	segment.size = size;
+	segment.owned = owned;
+	segment.fd = fd;
+	segment.shared = nullptr;
+	_segments.emplace_back(segment);
+
+	_size += size;
+	_has_file = true;
+}
+
+bool Net::Frame::Frame_t::at_file() const
+{
+	return _sent_segment < _segments.size() && _segments[_sent_segment].fd != SOCKET_ERROR;
+}
+
+int64 Net::Frame::Frame_t::send_file(const SOCKET fd) const
+{
+	/* peer sockets are non-blocking, a full socket buffer is reported as EWOULDBLOCK */
+	const auto& segment = _segments[_sent_segment];
+	off_t offset = static_cast<off_t>(segment.offset + _sent_segment_offset);
+	return ::sendfile(fd, segment.fd, &offset, segment.size - _sent_segment_offset);
+}
+#endif
+
+bool Net::Frame::Frame_t::has_file() const
+{
+	return _has_file;
+}
+
+void Net::Frame::Frame_t::set_zerocopy(const bool zerocopy)
+{
+	_zerocopy = zerocopy;
+}
+
+bool Net::Frame::Frame_t::zerocopy() const
+{
+	return _zerocopy;
+}
+
+void Net::Frame::Frame_t::mask(const uint32_t token)
+{
+	for (size_t it = 0; it < _inline_size; ++it)
+		_inline[it] = _inline[it] ^ token;
+
+	for (auto& segment : _segments)
+	{
+		if (!segment.data) continue;
+
+		// the other peers still send the unmasked bytes
+		if (segment.shared)
+		{
+			auto data = ALLOC<byte>(segment.size);
+			memcpy(data, segment.data, segment.size);
+
+			segment.shared->release();
+			segment.shared = nullptr;
+			segment.data = data;
+			segment.owned = true;
+		}
+
+		for (size_t it = 0; it < segment.size; ++it)
+			segment.data[it] = segment.data[it] ^ token;
+	}
+}
+
+size_t Net::Frame::Frame_t::size() const
+{
+	return _size;
+}
+
+size_t Net::Frame::Frame_t::remaining() const
+{
+	return _size - _sent;
+}
+
+bool Net::Frame::Frame_t::done() const
+{
+	return _sent >= _size;
+}
+
+size_t Net::Frame::Frame_t::fill(NET_IOVEC* vec, const size_t max) const
+{
+	size_t count = 0;
+	for (size_t i = _sent_segment; i < _segments.size() && count < max; ++i)
+	{
+		const auto& segment = _segments[i];
+		if (segment.fd != SOCKET_ERROR)
+			break;
+
+		const size_t offset = (i == _sent_segment) ? _sent_segment_offset : 0;
+
+#ifdef BUILD_LINUX
+		vec[count].iov_base = segment_data(segment) + offset;
+		vec[count].iov_len = segment.size - offset;
+#else
+		vec[count].buf = reinterpret_cast<char*>(segment_data(segment) + offset);
+		vec[count].len = static_cast<ULONG>(segment.size - offset);
+#endif
+		count++;
+	}
+
+	return count;
+}
+
+size_t Net::Frame::Frame_t::consume(size_t size)
+{
+	while (size > 0 && _sent_segment < _segments.size())
+	{
+		const auto left = _segments[_sent_segment].size - _sent_segment_offset;
+		if (size < left)
+		{
+			// partial write inside of this segment
+			_sent_segment_offset += size;
+			_sent += size;
+			return 0;
+		}
+
+		size -= left;
+		_sent += left;
+		_sent_segment++;
+		_sent_segment_offset = 0;
+	}
+
+	return size;
+}
+
+void Net::Frame::Frame_t::free()
+{
+	for (const auto& segment : _segments)
+	{
+		if (segment.shared)
+		{
+			segment.shared->release();
+			continue;
+		}
+
+		if (!segment.owned) continue;
+
+#ifdef BUILD_LINUX
+		if (segment.fd != SOCKET_ERROR)
+		{
+			close(segment.fd);
+			continue;
+		}
+#endif
+
+		FREE<byte>(segment.data);
+	}
+
+	_segments.clear();
+
+	FREE<byte>(_inline);
+	_inline = nullptr;
+	_inline_size = 0;
+	_inline_capacity = 0;
+
+	_size = 0;
+	_has_file = false;
+	_zerocopy = false;
+	_sent = 0;
+	_sent_segment = 0;
+	_sent_segment_offset = 0;
+}
+
+int64 Net::Frame::send(const SOCKET fd, NET_IOVEC* vec, const size_t count, const int flags)
+{
+#ifdef BUILD_LINUX
+	msghdr msg = {};
+	msg.msg_iov = vec;
+	msg.msg_iovlen = count;
+	return Ws2_32::sendmsg(fd, &msg, flags);
+#else
+	DWORD sent = 0;
+	if (Ws2_32::WSASend(fd, vec, static_cast<DWORD>(count), &sent, static_cast<DWORD>(flags), nullptr, nullptr) == SOCKET_ERROR)
+		return SOCKET_ERROR;
+
+	return static_cast<int64>(sent);
+#endif
+}
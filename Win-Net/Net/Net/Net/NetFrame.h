@@ -0,0 +1,166 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#pragma once
+
+/* amount of buffers being handed to one sendmsg/WSASend call */
+#define NET_FRAME_MAX_IOVEC 64
+
+#include <Net/Net/Net.h>
+
+#ifdef BUILD_LINUX
+#include <sys/uio.h>
+typedef struct iovec NET_IOVEC;
+#else
+typedef WSABUF NET_IOVEC;
+#endif
+
+#include <atomic>
+
+namespace Net
+{
+	namespace Frame
+	{
+		/*
+		* immutable encoded bytes shared by the frames of many peers (broadcasts)
+		* every frame holds one reference, the buffer is freed together with the last one
+		*/
+		class Shared_t
+		{
+			byte* _data;
+			size_t _size;
+			std::atomic<size_t> _refs;
+
+			Shared_t(byte*, size_t);
+			~Shared_t();
+
+		public:
+			/* takes over the ownership of the buffer, the caller holds the first reference */
+			static Shared_t* create(byte*, size_t);
+
+			void acquire();
+			void release();
+
+			byte* data() const;
+			size_t size() const;
+		};
+	}
+}
+
+NET_DSA_BEGIN
+namespace Net
+{
+	namespace Frame
+	{
+		/*
+		* one encoded frame described as a list of segments
+		* small pieces (tags, sizes) are copied into an internal buffer,
+		* big buffers (data, raw data, keys) are attached without copying them
+		* the whole frame is then written using a single scatter-gather call
+		*/
+		class Frame_t
+		{
+			struct segment_t
+			{
+				byte* data; /* nullptr => located inside of _inline at offset */
+				size_t offset;
+				size_t size;
+				bool owned;
+				int fd; /* file segment, offset is the position inside of the file */
+				Shared_t* shared; /* shared segment, data points into it */
+			};
+
+			std::vector<segment_t> _segments;
+
+			byte* _inline;
+			size_t _inline_size;
+			size_t _inline_capacity;
+
+			size_t _size;
+			bool _has_file;
+			bool _zerocopy;
+
+			/* send progress */
+			size_t _sent;
+			size_t _sent_segment;
+			size_t _sent_segment_offset;
+
+			byte* segment_data(const segment_t&) const;
+
+		public:
+			Frame_t();
+			~Frame_t();
+
+			bool reserve(size_t);
+
+			/* copy */
+			void append(const char*, size_t);
+			void append(const byte*, size_t);
+			void append(const std::string&);
+
+			/* take over the ownership of the buffer, it will be freed together with the frame */
+			void attach(byte*, size_t);
+
+			/* reference the shared bytes without copying them, masking takes a private copy first */
+			void share(Shared_t*);
+
+			/* copy of all bytes that are not located inside of a file, nullptr if the frame has file segments */
+			byte* flatten() const;
+
+#ifdef BUILD_LINUX
+			/* linux only: the segment is sent using sendfile, owned descriptors are closed together with the frame */
+			void attach_file(int fd, size_t offset, size_t size, bool owned);
+
+			/* the next unsent segment is a file, it has to be sent using send_file instead of fill */
+			bool at_file() const;
+			int64 send_file(SOCKET) const;
+#endif
+			bool has_file() const;
+
+			/* MSG_ZEROCOPY: the frame has to stay alive until the kernel reports the completion */
+			void set_zerocopy(bool);
+			bool zerocopy() const;
+
+			/* TOTP: mask every byte using the send token, file segments are not touched, shared segments are copied */
+			void mask(uint32_t);
+
+			size_t size() const;
+			size_t remaining() const;
+			bool done() const;
+
+			/* describe the unsent part of the frame up to the next file segment, returns the amount of used entries */
+			size_t fill(NET_IOVEC*, size_t max) const;
+
+			/* mark bytes as sent, returns the amount of bytes exceeding this frame */
+			size_t consume(size_t);
+
+			void free();
+		};
+
+		/* write the buffers using one syscall, returns the amount of bytes being sent or SOCKET_ERROR */
+		int64 send(SOCKET, NET_IOVEC*, size_t count, int flags);
+	}
+}
+NET_DSA_END
@@ -0,0 +1,625 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <Net/Net/NetFraming.h>
+
+static void write_u16(byte* out, const uint16_t value)
+{
+	out[0] = static_cast<byte>(value);
+	out[1] = static_cast<byte>(value >> 8);
+}
+
+static void write_u32(byte* out, const uint32_t value)
+{
+	for (size_t i = 0; i < 4; ++i)
+		out[i] = static_cast<byte>(value >> (i * 8));
+}
+
+static void write_u64(byte* out, const uint64_t value)
+{
+	for (size_t i = 0; i < 8; ++i)
+		out[i] = static_cast<byte>(value >> (i * 8));
+}
+
+static uint16_t read_u16(const byte* in)
+{
+	return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+static uint32_t read_u32(const byte* in)
+{
+	uint32_t value = 0;
+	for (size_t i = 0; i < 4; ++i)
+		value |= static_cast<uint32_t>(in[i]) << (i * 8);
+
+	return value;
+}
+
+static uint64_t read_u64(const byte* in)
+{
+	uint64_t value = 0;
+	for (size_t i = 0; i < 8; ++i)
+		value |= static_cast<uint64_t>(in[i]) << (i * 8);
+
+	return value;
+}
+
+bool Net::Framing::is_binary(const byte* data, const size_t size)
+{
+	if (size < NET_FRAMING_V2_MAGIC_LEN)
+		return false;
+
+	return !memcmp(data, NET_FRAMING_V2_MAGIC, NET_FRAMING_V2_MAGIC_LEN);
+}
+
+/* text framing: a tag at the offset, the offset moves behind it */
+static bool read_tag(const byte* data, const size_t size, size_t& offset, const char* tag, const size_t len)
+{
+	if (len > size - offset || memcmp(&data[offset], tag, len) != 0)
+		return false;
+
+	offset += len;
+	return true;
+}
+
+/* text framing: {<decimal>} read in place */
+static bool read_number(const byte* data, const size_t size, size_t& offset, size_t& value)
+{
+	if (offset >= size || data[offset] != '{')
+		return false;
+
+	uint64_t number = 0;
+	size_t digits = 0;
+	for (++offset; offset < size && data[offset] >= '0' && data[offset] <= '9'; ++offset)
+	{
+		// 19 digits always fit
+		if (++digits > 19)
+			return false;
+
+		number = number * 10 + (data[offset] - '0');
+	}
+
+	if (!digits || offset >= size || data[offset] != '}')
+		return false;
+
+	if (number > static_cast<uint64_t>(INVALID_SIZE))
+		return false;
+
+	++offset;
+	value = static_cast<size_t>(number);
+	return true;
+}
+
+size_t Net::Framing::frame_size(const byte* data)
+{
+	const auto size = read_u64(&data[16]);
+
+	// can not be addressed anyway
+	if (size > static_cast<uint64_t>(INVALID_SIZE))
+		return INVALID_SIZE;
+
+	return static_cast<size_t>(size);
+}
+
+int Net::Framing::frame_id(const byte* data)
+{
+	const auto id = read_u32(&data[8]);
+	if (id > static_cast<uint32_t>(INT32_MAX))
+		return -1;
+
+	return static_cast<int>(id);
+}
+
+uint16_t Net::Framing::frame_flags(const byte* data)
+{
+	return read_u16(&data[4]);
+}
+
+size_t Net::Framing::table_size(const byte* data)
+{
+	return NET_FRAMING_V2_HEADER_LEN + static_cast<size_t>(read_u16(&data[6])) * NET_FRAMING_V2_SECTION_LEN;
+}
+
+Net::Framing::View_t::View_t()
+{
+	_data = nullptr;
+	_size = 0;
+	_sections = 0;
+	_next = 0;
+	_payload = 0;
+	_original_size = 0;
+	_id = -1;
+	_flags = 0;
+	_text = false;
+}
+
+void Net::Framing::View_t::read(const size_t index, section_t& section) const
+{
+	const auto entry = &_data[NET_FRAMING_V2_HEADER_LEN + index * NET_FRAMING_V2_SECTION_LEN];
+	section.type = static_cast<Section_t>(entry[0]);
+	section.key = nullptr;
+	section.key_size = read_u32(&entry[4]);
+	section.data = nullptr;
+	section.size = static_cast<size_t>(read_u64(&entry[8]));
+	section.original_size = static_cast<size_t>(read_u64(&entry[16]));
+}
+
+/*
+* text framing: one section starting at the offset, the offset moves behind it
+* returns 1 for a section, 0 at the footer and -1 if the frame is malformed
+*/
+int Net::Framing::View_t::read_text(size_t& offset, section_t& section) const
+{
+	section.key = nullptr;
+	section.key_size = 0;
+
+	if (read_tag(_data, _size, offset, NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN))
+		return offset == _size ? 0 : -1;
+
+	if (read_tag(_data, _size, offset, NET_AES_KEY, NET_AES_KEY_LEN))
+	{
+		section.type = Section_t::AES_KEY;
+	}
+	else if (read_tag(_data, _size, offset, NET_AES_IV, NET_AES_IV_LEN))
+	{
+		section.type = Section_t::AES_IV;
+	}
+	else if (read_tag(_data, _size, offset, NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN))
+	{
+		section.type = Section_t::RAW_DATA;
+
+		// the key is stored including its terminator, the same limit as the one of Net::RawData_t applies
+		size_t key_size = 0;
+		if (!read_number(_data, _size, offset, key_size)
+			|| key_size == 0 || key_size > 256 || key_size > _size - offset
+			|| _data[offset + key_size - 1] != '\0')
+			return -1;
+
+		section.key = reinterpret_cast<const char*>(&_data[offset]);
+		section.key_size = key_size;
+		offset += key_size;
+
+		size_t original_size = INVALID_SIZE;
+		if (read_tag(_data, _size, offset, NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN)
+			&& !read_number(_data, _size, offset, original_size))
+			return -1;
+
+		size_t size = 0;
+		if (!read_tag(_data, _size, offset, NET_RAW_DATA, NET_RAW_DATA_LEN)
+			|| !read_number(_data, _size, offset, size)
+			|| size > _size - offset)
+			return -1;
+
+		section.data = &_data[offset];
+		section.size = size;
+		section.original_size = (original_size == INVALID_SIZE ? size : original_size);
+		offset += size;
+		return 1;
+	}
+	else if (read_tag(_data, _size, offset, NET_DATA, NET_DATA_LEN))
+	{
+		section.type = Section_t::DATA;
+	}
+	else
+	{
+		return -1;
+	}
+
+	size_t size = 0;
+	if (!read_number(_data, _size, offset, size)
+		|| size > _size - offset)
+		return -1;
+
+	section.data = &_data[offset];
+	section.size = size;
+	section.original_size = (section.type == Section_t::DATA && (_flags & NET_FRAMING_V2_FLAG_COMPRESSION)) ? _original_size : size;
+	offset += size;
+	return 1;
+}
+
+bool Net::Framing::View_t::parse(byte* data, const size_t size)
+{
+	_data = nullptr;
+	_next = 0;
+	_original_size = 0;
+	_id = -1;
+	_flags = 0;
+	_text = !is_binary(data, size);
+
+	if (_text)
+		return parse_text(data, size);
+
+	return parse_binary(data, size);
+}
+
+/* {BP}{PS}{<size>}[{POS}{<size>}] followed by the sections and {EP} */
+bool Net::Framing::View_t::parse_text(byte* data, const size_t size)
+{
+	_data = data;
+	_size = size;
+	_sections = 0;
+
+	size_t offset = 0;
+	size_t frame_size = 0;
+	if (!read_tag(data, size, offset, NET_PACKET_HEADER, NET_PACKET_HEADER_LEN)
+		|| !read_tag(data, size, offset, NET_PACKET_SIZE, NET_PACKET_SIZE_LEN)
+		|| !read_number(data, size, offset, frame_size)
+		|| frame_size != size)
+	{
+		_data = nullptr;
+		return false;
+	}
+
+	if (read_tag(data, size, offset, NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN))
+	{
+		size_t original_size = 0;
+		if (!read_number(data, size, offset, original_size))
+		{
+			_data = nullptr;
+			return false;
+		}
+
+		_original_size = original_size;
+		_flags |= NET_FRAMING_V2_FLAG_COMPRESSION;
+	}
+
+	_payload = offset;
+
+	section_t section;
+	for (;;)
+	{
+		const auto res = read_text(offset, section);
+		if (res == 0)
+			break;
+
+		if (res < 0)
+		{
+			_data = nullptr;
+			return false;
+		}
+
+		if (section.type == Section_t::AES_KEY)
+			_flags |= NET_FRAMING_V2_FLAG_CIPHER;
+
+		++_sections;
+	}
+
+	return true;
+}
+
+bool Net::Framing::View_t::parse_binary(byte* data, const size_t size)
+{
+	if (size < NET_FRAMING_V2_HEADER_LEN)
+		return false;
+
+	if (frame_size(data) != size)
+		return false;
+
+	_data = data;
+	_size = size;
+	_flags = frame_flags(data);
+	_sections = read_u16(&data[6]);
+	_id = frame_id(data);
+	_payload = NET_FRAMING_V2_HEADER_LEN + _sections * NET_FRAMING_V2_SECTION_LEN;
+
+	if (_payload > size)
+	{
+		_data = nullptr;
+		return false;
+	}
+
+	// every section has to fit, the payloads have to fill up the frame exactly
+	auto offset = _payload;
+	for (size_t i = 0; i < _sections; ++i)
+	{
+		section_t section;
+		read(i, section);
+
+		if (section.type < Section_t::AES_KEY || section.type > Section_t::DATA)
+		{
+			_data = nullptr;
+			return false;
+		}
+
+		if (section.type == Section_t::RAW_DATA)
+		{
+			// the key is stored including its terminator, the same limit as the one of Net::RawData_t applies
+			if (section.key_size == 0 || section.key_size > 256 || section.key_size > size - offset
+				|| data[offset + section.key_size - 1] != '\0')
+			{
+				_data = nullptr;
+				return false;
+			}
+		}
+		else if (section.key_size != 0)
+		{
+			_data = nullptr;
+			return false;
+		}
+
+		offset += section.key_size;
+
+		if (section.size > size - offset)
+		{
+			_data = nullptr;
+			return false;
+		}
+
+		offset += section.size;
+	}
+
+	if (offset != size)
+	{
+		_data = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+int Net::Framing::View_t::id() const
+{
+	return _id;
+}
+
+uint16_t Net::Framing::View_t::flags() const
+{
+	return _flags;
+}
+
+bool Net::Framing::View_t::next(section_t& section)
+{
+	if (!_data || _next >= _sections)
+		return false;
+
+	// the frame has been validated, there is no malformed section left
+	if (_text)
+	{
+		++_next;
+		return read_text(_payload, section) > 0;
+	}
+
+	read(_next++, section);
+
+	if (section.key_size)
+	{
+		section.key = reinterpret_cast<const char*>(&_data[_payload]);
+		_payload += section.key_size;
+	}
+
+	section.data = &_data[_payload];
+	_payload += section.size;
+	return true;
+}
+
+Net::Framing::Reader_t::Reader_t()
+{
+	_table = nullptr;
+	_sections = 0;
+	_index = 0;
+	_key_read = 0;
+	_data_read = 0;
+	_key[0] = '\0';
+	_section = {};
+}
+
+Net::Framing::Reader_t::~Reader_t()
+{
+	end();
+}
+
+bool Net::Framing::Reader_t::begin(const byte* data)
+{
+	end();
+
+	const auto size = frame_size(data);
+	const auto sections = static_cast<size_t>(read_u16(&data[6]));
+	const auto header = table_size(data);
+	if (size == INVALID_SIZE || header > size)
+		return false;
+
+	// the payloads have to fill up the frame exactly, the keys are checked once they have been read
+	auto remaining = size - header;
+	for (size_t i = 0; i < sections; ++i)
+	{
+		const auto entry = &data[NET_FRAMING_V2_HEADER_LEN + i * NET_FRAMING_V2_SECTION_LEN];
+		const auto type = static_cast<Section_t>(entry[0]);
+		const size_t key_size = read_u32(&entry[4]);
+		const auto section_size = read_u64(&entry[8]);
+
+		if (type < Section_t::AES_KEY || type > Section_t::DATA)
+			return false;
+
+		if (type == Section_t::RAW_DATA ? (key_size == 0 || key_size > sizeof(_key)) : key_size != 0)
+			return false;
+
+		if (key_size > remaining || section_size > static_cast<uint64_t>(remaining - key_size))
+			return false;
+
+		remaining -= key_size + static_cast<size_t>(section_size);
+	}
+
+	if (remaining != 0)
+		return false;
+
+	const auto table = sections * NET_FRAMING_V2_SECTION_LEN;
+	_table = ALLOC<byte>(table + 1);
+	if (!_table)
+		return false;
+
+	memcpy(_table, &data[NET_FRAMING_V2_HEADER_LEN], table);
+	_sections = sections;
+	enter(0);
+	return true;
+}
+
+void Net::Framing::Reader_t::end()
+{
+	FREE<byte>(_table);
+	_table = nullptr;
+	_sections = 0;
+	_index = 0;
+	_key_read = 0;
+	_data_read = 0;
+}
+
+void Net::Framing::Reader_t::enter(const size_t index)
+{
+	_index = index;
+	_key_read = 0;
+	_data_read = 0;
+
+	if (_index >= _sections)
+		return;
+
+	const auto entry = &_table[_index * NET_FRAMING_V2_SECTION_LEN];
+	_section.type = static_cast<Section_t>(entry[0]);
+	_section.key = nullptr;
+	_section.key_size = read_u32(&entry[4]);
+	_section.data = nullptr;
+	_section.size = static_cast<size_t>(read_u64(&entry[8]));
+	_section.original_size = static_cast<size_t>(read_u64(&entry[16]));
+}
+
+bool Net::Framing::Reader_t::active() const
+{
+	return _table != nullptr;
+}
+
+bool Net::Framing::Reader_t::done() const
+{
+	return _table && _index >= _sections;
+}
+
+bool Net::Framing::Reader_t::read(byte* data, size_t size, size_t& consumed, piece_t& piece)
+{
+	consumed = 0;
+	piece = {};
+
+	if (!_table || _index >= _sections)
+		return true;
+
+	piece.type = _section.type;
+	piece.total = _section.size;
+
+	// a raw data key is collected until it is complete, the data can not be handed out without it
+	if (_key_read < _section.key_size)
+	{
+		if (!size)
+			return true;
+
+		const auto len = std::min(size, _section.key_size - _key_read);
+		memcpy(&_key[_key_read], data, len);
+		_key_read += len;
+		consumed += len;
+
+		if (_key_read < _section.key_size)
+			return true;
+
+		if (_key[_section.key_size - 1] != '\0')
+			return false;
+
+		data += len;
+		size -= len;
+	}
+
+	if (_section.type == Section_t::RAW_DATA)
+		piece.key = _key;
+
+	const auto len = std::min(size, _section.size - _data_read);
+	piece.data = data;
+	piece.size = len;
+	piece.offset = _data_read;
+	_data_read += len;
+	consumed += len;
+
+	// the key stays readable until the next call
+	if (_data_read == _section.size)
+	{
+		piece.complete = true;
+		enter(_index + 1);
+	}
+
+	return true;
+}
+
+void Net::Framing::encode(Net::Frame::Frame_t& frame, const int id, const uint16_t flags, byte* key, const size_t key_size, byte* iv, const size_t iv_size, byte* data, const size_t size, const size_t original_size, std::vector<Net::RawData_t>& raw)
+{
+	const size_t sections = (key ? 1 : 0) + (iv ? 1 : 0) + raw.size() + 1;
+	const size_t header_size = NET_FRAMING_V2_HEADER_LEN + sections * NET_FRAMING_V2_SECTION_LEN;
+
+	const auto header = ALLOC<byte>(header_size);
+	memset(header, 0, header_size);
+
+	size_t frame_size = header_size;
+	auto table = &header[NET_FRAMING_V2_HEADER_LEN];
+
+	const auto add = [&](const Section_t type, const size_t section_key_size, const size_t section_size, const size_t section_original_size)
+	{
+		table[0] = static_cast<byte>(type);
+		write_u32(&table[4], static_cast<uint32_t>(section_key_size));
+		write_u64(&table[8], section_size);
+		write_u64(&table[16], section_original_size);
+		table += NET_FRAMING_V2_SECTION_LEN;
+
+		frame_size += section_key_size + section_size;
+	};
+
+	if (key) add(Section_t::AES_KEY, 0, key_size, key_size);
+	if (iv) add(Section_t::AES_IV, 0, iv_size, iv_size);
+	for (const auto& entry : raw) add(Section_t::RAW_DATA, strlen(entry.key()) + 1, entry.size(), entry.original_size() ? entry.original_size() : entry.size());
+	add(Section_t::DATA, 0, size, original_size);
+
+	memcpy(header, NET_FRAMING_V2_MAGIC, NET_FRAMING_V2_MAGIC_LEN);
+	write_u16(&header[4], flags);
+	write_u16(&header[6], static_cast<uint16_t>(sections));
+	write_u32(&header[8], static_cast<uint32_t>(id));
+	write_u64(&header[16], frame_size);
+
+	frame.attach(header, header_size);
+
+	if (key) frame.attach(key, key_size);
+	if (iv) frame.attach(iv, iv_size);
+
+	for (auto& entry : raw)
+	{
+		frame.append(entry.key(), strlen(entry.key()) + 1);
+
+		// ownership moves into the frame unless the caller keeps the buffer
+#ifdef BUILD_LINUX
+		if (entry.is_file())
+			frame.attach_file(entry.file(), entry.file_offset(), entry.size(), entry.do_free());
+		else
+#endif
+		if (entry.do_free())
+			frame.attach(entry.value(), entry.size());
+		else
+			frame.append(entry.value(), entry.size());
+
+		entry.set_free(false);
+		entry.free();
+	}
+
+	frame.attach(data, size);
+}
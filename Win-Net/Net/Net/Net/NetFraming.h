@@ -0,0 +1,179 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+#pragma once
+#include <Net/Net/Net.h>
+#include <Net/Net/NetPacket.h>
+#include <Net/Net/NetFrame.h>
+
+/*
+* binary framing (v2), negotiated during the version exchange - all integers are little endian
+*
+*	header		{magic 4}{flags 2}{sections 2}{packet id 4}{reserved 4}{frame size 8}
+*	section		{type 1}{reserved 3}{key size 4}{size 8}{original size 8}
+*	payload		key and data of every section, in the order of the section table
+*
+* the frame size covers everything, soo a frame is delimited by reading a single field
+*/
+#define NET_FRAMING_V1 1
+#define NET_FRAMING_V2 2
+
+#define NET_FRAMING_V2_MAGIC CSTRING("NET2")
+#define NET_FRAMING_V2_MAGIC_LEN 4
+#define NET_FRAMING_V2_HEADER_LEN 24
+#define NET_FRAMING_V2_SECTION_LEN 24
+
+#define NET_FRAMING_V2_FLAG_CIPHER (1 << 0)
+#define NET_FRAMING_V2_FLAG_COMPRESSION (1 << 1)
+
+NET_DSA_BEGIN
+namespace Net
+{
+	namespace Framing
+	{
+		enum class Section_t : uint8_t
+		{
+			AES_KEY = 1,
+			AES_IV,
+			RAW_DATA,
+			DATA
+		};
+
+		/* points into the received frame */
+		struct section_t
+		{
+			Section_t type;
+			const char* key; /* raw data only, null terminated */
+			size_t key_size;
+			byte* data;
+			size_t size;
+			size_t original_size; /* size before the compression */
+		};
+
+		/* the first bytes are the magic of a binary frame, atleast NET_FRAMING_V2_MAGIC_LEN bytes have to be readable */
+		bool is_binary(const byte*, size_t);
+
+		/* size of the entire frame, NET_FRAMING_V2_HEADER_LEN bytes have to be readable */
+		size_t frame_size(const byte*);
+
+		/* packet id of the frame, it can be read as soon as the header is complete - negative if it is out of range */
+		int frame_id(const byte*);
+		uint16_t frame_flags(const byte*);
+
+		/* size of the header including the section table, NET_FRAMING_V2_HEADER_LEN bytes have to be readable */
+		size_t table_size(const byte*);
+
+		/*
+		* validates all offsets of a complete frame once, nothing gets allocated
+		* binary framing: the header and the section table
+		* text framing: the tags and their lengths, which are read in place - the flags are derived from the tags being used
+		* afterwards the sections are handed out in the order they have been sent
+		*/
+		class View_t
+		{
+			byte* _data;
+			size_t _size;
+			size_t _sections;
+			size_t _next;
+			size_t _payload;
+			size_t _original_size; /* text framing: {POS} */
+			int _id;
+			uint16_t _flags;
+			bool _text;
+
+			void read(size_t index, section_t&) const;
+			int read_text(size_t& offset, section_t&) const;
+
+			bool parse_binary(byte*, size_t);
+			bool parse_text(byte*, size_t);
+
+		public:
+			View_t();
+
+			bool parse(byte*, size_t);
+
+			/* binary framing only, -1 otherwise */
+			int id() const;
+			uint16_t flags() const;
+
+			bool next(section_t&);
+		};
+
+		/* part of a section handed out by Reader_t, it points into the buffer being read */
+		struct piece_t
+		{
+			Section_t type;
+			const char* key; /* raw data only, null terminated */
+			byte* data;
+			size_t size;
+			size_t offset; /* position within the section */
+			size_t total; /* size of the section */
+			bool complete; /* the last piece of the section */
+		};
+
+		/*
+		* binary framing: reads a frame while it is still being received, nothing but the section table is kept
+		* the payload is handed out piece by piece in the order of the section table
+		*/
+		class Reader_t
+		{
+			byte* _table;
+			size_t _sections;
+			size_t _index;
+			size_t _key_read;
+			size_t _data_read;
+			char _key[256];
+			section_t _section;
+
+			void enter(size_t index);
+
+		public:
+			Reader_t();
+			~Reader_t();
+
+			Reader_t(const Reader_t&) = delete;
+			Reader_t& operator=(const Reader_t&) = delete;
+
+			/* the header and the section table have to be readable (see table_size), they are validated the same way View_t does it */
+			bool begin(const byte*);
+			void end();
+
+			bool active() const;
+			bool done() const;
+
+			/*
+			* reads at most size bytes of the payload, consumed tells how many of them can be released
+			* the piece describes the part of the section that has been read, it might be empty as long as a raw data key is incomplete
+			* returns false if the frame is malformed
+			*/
+			bool read(byte* data, size_t size, size_t& consumed, piece_t& piece);
+		};
+
+		/*
+		* writes the packet into the frame, the ownership of key, iv and data moves into the frame
+		* raw data is consumed the same way the text framing does it
+		*/
+		void encode(Net::Frame::Frame_t&, int id, uint16_t flags, byte* key, size_t key_size, byte* iv, size_t iv_size, byte* data, size_t size, size_t original_size, std::vector<Net::RawData_t>& raw);
+	}
+}
+NET_DSA_END
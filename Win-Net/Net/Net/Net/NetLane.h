@@ -0,0 +1,103 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+
+/* amount of priority classes */
+#define NET_LANES 3
+
+#include <cstddef>
+
+namespace Net
+{
+	namespace Lane
+	{
+		/* priority class of a packet, lower values are served first */
+		enum class Lane_t
+		{
+			NATIVE = 0, /* handshake, version and close, always assigned to the packets of the library */
+			CONTROL, /* small application messages that have to pass the bulk, e.g. heartbeats */
+			BULK /* everything else */
+		};
+
+		/*
+		* picks the lane to serve next out of per lane queues
+		* higher lanes are served first, but after 'limit' items in a row one item of the lowest waiting lane is served
+		* soo a steady flow of control packets can delay the bulk but never starve it
+		*/
+		class Scheduler_t
+		{
+			size_t burst;
+			size_t limit;
+
+		public:
+			Scheduler_t()
+			{
+				burst = 0;
+				limit = 0;
+			}
+
+			/* 0 disables the starvation protection */
+			void set_limit(size_t limit)
+			{
+				this->limit = limit;
+			}
+
+			size_t get_limit() const
+			{
+				return limit;
+			}
+
+			/* returns -1 if all queues are empty */
+			template <typename Q>
+			int next(const Q(&queues)[NET_LANES])
+			{
+				int highest = -1;
+				int lowest = -1;
+				for (int i = 0; i < NET_LANES; ++i)
+				{
+					if (queues[i].empty()) continue;
+					if (highest == -1) highest = i;
+					lowest = i;
+				}
+
+				// nothing is waiting behind the highest lane
+				if (highest == lowest)
+				{
+					burst = 0;
+					return highest;
+				}
+
+				if (limit > 0 && burst >= limit)
+				{
+					burst = 0;
+					return lowest;
+				}
+
+				burst++;
+				return highest;
+			}
+		};
+	}
+}
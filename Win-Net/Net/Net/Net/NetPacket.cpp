@@ -32,6 +32,8 @@ Net::RawData_t::RawData_t()
 	this->_original_size = 0;
 	this->_free_after_sent = false;
 	this->_valid = false;
+	this->_fd = SOCKET_ERROR;
+	this->_fd_offset = 0;
 }
 
 Net::RawData_t::RawData_t(const char* name, byte* pointer, const size_t size)
@@ -42,6 +44,8 @@ Net::RawData_t::RawData_t(const char* name, byte* pointer, const size_t size)
 	this->_original_size = size;
 	this->_free_after_sent = true;
 	this->_valid = true;
+	this->_fd = SOCKET_ERROR;
+	this->_fd_offset = 0;
 }
 
 Net::RawData_t::RawData_t(const char* name, byte* pointer, const size_t size, const bool free_after_sent)
@@ -52,8 +56,24 @@ Net::RawData_t::RawData_t(const char* name, byte* pointer, const size_t size, co
 	this->_original_size = size;
 	this->_free_after_sent = free_after_sent;
 	this->_valid = true;
+	this->_fd = SOCKET_ERROR;
+	this->_fd_offset = 0;
 }
 
+#ifdef BUILD_LINUX
+Net::RawData_t::RawData_t(const char* name, const int fd, const size_t offset, const size_t size, const bool close_after_sent)
+{
+	strcpy(this->_key, name);
+	this->_data = nullptr;
+	this->_size = size;
+	this->_original_size = size;
+	this->_free_after_sent = close_after_sent;
+	this->_valid = true;
+	this->_fd = fd;
+	this->_fd_offset = offset;
+}
+#endif
+
 bool Net::RawData_t::valid() const
 {
 	return _valid;
@@ -109,12 +129,69 @@ void Net::RawData_t::free()
 	// only free the passed reference if we allow it
 	if (do_free()) FREE<byte>(this->_data);
 
+#ifdef BUILD_LINUX
+	if (is_file() && do_free()) close(this->_fd);
+#endif
+
 	this->_data = nullptr;
 	this->_size = 0;
+	this->_fd = SOCKET_ERROR;
+	this->_fd_offset = 0;
 
 	this->_valid = false;
 }
 
+bool Net::RawData_t::is_file() const
+{
+	return _fd != SOCKET_ERROR;
+}
+
+int Net::RawData_t::file() const
+{
+	return _fd;
+}
+
+size_t Net::RawData_t::file_offset() const
+{
+	return _fd_offset;
+}
+
+bool Net::RawData_t::load()
+{
+	if (!is_file())
+		return true;
+
+#ifdef BUILD_LINUX
+	auto data = ALLOC<byte>(_size + 1);
+	size_t read = 0;
+	while (read < _size)
+	{
+		const auto res = pread(_fd, data + read, _size - read, static_cast<off_t>(_fd_offset + read));
+		if (res == SOCKET_ERROR && errno == EINTR)
+			continue;
+
+		if (res <= 0)
+		{
+			FREE<byte>(data);
+			return false;
+		}
+
+		read += static_cast<size_t>(res);
+	}
+
+	if (do_free()) close(_fd);
+
+	// from now on we own an ordinary buffer
+	_fd = SOCKET_ERROR;
+	_fd_offset = 0;
+	_data = data;
+	_free_after_sent = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
 void Net::RawData_t::set_original_size(size_t size)
 {
 	this->_original_size = size;
@@ -135,6 +212,14 @@ Net::Packet::Packet::Packet()
 	this->json = {};
 	this->raw = {};
 	this->freeRaw = true;
+	this->body = nullptr;
+	this->probe = false;
+}
+
+Net::Packet::Packet::Packet(const Packet& other)
+{
+	this->body = nullptr;
+	*this = other;
 }
 
 Net::Packet::Packet::~Packet()
@@ -146,13 +231,95 @@ Net::Packet::Packet::~Packet()
 			entry.free();
 		}
 	}
+
+	FREE<byte>(this->body);
+	this->body = nullptr;
+}
+
+Net::Packet& Net::Packet::operator=(const Packet& other)
+{
+	if (this == &other)
+		return *this;
+
+	FREE<byte>(this->body);
+	this->body = nullptr;
+
+	this->json = other.json;
+	this->raw = other.raw;
+	this->freeRaw = other.freeRaw;
+	this->probe = other.probe;
+
+	// each copy parses its own document
+	if (other.body)
+	{
+		const auto size = strlen(reinterpret_cast<const char*>(other.body)) + 1;
+		this->body = ALLOC<byte>(size);
+		if (this->body)
+			memcpy(this->body, other.body, size);
+	}
+
+	return *this;
+}
+
+void Net::Packet::load()
+{
+	if (!this->body)
+		return;
+
+	byte* data = this->body;
+	this->body = nullptr;
+
+	Net::Json::Document doc;
+	if (!doc.Deserialize(reinterpret_cast<char*>(data)))
+	{
+		FREE<byte>(data);
+		NET_LOG_ERROR(CSTRING("Unable to deserialize the body of the packet"));
+		return;
+	}
+
+	FREE<byte>(data);
+
+	if (doc[CSTRING("CONTENT")] && doc[CSTRING("CONTENT")]->is_object())
+	{
+		this->json.Set(doc[CSTRING("CONTENT")]->as_object());
+	}
+	else if (doc[CSTRING("CONTENT")] && doc[CSTRING("CONTENT")]->is_array())
+	{
+		this->json.Set(doc[CSTRING("CONTENT")]->as_array());
+	}
+	else
+	{
+		NET_LOG_ERROR(CSTRING("The body of the packet has no content"));
+	}
 }
 
 Net::Json::Document& Net::Packet::Data()
 {
+	load();
 	return this->json;
 }
 
+void Net::Packet::SetBody(byte* data)
+{
+	FREE<byte>(this->body);
+	this->body = data;
+}
+
+bool Net::Packet::HasBody() const
+{
+	return this->body != nullptr;
+}
+
+void Net::Packet::SetProbe(const bool probe)
+{
+	this->probe = probe;
+}
+
+bool Net::Packet::IsProbe() const
+{
+	return this->probe;
+}
+
 void Net::Packet::AddRaw(const char* Key, BYTE* data, const size_t size, const bool free_after_sent)
 {
 	for (auto& entry : this->raw)
@@ -195,18 +362,44 @@ void Net::Packet::AddRaw(Net::RawData_t& raw)
 	this->raw.emplace_back(raw);
 }
 
+#ifdef BUILD_LINUX
+void Net::Packet::AddRawFile(const char* Key, const int fd, const size_t offset, const size_t size, const bool close_after_sent)
+{
+	for (auto& entry : this->raw)
+	{
+		if (!strcmp(entry.key(), Key))
+		{
+			if (close_after_sent)
+			{
+				NET_LOG_ERROR(CSTRING("Duplicated Key, file descriptor gets automaticly closed to avoid leaking it"));
+				close(fd);
+				return;
+			}
+
+			NET_LOG_ERROR(CSTRING("Duplicated Key, file descriptor has not been closed"));
+			return;
+		}
+	}
+
+	this->raw.emplace_back(Net::RawData_t(Key, fd, offset, size, close_after_sent));
+}
+#endif
+
 bool Net::Packet::Deserialize(char* data)
 {
+	SetBody(nullptr);
 	return this->json.Deserialize(data);
 }
 
 bool Net::Packet::Deserialize(const char* data)
 {
+	SetBody(nullptr);
 	return this->json.Deserialize(data);
 }
 
 void Net::Packet::SetJson(Net::Json::Document& doc)
 {
+	SetBody(nullptr);
 	this->json = doc;
 }
 
@@ -225,6 +418,20 @@ std::vector<Net::RawData_t>& Net::Packet::Packet::GetRawData()
 	return this->raw;
 }
 
+bool Net::Packet::Packet::LoadRawFiles()
+{
+	for (auto& entry : this->raw)
+	{
+		if (!entry.load())
+		{
+			NET_LOG_ERROR(CSTRING("unable to read raw data '%s' from its file"), entry.key());
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool Net::Packet::Packet::HasRawData() const
 {
 	return !this->raw.empty();
@@ -277,5 +484,6 @@ Net::RawData_t* Net::Packet::GetRaw(const char* Key)
 
 Net::String Net::Packet::Stringify()
 {
+	load();
 	return this->json.Serialize(Net::Json::SerializeType::UNFORMATTED);
 }
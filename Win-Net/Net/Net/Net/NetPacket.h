@@ -63,10 +63,18 @@ namespace Net
 		bool _free_after_sent; /* by default this value is set to TRUE */
 		bool _valid;
 
+		/* file backed data, sent using sendfile */
+		int _fd;
+		size_t _fd_offset;
+
 	public:
 		RawData_t();
 		RawData_t(const char* name, byte* pointer, const size_t size);
 		RawData_t(const char* name, byte* pointer, const size_t size, const bool free_after_sent);
+#ifdef BUILD_LINUX
+		/* linux only: the data does not pass through user memory, close_after_sent closes the descriptor once it has been sent */
+		RawData_t(const char* name, const int fd, const size_t offset, const size_t size, const bool close_after_sent = true);
+#endif
 
 		bool valid() const;
 		byte* value() const;
@@ -79,6 +87,13 @@ namespace Net
 		void set(byte* pointer);
 		void free();
 
+		bool is_file() const;
+		int file() const;
+		size_t file_offset() const;
+
+		/* read file backed data into memory, required if the data has to be modified before sending it */
+		bool load();
+
 		void set_original_size(size_t size);
 		size_t original_size() const;
 		size_t& original_size();
@@ -90,19 +105,40 @@ namespace Net
 		std::vector<Net::RawData_t> raw;
 		bool freeRaw;
 
+		/* received document, it gets deserialized the first time the json is accessed */
+		byte* body;
+		bool probe;
+
+		void load();
+
 	public:
 		Packet();
+		Packet(const Packet&);
 		~Packet();
 
+		Packet& operator=(const Packet&);
+
 		Net::Json::BasicValueRead operator[](const char* key)
 		{
+			load();
 			return json[key];
 		}
 
 		Net::Json::Document& Data();
 
+		/* takes over the null terminated document of a received frame ({"ID": .., "CONTENT": ..}), the handler only pays for parsing it if it reads the json */
+		void SetBody(byte* data);
+		bool HasBody() const;
+
+		/* the packet definitions only tell whether they know the id, the handler is not executed */
+		void SetProbe(bool probe);
+		bool IsProbe() const;
+
 		void AddRaw(const char* Key, BYTE* data, const size_t size, const bool free_after_sent = true);
 		void AddRaw(Net::RawData_t& raw);
+#ifdef BUILD_LINUX
+		void AddRawFile(const char* Key, const int fd, const size_t offset, const size_t size, const bool close_after_sent = true);
+#endif
 
 		bool Deserialize(char* data);
 		bool Deserialize(const char* data);
@@ -115,6 +151,7 @@ namespace Net
 		bool HasRawData() const;
 		size_t GetRawDataFullSize(bool bCompression) const;
 		Net::RawData_t* GetRaw(const char* Key);
+		bool LoadRawFiles();
 
 		Net::String Stringify();
 	};
@@ -22,8 +22,6 @@
 	SOFTWARE.
 */
 
-#define DEFAULT_MAX_PEER_COUNT 4
-
 #include <Net/Net/NetPeerPool.h>
 #include <Net/assets/manager/logmanager.h>
 
@@ -32,6 +30,7 @@ Net::PeerPool::peerInfo_t::peerInfo_t()
 	this->SetPeer(nullptr);
 	this->SetWorker(nullptr);
 	this->SetCallbackOnDelete(nullptr);
+	this->SetCallbackOnReceive(nullptr);
 }
 
 Net::PeerPool::peerInfo_t::peerInfo_t(void* peer)
@@ -39,6 +38,7 @@ Net::PeerPool::peerInfo_t::peerInfo_t(void* peer)
 	this->SetPeer(peer);
 	this->SetWorker(nullptr);
 	this->SetCallbackOnDelete(nullptr);
+	this->SetCallbackOnReceive(nullptr);
 }
 
 Net::PeerPool::peerInfo_t::peerInfo_t(void* peer, WorkStatus_t(*fncWork)(void* peer))
@@ -46,6 +46,7 @@ Net::PeerPool::peerInfo_t::peerInfo_t(void* peer, WorkStatus_t(*fncWork)(void* p
 	this->SetPeer(peer);
 	this->SetWorker(fncWork);
 	this->SetCallbackOnDelete(nullptr);
+	this->SetCallbackOnReceive(nullptr);
 }
 
 Net::PeerPool::peerInfo_t::peerInfo_t(void* peer, void (*fncCallbackOnDelete)(void* peer))
@@ -53,6 +54,7 @@ Net::PeerPool::peerInfo_t::peerInfo_t(void* peer, void (*fncCallbackOnDelete)(vo
 	this->SetPeer(peer);
 	this->SetWorker(nullptr);
 	this->SetCallbackOnDelete(fncCallbackOnDelete);
+	this->SetCallbackOnReceive(nullptr);
 }
 
 Net::PeerPool::peerInfo_t::peerInfo_t(void* peer, WorkStatus_t(*fncWork)(void* peer), void (*fncCallbackOnDelete)(void* peer))
@@ -60,6 +62,7 @@ Net::PeerPool::peerInfo_t::peerInfo_t(void* peer, WorkStatus_t(*fncWork)(void* p
 	this->SetPeer(peer);
 	this->SetWorker(fncWork);
 	this->SetCallbackOnDelete(fncCallbackOnDelete);
+	this->SetCallbackOnReceive(nullptr);
 }
 
 void Net::PeerPool::peerInfo_t::SetPeer(void* peer)
@@ -94,11 +97,55 @@ void* Net::PeerPool::peerInfo_t::GetCallbackOnDelete()
 	return nullptr;
 }
 
+void Net::PeerPool::peerInfo_t::SetCallbackOnReceive(WorkStatus_t(*fncCallbackOnReceive)(void* peer, byte* data, int64 size))
+{
+	this->fncCallbackOnReceive = fncCallbackOnReceive;
+}
+
+void* Net::PeerPool::peerInfo_t::GetCallbackOnReceive()
+{
+	if (this->fncCallbackOnReceive) return (void*)this->fncCallbackOnReceive;
+	return nullptr;
+}
+
 Net::PeerPool::PeerPool_t::PeerPool_t()
 {
+	running = false;
+	running_threads = 0;
+	num_threads = 0;
 	fncSleep = nullptr;
 	ms_sleep_time = 100;
-	max_peers = DEFAULT_MAX_PEER_COUNT;
+	thread_attributes.set_name(CSTRING("net-pool"));
+}
+
+Net::PeerPool::PeerPool_t::~PeerPool_t()
+{
+	stop();
+}
+
+bool Net::PeerPool::PeerPool_t::is_running() const
+{
+	return running;
+}
+
+void Net::PeerPool::PeerPool_t::thread_started()
+{
+	running_threads++;
+}
+
+void Net::PeerPool::PeerPool_t::thread_finished()
+{
+	running_threads--;
+}
+
+void Net::PeerPool::PeerPool_t::set_num_threads(size_t num_threads)
+{
+	this->num_threads = num_threads;
+}
+
+size_t Net::PeerPool::PeerPool_t::get_num_threads() const
+{
+	return this->num_threads;
 }
 
 void Net::PeerPool::PeerPool_t::set_sleep_time(DWORD ms_sleep_time)
@@ -111,6 +158,11 @@ DWORD Net::PeerPool::PeerPool_t::get_sleep_time()
 	return this->ms_sleep_time;
 }
 
+void Net::PeerPool::PeerPool_t::set_thread_attributes(const Net::Thread::Attributes_t& attributes)
+{
+	this->thread_attributes = attributes;
+}
+
 void Net::PeerPool::PeerPool_t::set_sleep_function(void (*fncSleep)(DWORD time))
 {
 	this->fncSleep = fncSleep;
@@ -121,32 +173,15 @@ void* Net::PeerPool::PeerPool_t::get_sleep_function()
 	return (void*)this->fncSleep;
 }
 
-void Net::PeerPool::PeerPool_t::set_max_peers(size_t max_peers)
-{
-	this->max_peers = max_peers;
-}
-
-size_t Net::PeerPool::PeerPool_t::get_max_peers()
-{
-	return this->max_peers;
-}
-
-bool Net::PeerPool::PeerPool_t::check_more_threads_needed()
+void Net::PeerPool::PeerPool_t::sleep()
 {
-	const std::lock_guard<std::recursive_mutex> lock(peer_threadpool_mutex);
-	for (const auto& pool : peer_threadpool)
+	if (fncSleep)
 	{
-		if (count_peers(pool) != max_peers)
-			return false;
+		(*fncSleep)(ms_sleep_time);
+		return;
 	}
 
-	return true;
-}
-
-void Net::PeerPool::PeerPool_t::threapool_push(peer_threadpool_t* pool)
-{
-	const std::lock_guard<std::recursive_mutex> lock(peer_threadpool_mutex);
-	peer_threadpool.emplace_back(pool);
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms_sleep_time));
 }
 
 struct threadpool_manager_data_t
@@ -160,231 +195,275 @@ NET_THREAD(threadpool_manager)
 	auto data = (threadpool_manager_data_t*)parameter;
 	auto pClass = data->pClass;
 	auto pool = data->pool;
+	FREE<threadpool_manager_data_t>(data);
 
-	while (data)
+	while (pClass->is_running())
 	{
-		bool take_rest = true;
+		pClass->admit(pool);
 
-		for (size_t i = 0; i < pClass->get_max_peers(); ++i)
-		{
-			auto& peer = pool->vPeers[i];
-			if (peer == nullptr)
-			{
-				auto waiting_peer = pClass->queue_pop();
-				if (waiting_peer)
-					peer = waiting_peer;
+		// even out the load before starting the next round
+		pClass->steal(pool);
 
-				// process in next iteration
-				continue;
-			}
+		bool take_rest = true;
 
+		// peers that get pushed back during this round are processed in the next one
+		auto round = pClass->count_peers(pool);
+
+		Net::PeerPool::peerInfo_t peer;
+		while (round-- > 0 && pClass->pop(pool, peer))
+		{
 			// Automaticly set to stop if no worker function is set
 			Net::PeerPool::WorkStatus_t ret = Net::PeerPool::WorkStatus_t::STOP;
 
-			auto fncWorkPointer = peer->GetWorker();
+			auto fncWorkPointer = peer.GetWorker();
 			if (fncWorkPointer)
 			{
 				auto fncWork = reinterpret_cast<Net::PeerPool::WorkStatus_t(*)(void* peer)>(fncWorkPointer);
-				ret = (*fncWork)(peer->GetPeer());
+				ret = (*fncWork)(peer.GetPeer());
 			}
 
 			switch (ret)
 			{
 			case Net::PeerPool::WorkStatus_t::STOP:
 			{
-				auto fncCallbackOnDeletePointer = peer->GetCallbackOnDelete();
+				auto fncCallbackOnDeletePointer = peer.GetCallbackOnDelete();
 				if (fncCallbackOnDeletePointer)
 				{
 					auto fncCallbackOnDelete = reinterpret_cast<void (*)(void* peer)>(fncCallbackOnDeletePointer);
-					(*fncCallbackOnDelete)(peer->GetPeer());
+					(*fncCallbackOnDelete)(peer.GetPeer());
 				}
 
-				peer = nullptr;
-				break;
-			}
-
-			case Net::PeerPool::WorkStatus_t::CONTINUE:
-			{
-				/* move peers into available threads to reduce the amount of running threads */
-				const std::lock_guard<std::recursive_mutex> lock(*pClass->get_peer_threadpool_mutex());
-				const auto p = pClass->threadpool_get_free_slot_in_target_pool(pool);
-				if (p)
-				{
-					// move peer pointer
-					for (size_t j = 0; j < pClass->get_max_peers(); ++j)
-					{
-						auto& target_peer = p->vPeers[j];
-						if (!target_peer)
-						{
-							target_peer = peer;
-							peer = nullptr;
-							break;
-						}
-					}
-				}
+				pClass->release(pool);
 				break;
 			}
 
 			// do not take a rest if we want to forward on processing worker function rapidly
 			case Net::PeerPool::WorkStatus_t::FORWARD:
-			{
 				take_rest = false;
+				pClass->push(pool, peer);
 				break;
-			}
 
 			default:
+				pClass->push(pool, peer);
 				break;
 			}
 		}
 
-		// close this thread
-		if (pClass->count_peers(pool) == 0)
-		{
-			// erase from vector
-			const std::lock_guard<std::recursive_mutex> lock(*pClass->get_peer_threadpool_mutex());
-			for (auto it = pClass->get_peer_threadpool().begin(); it != pClass->get_peer_threadpool().end(); it++)
-			{
-				auto p = *it;
-				// compare mem address
-				if (p == pool)
-				{
-					pClass->get_peer_threadpool().erase(it);
-					break;
-				}
-			}
+		if (take_rest)
+			pClass->sleep();
+	}
 
-			FREE<Net::PeerPool::peerInfo_t>(pool->vPeers);
-			FREE<threadpool_manager_data_t>(data);
-			return NULL;
-		}
+	// hand all remaining peers over to their delete callback
+	pClass->admit(pool);
 
-		if (take_rest)
+	Net::PeerPool::peerInfo_t peer;
+	while (pClass->pop(pool, peer))
+	{
+		auto fncCallbackOnDeletePointer = peer.GetCallbackOnDelete();
+		if (fncCallbackOnDeletePointer)
 		{
-			auto fncSleepPointer = pClass->get_sleep_function();
-			if (fncSleepPointer)
-			{
-				auto fncSleep = reinterpret_cast<void (*)(DWORD time)>(fncSleepPointer);
-				(*fncSleep)(pClass->get_sleep_time());
-			}
-			else
-			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(pClass->get_sleep_time()));
-			}
+			auto fncCallbackOnDelete = reinterpret_cast<void (*)(void* peer)>(fncCallbackOnDeletePointer);
+			(*fncCallbackOnDelete)(peer.GetPeer());
 		}
+
+		pClass->release(pool);
 	}
 
-	FREE<threadpool_manager_data_t>(data);
+	pClass->thread_finished();
 	return NULL;
 }
 
-void Net::PeerPool::PeerPool_t::threadpool_add()
+bool Net::PeerPool::PeerPool_t::start()
 {
-	peer_threadpool_t* pool = ALLOC<peer_threadpool_t>();
-	if (!pool) return;
+	if (is_running())
+		return false;
+
+	auto threads = num_threads;
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+
+	if (threads == 0)
+		threads = 1;
 
-	pool->vPeers = ALLOC<Net::PeerPool::peerInfo_t*>(get_max_peers());
-	if (!pool->vPeers)
+	for (size_t i = 0; i < threads; ++i)
 	{
-		FREE<Net::PeerPool::peer_threadpool_t>(pool);
-		return;
+		auto pool = new peer_threadpool_t();
+		pool->num_peers = 0;
+		peer_threadpool.emplace_back(pool);
 	}
 
-	for (size_t i = 0; i < get_max_peers(); ++i)
-		pool->vPeers[i] = nullptr;
+	running = true;
+
+	size_t index = 0;
+	for (const auto pool : peer_threadpool)
+	{
+		auto data = ALLOC<threadpool_manager_data_t>();
+		data->pClass = this;
+		data->pool = pool;
 
-	// dispatch the thread
-	auto data = ALLOC<threadpool_manager_data_t>();
-	data->pClass = this;
-	data->pool = pool;
-	Net::Thread::Create(threadpool_manager, (LPVOID)data);
+		thread_started();
+		Net::Thread::Create(threadpool_manager, (LPVOID)data, thread_attributes.worker(index++));
+	}
 
-	// push to vector
-	threapool_push(pool);
+	return true;
 }
 
-Net::PeerPool::peer_threadpool_t* Net::PeerPool::PeerPool_t::threadpool_get_free_slot_in_target_pool(peer_threadpool_t* current_pool)
+void Net::PeerPool::PeerPool_t::stop()
 {
-	if (!peer_queue.empty()) return nullptr;
+	running = false;
 
-	for (const auto& pool : peer_threadpool)
-	{
-		if (pool == current_pool) continue;
-		for (size_t i = 0; i < get_max_peers(); ++i)
-		{
-			auto& peer = pool->vPeers[i];
-			if (!peer) return pool;
-		}
-	}
+	// wait for the threads to release their peers
+	while (running_threads > 0)
+		sleep();
 
-	return nullptr;
+	for (const auto pool : peer_threadpool)
+		delete pool;
+
+	peer_threadpool.clear();
 }
 
-Net::PeerPool::peerInfo_t* Net::PeerPool::PeerPool_t::queue_pop()
+bool Net::PeerPool::PeerPool_t::pop(peer_threadpool_t* pool, peerInfo_t& info)
 {
-	if (peer_queue.empty()) return nullptr;
+	const std::lock_guard<std::mutex> lock(pool->peers_mutex);
+	if (pool->peers.empty())
+		return false;
 
-	const std::lock_guard<std::recursive_mutex> lock(peer_mutex);
-	auto peer = peer_queue.back();
-	peer_queue.pop_back();
-	return peer;
+	info = pool->peers.front();
+	pool->peers.pop_front();
+	return true;
 }
 
-std::vector<Net::PeerPool::peer_threadpool_t*>& Net::PeerPool::PeerPool_t::get_peer_threadpool()
+void Net::PeerPool::PeerPool_t::push(peer_threadpool_t* pool, const peerInfo_t& info)
 {
-	return this->peer_threadpool;
+	const std::lock_guard<std::mutex> lock(pool->peers_mutex);
+	pool->peers.emplace_back(info);
 }
 
-std::recursive_mutex* Net::PeerPool::PeerPool_t::get_peer_threadpool_mutex()
+/* the peer that has been popped last is gone for good */
+void Net::PeerPool::PeerPool_t::release(peer_threadpool_t* pool)
 {
-	return &this->peer_threadpool_mutex;
+	pool->num_peers--;
 }
 
-void Net::PeerPool::PeerPool_t::add(peerInfo_t info)
+/* owner only */
+void Net::PeerPool::PeerPool_t::admit(peer_threadpool_t* pool)
 {
-	const std::lock_guard<std::recursive_mutex> lock(peer_mutex);
-	peer_queue.emplace_back(new peerInfo_t(info));
+	// idle workers should not touch their lock for nothing
+	if (pool->admission.empty())
+		return;
 
-	if (check_more_threads_needed())
-		this->threadpool_add();
+	Net::PeerPool::peerInfo_t info;
+	const std::lock_guard<std::mutex> lock(pool->peers_mutex);
+	while (pool->admission.pop(info))
+		pool->peers.emplace_back(info);
 }
 
-void Net::PeerPool::PeerPool_t::add(peerInfo_t* info)
+void Net::PeerPool::PeerPool_t::steal(peer_threadpool_t* pool)
 {
-	const std::lock_guard<std::recursive_mutex> lock(peer_mutex);
-	peer_queue.emplace_back(info);
+	// look for the busiest worker without locking anything
+	peer_threadpool_t* victim = nullptr;
+	size_t victim_peers = 0;
+
+	for (const auto p : peer_threadpool)
+	{
+		const size_t peers = p->num_peers;
+		if (p != pool && peers > victim_peers)
+		{
+			victim = p;
+			victim_peers = peers;
+		}
+	}
 
-	if (check_more_threads_needed())
-		this->threadpool_add();
+	const size_t own_peers = pool->num_peers;
+	if (!victim || victim_peers <= own_peers + 1)
+		return;
+
+	// take half of the difference from the back, the victim keeps on working on its front
+	auto amount = (victim_peers - own_peers) / 2;
+
+	std::vector<Net::PeerPool::peerInfo_t> stolen;
+	{
+		const std::lock_guard<std::mutex> lock(victim->peers_mutex);
+		while (amount-- > 0 && !victim->peers.empty())
+		{
+			stolen.emplace_back(victim->peers.back());
+			victim->peers.pop_back();
+		}
+
+		victim->num_peers -= stolen.size();
+	}
+
+	if (stolen.empty())
+		return;
+
+	const std::lock_guard<std::mutex> lock(pool->peers_mutex);
+	for (const auto& info : stolen)
+		pool->peers.emplace_back(info);
+
+	pool->num_peers += stolen.size();
 }
 
-size_t Net::PeerPool::PeerPool_t::count_peers_all()
+Net::PeerPool::peer_threadpool_t* Net::PeerPool::PeerPool_t::get_least_busy_pool()
 {
-	size_t peers = 0;
+	peer_threadpool_t* target = nullptr;
+	size_t target_peers = 0;
 
-	const std::lock_guard<std::recursive_mutex> lock(peer_threadpool_mutex);
 	for (const auto pool : peer_threadpool)
-		for (size_t i = 0; i < get_max_peers(); ++i)
+	{
+		const size_t peers = pool->num_peers;
+		if (!target || peers < target_peers)
 		{
-			auto peer = pool->vPeers[i];
-			if (peer) peers++;
+			target = pool;
+			target_peers = peers;
 		}
+	}
 
-	return peers;
+	return target;
 }
 
-size_t Net::PeerPool::PeerPool_t::count_peers(peer_threadpool_t* pool)
+void Net::PeerPool::PeerPool_t::add(peerInfo_t info)
 {
-	size_t peers = 0;
-
-	for (size_t i = 0; i < get_max_peers(); ++i)
+	const auto pool = is_running() ? get_least_busy_pool() : nullptr;
+	if (!pool)
 	{
-		auto peer = pool->vPeers[i];
-		if (peer) peers++;
+		NET_LOG_ERROR(CSTRING("[PeerPool] - unable to add peer, the pool is not running"));
+
+		auto fncCallbackOnDeletePointer = info.GetCallbackOnDelete();
+		if (fncCallbackOnDeletePointer)
+		{
+			auto fncCallbackOnDelete = reinterpret_cast<void (*)(void* peer)>(fncCallbackOnDeletePointer);
+			(*fncCallbackOnDelete)(info.GetPeer());
+		}
+
+		return;
 	}
 
+	pool->num_peers++;
+
+	// the admission queue is full during a big accept burst, the locked queue takes the rest
+	if (!pool->admission.push(info))
+		push(pool, info);
+}
+
+void Net::PeerPool::PeerPool_t::add(peerInfo_t* info)
+{
+	add(*info);
+}
+
+size_t Net::PeerPool::PeerPool_t::count_peers_all()
+{
+	size_t peers = 0;
+	for (const auto pool : peer_threadpool)
+		peers += pool->num_peers;
+
 	return peers;
 }
 
+size_t Net::PeerPool::PeerPool_t::count_peers(peer_threadpool_t* pool)
+{
+	return pool->num_peers;
+}
+
 size_t Net::PeerPool::PeerPool_t::count_pools()
 {
 	return peer_threadpool.size();
@@ -22,9 +22,17 @@
 	SOFTWARE.
 */
 
+#pragma once
+
+/* amount of peers that can be handed over to a worker without locking before falling back to its queue mutex */
+#define NET_PEERPOOL_ADMISSION_SIZE 1024
+
 #include <Net/Net/Net.h>
+#include <Net/Net/NetQueue.h>
 #include <Net/assets/thread.h>
 #include <mutex>
+#include <deque>
+#include <atomic>
 
 NET_DSA_BEGIN
 namespace Net
@@ -35,7 +43,8 @@ namespace Net
 		{
 			STOP = 0,
 			CONTINUE,
-			FORWARD
+			FORWARD,
+			WAIT /* nothing to do before the next tick, e.g. the peer is being rate limited */
 		};
 
 		class peerInfo_t
@@ -43,6 +52,7 @@ namespace Net
 			void* peer;
 			WorkStatus_t(*fncWork)(void* peer);
 			void (*fncCallbackOnDelete)(void* peer);
+			WorkStatus_t(*fncCallbackOnReceive)(void* peer, byte* data, int64 size);
 
 		public:
 			peerInfo_t();
@@ -59,48 +69,89 @@ namespace Net
 
 			void SetCallbackOnDelete(void (*fncCallbackOnDelete)(void* peer));
 			void* GetCallbackOnDelete();
+
+			/*
+			* completion based backends hand the received data over instead of letting the worker read it
+			* size > 0: data, size == 0: closed by the remote, size < 0: -errno
+			*/
+			void SetCallbackOnReceive(WorkStatus_t(*fncCallbackOnReceive)(void* peer, byte* data, int64 size));
+			void* GetCallbackOnReceive();
 		};
+	}
+}
+NET_DSA_END
 
+namespace Net
+{
+	namespace PeerPool
+	{
+		/*
+		* one worker thread of the pool
+		* the owner keeps on working from the front of its queue, idle workers steal from the back
+		*/
 		struct peer_threadpool_t
 		{
-			Net::PeerPool::peerInfo_t** vPeers;
+			std::deque<Net::PeerPool::peerInfo_t> peers;
+			std::mutex peers_mutex;
+
+			/* new peers, pushed by any thread and moved into peers by the owner at the start of every round */
+			Net::Queue::MPSC_t<Net::PeerPool::peerInfo_t, NET_PEERPOOL_ADMISSION_SIZE> admission;
+
+			/* readable without locking, includes the peer that is currently being processed */
+			std::atomic<size_t> num_peers;
 		};
 
+		/*
+		* fixed set of worker threads, every peer belongs to exactly one of them
+		* there is no lock shared by all workers, a worker only locks its own queue and the one it steals from
+		*/
 		class PeerPool_t
 		{
-			std::vector<Net::PeerPool::peerInfo_t*> peer_queue;
-			std::recursive_mutex peer_mutex;
-
 			std::vector<peer_threadpool_t*> peer_threadpool;
-			std::recursive_mutex peer_threadpool_mutex;
 
-			bool check_more_threads_needed();
-			void threapool_push(peer_threadpool_t* pool);
-			void threadpool_add();
+			std::atomic<bool> running;
+			std::atomic<size_t> running_threads;
+
+			size_t num_threads;
 
 			DWORD ms_sleep_time;
 			void (*fncSleep)(DWORD time);
 
-			size_t max_peers;
+			Net::Thread::Attributes_t thread_attributes;
+
+			peer_threadpool_t* get_least_busy_pool();
 
 		public:
 			PeerPool_t();
+			~PeerPool_t();
 
-			peerInfo_t* queue_pop();
+			bool start();
+			void stop();
 
-			std::vector<peer_threadpool_t*>& get_peer_threadpool();
-			std::recursive_mutex* get_peer_threadpool_mutex();
+			bool is_running() const;
+			void thread_started();
+			void thread_finished();
 
-			peer_threadpool_t* threadpool_get_free_slot_in_target_pool(peer_threadpool_t* from_pool);
+			/* has to be set before starting - 0 will use one thread per core */
+			void set_num_threads(size_t num_threads);
+			size_t get_num_threads() const;
 
 			void set_sleep_time(DWORD ms_sleep_time);
 			DWORD get_sleep_time();
 
+			/* has to be set before starting - every worker gets pinned to one core of the set */
+			void set_thread_attributes(const Net::Thread::Attributes_t& attributes);
+
 			void set_sleep_function(void (*fncSleep)(DWORD time));
 			void* get_sleep_function();
+			void sleep();
 
-			void set_max_peers(size_t max_peers);
-			size_t get_max_peers();
+			/* worker side */
+			bool pop(peer_threadpool_t* pool, peerInfo_t& info);
+			void push(peer_threadpool_t* pool, const peerInfo_t& info);
+			void release(peer_threadpool_t* pool);
+			void admit(peer_threadpool_t* pool);
+			void steal(peer_threadpool_t* pool);
 
 			void add(peerInfo_t);
 			void add(peerInfo_t*);
@@ -110,5 +161,4 @@ namespace Net
 			size_t count_pools();
 		};
 	}
-}
-NET_DSA_END
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Net
+{
+	namespace Queue
+	{
+		/*
+		* bounded lock-free queue, any thread is allowed to push while only a single thread pops
+		* based on Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence number
+		* telling producers and the consumer whose turn it is, soo producers only contend on one counter
+		*/
+		template <typename T, size_t N>
+		class MPSC_t
+		{
+			static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity has to be a power of two");
+
+			struct cell_t
+			{
+				std::atomic<size_t> sequence;
+				T data;
+			};
+
+			cell_t cells[N];
+
+			/* producers and the consumer don't share a cache line */
+			std::atomic<size_t> enqueue_pos;
+			char pad[64 - sizeof(std::atomic<size_t>)];
+			std::atomic<size_t> dequeue_pos;
+
+		public:
+			MPSC_t()
+			{
+				for (size_t i = 0; i < N; ++i)
+					cells[i].sequence.store(i, std::memory_order_relaxed);
+
+				enqueue_pos.store(0, std::memory_order_relaxed);
+				dequeue_pos.store(0, std::memory_order_relaxed);
+			}
+
+			MPSC_t(const MPSC_t&) = delete;
+			MPSC_t& operator=(const MPSC_t&) = delete;
+
+			/* returns false if the queue is full */
+			bool push(const T& data)
+			{
+				auto pos = enqueue_pos.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					auto& cell = cells[pos & (N - 1)];
+					const auto sequence = cell.sequence.load(std::memory_order_acquire);
+					const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+					if (diff == 0)
+					{
+						// claim the cell, a failed exchange reloads pos
+						if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							cell.data = data;
+							cell.sequence.store(pos + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if (diff < 0)
+					{
+						// the consumer did not release this cell yet
+						return false;
+					}
+					else
+					{
+						pos = enqueue_pos.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			/* consumer only, returns false if the queue is empty */
+			bool pop(T& data)
+			{
+				const auto pos = dequeue_pos.load(std::memory_order_relaxed);
+				auto& cell = cells[pos & (N - 1)];
+				const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+				// the producer did not finish writing this cell yet
+				if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0)
+					return false;
+
+				data = cell.data;
+				cell.sequence.store(pos + N, std::memory_order_release);
+				dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+				return true;
+			}
+
+			/* cheap check without touching any cell, might be outdated as soon as it returns */
+			bool empty() const
+			{
+				return enqueue_pos.load(std::memory_order_relaxed) == dequeue_pos.load(std::memory_order_relaxed);
+			}
+		};
+	}
+}
@@ -0,0 +1,76 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <Net/Net/NetRateLimit.h>
+
+Net::RateLimit::Bucket_t::Bucket_t()
+{
+	tokens = 0;
+	rate = 0;
+	burst = 0;
+	last = std::chrono::steady_clock::now();
+}
+
+void Net::RateLimit::Bucket_t::refill()
+{
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration<double>(now - last).count();
+	last = now;
+
+	tokens += elapsed * rate;
+	if (tokens > burst)
+		tokens = burst;
+}
+
+void Net::RateLimit::Bucket_t::set(const double rate, const double burst)
+{
+	this->rate = rate;
+	this->burst = burst < 1 ? 1 : burst;
+
+	// a new peer starts with a full bucket
+	tokens = this->burst;
+	last = std::chrono::steady_clock::now();
+}
+
+bool Net::RateLimit::Bucket_t::enabled() const
+{
+	return rate > 0;
+}
+
+bool Net::RateLimit::Bucket_t::allow(const double amount)
+{
+	if (!enabled())
+		return true;
+
+	refill();
+	return tokens >= amount || tokens >= burst;
+}
+
+void Net::RateLimit::Bucket_t::take(const double amount)
+{
+	if (!enabled())
+		return;
+
+	tokens -= amount;
+}
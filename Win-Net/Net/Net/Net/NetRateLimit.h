@@ -0,0 +1,80 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include <Net/Net/Net.h>
+#include <chrono>
+#include <atomic>
+
+namespace Net
+{
+	namespace RateLimit
+	{
+		/*
+		* token bucket refilled with rate tokens per second, holding at most burst tokens
+		* not thread safe, it belongs to the thread receiving from the peer
+		*/
+		class Bucket_t
+		{
+			double tokens;
+			double rate;
+			double burst;
+			std::chrono::steady_clock::time_point last;
+
+			void refill();
+
+		public:
+			Bucket_t();
+
+			/* rate 0 disables the bucket */
+			void set(double rate, double burst);
+			bool enabled() const;
+
+			/*
+			* checks if the amount can be taken without taking it
+			* an amount bigger than the burst passes once the bucket is full, the debt has to be refilled afterwards
+			*/
+			bool allow(double amount);
+			void take(double amount);
+		};
+
+		struct Counters_t
+		{
+			std::atomic<size_t> dropped;
+			std::atomic<size_t> delayed;
+			std::atomic<size_t> disconnected;
+			std::atomic<size_t> rejected;
+			std::atomic<size_t> filtered;
+
+			Counters_t()
+			{
+				dropped = 0;
+				delayed = 0;
+				disconnected = 0;
+				rejected = 0;
+				filtered = 0;
+			}
+		};
+	}
+}
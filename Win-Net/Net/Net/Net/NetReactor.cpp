@@ -0,0 +1,649 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <Net/Net/NetReactor.h>
+#include <Net/assets/manager/logmanager.h>
+
+#ifdef BUILD_LINUX
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <algorithm>
+#include <chrono>
+
+/* user_data tags of completions that do not belong to an entry */
+#define REACTOR_URING_WAKE 1
+#define REACTOR_URING_CANCEL 2
+
+Net::Reactor::Reactor_t::Reactor_t()
+{
+	running = false;
+	running_workers = 0;
+	ms_tick_time = 100;
+	uring = false;
+	thread_attributes.set_name(CSTRING("net-reactor"));
+}
+
+Net::Reactor::Reactor_t::~Reactor_t()
+{
+	stop();
+}
+
+void Net::Reactor::Reactor_t::set_thread_attributes(const Net::Thread::Attributes_t& attributes)
+{
+	this->thread_attributes = attributes;
+}
+
+void Net::Reactor::Reactor_t::set_tick_time(DWORD ms_tick_time)
+{
+	this->ms_tick_time = ms_tick_time;
+}
+
+DWORD Net::Reactor::Reactor_t::get_tick_time() const
+{
+	return this->ms_tick_time;
+}
+
+void Net::Reactor::Reactor_t::set_use_uring(bool uring)
+{
+	this->uring = uring;
+}
+
+bool Net::Reactor::Reactor_t::uses_uring() const
+{
+	return this->uring;
+}
+
+bool Net::Reactor::Reactor_t::is_running() const
+{
+	return running;
+}
+
+void Net::Reactor::Reactor_t::worker_started()
+{
+	running_workers++;
+}
+
+void Net::Reactor::Reactor_t::worker_finished()
+{
+	running_workers--;
+}
+
+struct reactor_worker_data_t
+{
+	Net::Reactor::Reactor_t* pClass;
+	Net::Reactor::reactor_worker_t* worker;
+};
+
+static void reactor_process_entry(Net::Reactor::Reactor_t* pClass, Net::Reactor::reactor_worker_t* worker, Net::Reactor::reactor_entry_t* entry)
+{
+	// Automaticly set to stop if no worker function is set
+	Net::PeerPool::WorkStatus_t ret = Net::PeerPool::WorkStatus_t::STOP;
+
+	auto fncWorkPointer = entry->info.GetWorker();
+	if (fncWorkPointer)
+	{
+		auto fncWork = reinterpret_cast<Net::PeerPool::WorkStatus_t(*)(void* peer)>(fncWorkPointer);
+
+		ret = (*fncWork)(entry->info.GetPeer());
+	}
+
+	if (ret == Net::PeerPool::WorkStatus_t::STOP)
+	{
+		pClass->remove(worker, entry);
+		return;
+	}
+
+	/*
+	* we are edge-triggered, epoll won't notify us again for data that is already pending
+	* soo the entry has to be continued by ourself once the other ready entries had their turn
+	*/
+	if (ret == Net::PeerPool::WorkStatus_t::FORWARD
+		&& std::find(worker->ready.begin(), worker->ready.end(), entry) == worker->ready.end())
+		worker->ready.emplace_back(entry);
+
+	if (ret == Net::PeerPool::WorkStatus_t::WAIT
+		&& std::find(worker->waiting.begin(), worker->waiting.end(), entry) == worker->waiting.end())
+		worker->waiting.emplace_back(entry);
+}
+
+static void reactor_run_epoll(Net::Reactor::Reactor_t* pClass, Net::Reactor::reactor_worker_t* worker)
+{
+	epoll_event events[NET_REACTOR_MAX_EVENTS];
+	auto last_tick = std::chrono::steady_clock::now();
+
+	while (pClass->is_running())
+	{
+		/* the timeout is only used to notice a stop request, don't wait at all while there are entries left to continue */
+		const int num = epoll_wait(worker->epoll_fd, events, NET_REACTOR_MAX_EVENTS, worker->ready.empty() ? static_cast<int>(pClass->get_tick_time()) : 0);
+		if (num == SOCKET_ERROR)
+		{
+			if (errno == EINTR)
+				continue;
+
+			NET_LOG_ERROR(CSTRING("[Reactor] - epoll_wait failed with error: %d"), errno);
+			break;
+		}
+
+		for (int i = 0; i < num; ++i)
+			reactor_process_entry(pClass, worker, (Net::Reactor::reactor_entry_t*)events[i].data.ptr);
+
+		// removing an entry also takes it out of the ready list, soo this only contains alive ones
+		std::vector<Net::Reactor::reactor_entry_t*> ready;
+		ready.swap(worker->ready);
+
+		for (const auto entry : ready)
+			reactor_process_entry(pClass, worker, entry);
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now - last_tick >= std::chrono::milliseconds(pClass->get_tick_time()))
+		{
+			last_tick = now;
+
+			std::vector<Net::Reactor::reactor_entry_t*> waiting;
+			waiting.swap(worker->waiting);
+
+			for (const auto entry : waiting)
+				reactor_process_entry(pClass, worker, entry);
+		}
+	}
+}
+
+static bool reactor_uring_arm(Net::Reactor::reactor_worker_t* worker, Net::Reactor::reactor_entry_t* entry)
+{
+	const auto user_data = (uint64)entry;
+	entry->armed = entry->listener ? worker->ring->accept_multishot(entry->fd, user_data) : worker->ring->recv_multishot(entry->fd, user_data);
+	return entry->armed;
+}
+
+static void reactor_uring_rearm(Net::Reactor::reactor_worker_t* worker, Net::Reactor::reactor_entry_t* entry)
+{
+	const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+	worker->pending.emplace_back(entry);
+}
+
+static void reactor_uring_complete(Net::Reactor::Reactor_t* pClass, Net::Reactor::reactor_worker_t* worker, Net::Reactor::reactor_entry_t* entry, const int res, const unsigned flags)
+{
+	const auto ring = worker->ring;
+
+	// a multishot request stays active as long as the kernel tells us there is more to come
+	if (!(flags & IORING_CQE_F_MORE))
+		entry->armed = false;
+
+	byte* data = nullptr;
+	unsigned short bid = 0;
+	if (flags & IORING_CQE_F_BUFFER)
+	{
+		bid = static_cast<unsigned short>(flags >> IORING_CQE_BUFFER_SHIFT);
+		data = ring->buffer(bid);
+	}
+
+	if (entry->closing)
+	{
+		if (data)
+			ring->recycle_buffer(bid);
+
+		// last completion of a removed entry
+		if (!entry->armed)
+		{
+			auto& closing = worker->closing;
+			closing.erase(std::remove(closing.begin(), closing.end(), entry), closing.end());
+			delete entry;
+		}
+
+		return;
+	}
+
+	// ran out of provided buffers, arm it again once they got recycled
+	if (res == -ENOBUFS)
+	{
+		if (!entry->armed)
+			reactor_uring_rearm(worker, entry);
+
+		return;
+	}
+
+	// Automaticly set to stop if no receive callback is set
+	Net::PeerPool::WorkStatus_t ret = Net::PeerPool::WorkStatus_t::STOP;
+
+	auto fncReceivePointer = entry->info.GetCallbackOnReceive();
+	if (fncReceivePointer)
+	{
+		auto fncReceive = reinterpret_cast<Net::PeerPool::WorkStatus_t(*)(void* peer, byte* data, int64 size)>(fncReceivePointer);
+		ret = (*fncReceive)(entry->info.GetPeer(), data, res);
+	}
+
+	if (data)
+		ring->recycle_buffer(bid);
+
+	if (ret == Net::PeerPool::WorkStatus_t::STOP)
+	{
+		pClass->remove(worker, entry);
+		return;
+	}
+
+	if (!entry->armed)
+		reactor_uring_rearm(worker, entry);
+}
+
+static void reactor_uring_tick(Net::Reactor::Reactor_t* pClass, Net::Reactor::reactor_worker_t* worker)
+{
+	std::vector<Net::Reactor::reactor_entry_t*> entries;
+	{
+		const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+		entries = worker->entries;
+	}
+
+	for (const auto entry : entries)
+	{
+		// listeners only work on completions
+		if (entry->listener)
+			continue;
+
+		// Automaticly set to stop if no worker function is set
+		Net::PeerPool::WorkStatus_t ret = Net::PeerPool::WorkStatus_t::STOP;
+
+		auto fncWorkPointer = entry->info.GetWorker();
+		if (fncWorkPointer)
+		{
+			auto fncWork = reinterpret_cast<Net::PeerPool::WorkStatus_t(*)(void* peer)>(fncWorkPointer);
+			ret = (*fncWork)(entry->info.GetPeer());
+		}
+
+		if (ret == Net::PeerPool::WorkStatus_t::STOP)
+			pClass->remove(worker, entry);
+	}
+}
+
+static void reactor_run_uring(Net::Reactor::Reactor_t* pClass, Net::Reactor::reactor_worker_t* worker)
+{
+	const auto ring = worker->ring;
+
+	// other threads write to the eventfd after handing us a new entry
+	ring->read(worker->wake_fd, &worker->wake_value, sizeof(worker->wake_value), REACTOR_URING_WAKE);
+
+	auto last_tick = std::chrono::steady_clock::now();
+
+	while (pClass->is_running())
+	{
+		{
+			// arm everything that got added or lost its multishot request, failed ones are retried on the next iteration
+			const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+			for (auto it = worker->pending.begin(); it != worker->pending.end();)
+			{
+				if (reactor_uring_arm(worker, *it))
+					it = worker->pending.erase(it);
+				else
+					++it;
+			}
+		}
+
+		/* the timeout is used to notice a stop request and to tick the peers */
+		const int res = ring->submit(1, pClass->get_tick_time());
+		if (res < 0 && res != -EBUSY && res != -EAGAIN)
+		{
+			NET_LOG_ERROR(CSTRING("[Reactor] - io_uring_enter failed with error: %d"), -res);
+			break;
+		}
+
+		while (const auto cqe = ring->peek())
+		{
+			const auto user_data = cqe->user_data;
+			const auto cqe_res = cqe->res;
+			const auto cqe_flags = cqe->flags;
+			ring->seen();
+
+			if (user_data == REACTOR_URING_WAKE)
+			{
+				ring->read(worker->wake_fd, &worker->wake_value, sizeof(worker->wake_value), REACTOR_URING_WAKE);
+				continue;
+			}
+
+			if (user_data == REACTOR_URING_CANCEL)
+				continue;
+
+			reactor_uring_complete(pClass, worker, (Net::Reactor::reactor_entry_t*)user_data, cqe_res, cqe_flags);
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now - last_tick >= std::chrono::milliseconds(pClass->get_tick_time()))
+		{
+			last_tick = now;
+			reactor_uring_tick(pClass, worker);
+		}
+	}
+}
+
+static void reactor_release(Net::Reactor::reactor_worker_t* worker)
+{
+	if (worker->ring)
+	{
+		// closing the ring cancels every pending request, nothing references the remaining entries anymore
+		worker->ring->close();
+		delete worker->ring;
+		worker->ring = nullptr;
+
+		for (const auto entry : worker->closing)
+			delete entry;
+
+		worker->closing.clear();
+	}
+
+	if (worker->wake_fd != SOCKET_ERROR)
+	{
+		close(worker->wake_fd);
+		worker->wake_fd = SOCKET_ERROR;
+	}
+
+	if (worker->epoll_fd != SOCKET_ERROR)
+	{
+		close(worker->epoll_fd);
+		worker->epoll_fd = SOCKET_ERROR;
+	}
+}
+
+NET_THREAD(reactor_worker)
+{
+	auto data = (reactor_worker_data_t*)parameter;
+	auto pClass = data->pClass;
+	auto worker = data->worker;
+	FREE<reactor_worker_data_t>(data);
+
+	if (worker->ring)
+		reactor_run_uring(pClass, worker);
+	else
+		reactor_run_epoll(pClass, worker);
+
+	// hand all remaining peers over to their delete callback
+	std::vector<Net::Reactor::reactor_entry_t*> entries;
+	{
+		const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+		entries = worker->entries;
+	}
+
+	for (const auto entry : entries)
+		pClass->remove(worker, entry);
+
+	reactor_release(worker);
+
+	pClass->worker_finished();
+	return NULL;
+}
+
+bool Net::Reactor::Reactor_t::start(size_t num_workers)
+{
+	if (is_running())
+		return false;
+
+	if (num_workers == 0)
+		num_workers = std::thread::hardware_concurrency();
+
+	if (num_workers == 0)
+		num_workers = 1;
+
+	if (uring)
+	{
+		// io_uring might be missing or disabled (kernel.io_uring_disabled)
+		Net::Uring::Ring_t probe;
+		if (!probe.init(2) || !probe.setup_buffers(1, 1))
+		{
+			NET_LOG_WARNING(CSTRING("[Reactor] - io_uring is not available, falling back to epoll"));
+			uring = false;
+		}
+	}
+
+	for (size_t i = 0; i < num_workers; ++i)
+	{
+		auto worker = new reactor_worker_t();
+		worker->epoll_fd = SOCKET_ERROR;
+		worker->ring = nullptr;
+		worker->wake_fd = SOCKET_ERROR;
+		worker->wake_value = 0;
+
+		if (uring)
+		{
+			worker->ring = new Net::Uring::Ring_t();
+			worker->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+			if (worker->wake_fd == SOCKET_ERROR || !worker->ring->init() || !worker->ring->setup_buffers())
+			{
+				NET_LOG_ERROR(CSTRING("[Reactor] - unable to setup io_uring worker, error: %d"), errno);
+				reactor_release(worker);
+				delete worker;
+				break;
+			}
+		}
+		else
+		{
+			worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+			if (worker->epoll_fd == SOCKET_ERROR)
+			{
+				NET_LOG_ERROR(CSTRING("[Reactor] - epoll_create1 failed with error: %d"), errno);
+				delete worker;
+				break;
+			}
+		}
+
+		workers.emplace_back(worker);
+	}
+
+	if (workers.empty())
+		return false;
+
+	running = true;
+
+	size_t index = 0;
+	for (const auto worker : workers)
+	{
+		auto data = ALLOC<reactor_worker_data_t>();
+		data->pClass = this;
+		data->worker = worker;
+
+		worker_started();
+		Net::Thread::Create(reactor_worker, (LPVOID)data, thread_attributes.worker(index++));
+	}
+
+	return true;
+}
+
+void Net::Reactor::Reactor_t::stop()
+{
+	running = false;
+
+	// wait for the workers to release their peers
+	while (running_workers > 0)
+		std::this_thread::sleep_for(std::chrono::milliseconds(get_tick_time()));
+
+	for (const auto worker : workers)
+		delete worker;
+
+	workers.clear();
+}
+
+Net::Reactor::reactor_worker_t* Net::Reactor::Reactor_t::get_least_busy_worker()
+{
+	reactor_worker_t* target = nullptr;
+	size_t target_peers = 0;
+
+	for (const auto worker : workers)
+	{
+		const auto peers = count_peers(worker);
+		if (!target || peers < target_peers)
+		{
+			target = worker;
+			target_peers = peers;
+		}
+	}
+
+	return target;
+}
+
+bool Net::Reactor::Reactor_t::add(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker_index)
+{
+	return insert(fd, info, worker_index, false);
+}
+
+bool Net::Reactor::Reactor_t::add_listener(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker_index)
+{
+	return insert(fd, info, worker_index, true);
+}
+
+bool Net::Reactor::Reactor_t::insert(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker_index, bool listener)
+{
+	if (!is_running() || workers.empty())
+		return false;
+
+	// pin to the requested worker, otherwise balance by peer count
+	auto worker = (worker_index != INVALID_SIZE) ? workers[worker_index % workers.size()] : get_least_busy_worker();
+	if (!worker)
+		return false;
+
+	/* edge-triggered notifications require the socket to never block while draining it */
+	const int flags = fcntl(fd, F_GETFL, 0);
+	if (flags == SOCKET_ERROR || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == SOCKET_ERROR)
+	{
+		NET_LOG_ERROR(CSTRING("[Reactor] - unable to set socket into non-blocking mode, error: %d"), errno);
+		return false;
+	}
+
+	auto entry = new reactor_entry_t();
+	entry->fd = fd;
+	entry->info = info;
+	entry->listener = listener;
+	entry->armed = false;
+	entry->closing = false;
+
+	if (worker->ring)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+			entry->index = worker->entries.size();
+			worker->entries.emplace_back(entry);
+			worker->pending.emplace_back(entry);
+		}
+
+		// only the worker is allowed to submit to its ring, wake it up to arm the entry
+		const uint64 value = 1;
+		if (write(worker->wake_fd, &value, sizeof(value)) == SOCKET_ERROR)
+			NET_LOG_ERROR(CSTRING("[Reactor] - unable to wake up worker, error: %d"), errno);
+
+		return true;
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+		entry->index = worker->entries.size();
+		worker->entries.emplace_back(entry);
+	}
+
+	/*
+	* registering the socket will report any data that has been received in the meantime,
+	* soo there is no gap between the accept and the first notification
+	* being edge-triggered EPOLLOUT only fires once a full socket buffer got writable again
+	*/
+	epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	ev.data.ptr = entry;
+	if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == SOCKET_ERROR)
+	{
+		NET_LOG_ERROR(CSTRING("[Reactor] - epoll_ctl failed with error: %d"), errno);
+
+		const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+		worker->entries.back()->index = entry->index;
+		worker->entries[entry->index] = worker->entries.back();
+		worker->entries.pop_back();
+		delete entry;
+		return false;
+	}
+
+	return true;
+}
+
+void Net::Reactor::Reactor_t::remove(reactor_worker_t* worker, reactor_entry_t* entry)
+{
+	if (worker->ring)
+	{
+		// the kernel keeps on completing an armed request until it has been cancelled, keep the entry alive until then
+		if (entry->armed)
+		{
+			entry->closing = true;
+			worker->ring->cancel((uint64)entry, REACTOR_URING_CANCEL);
+		}
+	}
+	else
+	{
+		epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, entry->fd, nullptr);
+	}
+
+	{
+		// swap with the last entry to keep the removal cheap
+		const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+		worker->entries.back()->index = entry->index;
+		worker->entries[entry->index] = worker->entries.back();
+		worker->entries.pop_back();
+
+		auto& pending = worker->pending;
+		pending.erase(std::remove(pending.begin(), pending.end(), entry), pending.end());
+
+		auto& ready = worker->ready;
+		ready.erase(std::remove(ready.begin(), ready.end(), entry), ready.end());
+
+		auto& waiting = worker->waiting;
+		waiting.erase(std::remove(waiting.begin(), waiting.end(), entry), waiting.end());
+
+		if (entry->closing)
+			worker->closing.emplace_back(entry);
+	}
+
+	auto fncCallbackOnDeletePointer = entry->info.GetCallbackOnDelete();
+	if (fncCallbackOnDeletePointer)
+	{
+		auto fncCallbackOnDelete = reinterpret_cast<void (*)(void* peer)>(fncCallbackOnDeletePointer);
+		(*fncCallbackOnDelete)(entry->info.GetPeer());
+	}
+
+	if (!entry->closing)
+		delete entry;
+}
+
+size_t Net::Reactor::Reactor_t::count_peers_all()
+{
+	size_t peers = 0;
+	for (const auto worker : workers)
+		peers += count_peers(worker);
+
+	return peers;
+}
+
+size_t Net::Reactor::Reactor_t::count_peers(reactor_worker_t* worker)
+{
+	const std::lock_guard<std::mutex> lock(worker->entries_mutex);
+	return worker->entries.size();
+}
+
+size_t Net::Reactor::Reactor_t::count_workers() const
+{
+	return workers.size();
+}
+#endif
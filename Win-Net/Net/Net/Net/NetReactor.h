@@ -0,0 +1,140 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#pragma once
+
+/*
+* Linux only: edge-triggered epoll reactor
+* every worker thread owns one epoll instance and only wakes up on socket readiness (readable or writable again),
+* peers are described by the same peerInfo_t that is being used by the peer pool
+*
+* optionally the workers drive an io_uring instead (multishot accept & recv into provided buffers),
+* received data is then handed to the receive callback of the peer and the worker function only gets called every tick
+*/
+#define NET_REACTOR_MAX_EVENTS 128
+
+#include <Net/Net/Net.h>
+#include <Net/Net/NetPeerPool.h>
+#include <Net/Net/NetUring.h>
+#include <Net/assets/thread.h>
+#include <mutex>
+#include <atomic>
+
+#ifdef BUILD_LINUX
+#include <sys/epoll.h>
+
+namespace Net
+{
+	namespace Reactor
+	{
+		struct reactor_entry_t
+		{
+			SOCKET fd;
+			Net::PeerPool::peerInfo_t info;
+
+			/* position inside of the owning worker's entry vector */
+			size_t index;
+
+			/* io_uring only */
+			bool listener;
+			bool armed;
+			bool closing;
+		};
+
+		struct reactor_worker_t
+		{
+			int epoll_fd;
+
+			std::vector<reactor_entry_t*> entries;
+			std::mutex entries_mutex;
+
+			/* epoll only: entries that stopped before being drained, they continue after the next wait */
+			std::vector<reactor_entry_t*> ready;
+
+			/* epoll only: entries that want to be visited on the next tick without having received anything */
+			std::vector<reactor_entry_t*> waiting;
+
+			/* io_uring only */
+			Net::Uring::Ring_t* ring;
+			int wake_fd;
+			uint64 wake_value;
+
+			/* added by other threads, the worker arms them on its next iteration */
+			std::vector<reactor_entry_t*> pending;
+
+			/* removed entries waiting for their last completion */
+			std::vector<reactor_entry_t*> closing;
+		};
+
+		class Reactor_t
+		{
+			std::vector<reactor_worker_t*> workers;
+
+			std::atomic<bool> running;
+			std::atomic<size_t> running_workers;
+
+			DWORD ms_tick_time;
+
+			bool uring;
+
+			Net::Thread::Attributes_t thread_attributes;
+
+			reactor_worker_t* get_least_busy_worker();
+			bool insert(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker, bool listener);
+
+		public:
+			Reactor_t();
+			~Reactor_t();
+
+			bool start(size_t num_workers);
+			void stop();
+
+			bool is_running() const;
+			void worker_started();
+			void worker_finished();
+
+			void set_tick_time(DWORD ms_tick_time);
+			DWORD get_tick_time() const;
+
+			/* has to be set before starting - every worker gets pinned to one core of the set */
+			void set_thread_attributes(const Net::Thread::Attributes_t& attributes);
+
+			/* has to be set before starting, falls back to epoll if the kernel does not support it */
+			void set_use_uring(bool uring);
+			bool uses_uring() const;
+
+			bool add(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker = INVALID_SIZE);
+
+			/* epoll: same as add, io_uring: the receive callback gets called with the accepted socket as size */
+			bool add_listener(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker = INVALID_SIZE);
+			void remove(reactor_worker_t* worker, reactor_entry_t* entry);
+
+			size_t count_peers_all();
+			size_t count_peers(reactor_worker_t* worker);
+			size_t count_workers() const;
+		};
+	}
+}
+#endif
@@ -0,0 +1,184 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <Net/Net/NetRegistry.h>
+#include <algorithm>
+
+bool Net::Registry::dense_set_t::insert(const NET_UID uid, void* peer)
+{
+	if (index.find(uid) != index.end())
+		return false;
+
+	index.emplace(uid, peers.size());
+	peers.emplace_back(peer);
+	uids.emplace_back(uid);
+	return true;
+}
+
+bool Net::Registry::dense_set_t::erase(const NET_UID uid)
+{
+	const auto it = index.find(uid);
+	if (it == index.end())
+		return false;
+
+	const auto pos = it->second;
+	index.erase(it);
+
+	// move the last entry into the gap
+	const auto last = peers.size() - 1;
+	if (pos != last)
+	{
+		peers[pos] = peers[last];
+		uids[pos] = uids[last];
+		index[uids[pos]] = pos;
+	}
+
+	peers.pop_back();
+	uids.pop_back();
+	return true;
+}
+
+void* Net::Registry::dense_set_t::find(const NET_UID uid) const
+{
+	const auto it = index.find(uid);
+	return it == index.end() ? nullptr : peers[it->second];
+}
+
+bool Net::Registry::dense_set_t::contains(const NET_UID uid) const
+{
+	return index.find(uid) != index.end();
+}
+
+size_t Net::Registry::dense_set_t::size() const
+{
+	return peers.size();
+}
+
+bool Net::Registry::dense_set_t::empty() const
+{
+	return peers.empty();
+}
+
+void* const* Net::Registry::dense_set_t::data() const
+{
+	return peers.data();
+}
+
+bool Net::Registry::Registry_t::add(const NET_UID uid, void* peer)
+{
+	if (!peer || uid == INVALID_UID)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return peers.insert(uid, peer);
+}
+
+bool Net::Registry::Registry_t::remove(const NET_UID uid)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!peers.erase(uid))
+		return false;
+
+	const auto it = memberships.find(uid);
+	if (it == memberships.end())
+		return true;
+
+	for (const auto& name : it->second)
+	{
+		const auto group = groups.find(name);
+		if (group == groups.end())
+			continue;
+
+		group->second.erase(uid);
+		if (group->second.empty())
+			groups.erase(group);
+	}
+
+	memberships.erase(it);
+	return true;
+}
+
+void* Net::Registry::Registry_t::find(const NET_UID uid) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return peers.find(uid);
+}
+
+size_t Net::Registry::Registry_t::count() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return peers.size();
+}
+
+bool Net::Registry::Registry_t::join(const char* group, const NET_UID uid)
+{
+	if (!group)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const auto peer = peers.find(uid);
+	if (!peer)
+		return false;
+
+	if (!groups[group].insert(uid, peer))
+		return false;
+
+	memberships[uid].emplace_back(group);
+	return true;
+}
+
+bool Net::Registry::Registry_t::leave(const char* group, const NET_UID uid)
+{
+	if (!group)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const auto it = groups.find(group);
+	if (it == groups.end() || !it->second.erase(uid))
+		return false;
+
+	// nobody is left in the room
+	if (it->second.empty())
+		groups.erase(it);
+
+	auto& joined = memberships[uid];
+	joined.erase(std::find(joined.begin(), joined.end(), std::string(group)));
+	if (joined.empty())
+		memberships.erase(uid);
+
+	return true;
+}
+
+size_t Net::Registry::Registry_t::count(const char* group) const
+{
+	if (!group)
+		return 0;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const auto it = groups.find(group);
+	return it == groups.end() ? 0 : it->second.size();
+}
@@ -0,0 +1,120 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+
+/*
+* peers keyed by their unique id, lookups are O(1) and enumerating walks a dense array
+* peers can be members of named groups (rooms), a group is a dense array as well
+*/
+#include <Net/Net/Net.h>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace Net
+{
+	namespace Registry
+	{
+		/* removing swaps the last entry into the gap, soo the array never has holes */
+		class dense_set_t
+		{
+			std::vector<void*> peers;
+			std::vector<NET_UID> uids;
+			std::unordered_map<NET_UID, size_t> index;
+
+		public:
+			bool insert(NET_UID uid, void* peer);
+			bool erase(NET_UID uid);
+			void* find(NET_UID uid) const;
+			bool contains(NET_UID uid) const;
+			size_t size() const;
+			bool empty() const;
+
+			void* const* data() const;
+		};
+
+		class Registry_t
+		{
+			mutable std::mutex mutex;
+
+			dense_set_t peers;
+			std::unordered_map<std::string, dense_set_t> groups;
+
+			/* the groups a peer joined, soo removing it does not have to visit every group */
+			std::unordered_map<NET_UID, std::vector<std::string>> memberships;
+
+		public:
+			bool add(NET_UID uid, void* peer);
+
+			/* also leaves all groups of the peer */
+			bool remove(NET_UID uid);
+
+			void* find(NET_UID uid) const;
+			size_t count() const;
+
+			bool join(const char* group, NET_UID uid);
+			bool leave(const char* group, NET_UID uid);
+			size_t count(const char* group) const;
+
+			/*
+			* calls fnc for every peer (of the group) while holding the lock, returns the amount of calls
+			* peers stay registered until it returns, fnc must not add, remove, join or leave
+			*/
+			template <typename F>
+			size_t for_each(F fnc) const
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				return visit(peers, fnc);
+			}
+
+			template <typename F>
+			size_t for_each(const char* group, F fnc) const
+			{
+				if (!group) return 0;
+
+				std::lock_guard<std::mutex> lock(mutex);
+
+				const auto it = groups.find(group);
+				if (it == groups.end())
+					return 0;
+
+				return visit(it->second, fnc);
+			}
+
+		private:
+			template <typename F>
+			static size_t visit(const dense_set_t& set, F& fnc)
+			{
+				const auto size = set.size();
+				const auto data = set.data();
+				for (size_t i = 0; i < size; ++i)
+					fnc(data[i]);
+
+				return size;
+			}
+		};
+	}
+}
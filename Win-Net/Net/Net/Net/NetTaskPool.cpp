@@ -0,0 +1,315 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+#include <Net/Net/NetTaskPool.h>
+#include <Net/assets/manager/logmanager.h>
+#include <algorithm>
+
+Net::TaskPool::TaskPool_t::TaskPool_t()
+{
+	running = false;
+	running_threads = 0;
+	num_threads = 0;
+	max_depth = 0;
+	lane_burst = NET_OPT_DEFAULT_LANE_BURST;
+	scheduler.set_limit(lane_burst);
+	_depth = 0;
+	_peak_depth = 0;
+	_throttled = 0;
+	thread_attributes.set_name(CSTRING("net-task"));
+}
+
+Net::TaskPool::TaskPool_t::~TaskPool_t()
+{
+	stop();
+}
+
+NET_THREAD(taskpool_worker)
+{
+	const auto pClass = (Net::TaskPool::TaskPool_t*)parameter;
+	if (!pClass) return 0;
+
+	pClass->work();
+	return 0;
+}
+
+bool Net::TaskPool::TaskPool_t::has_ready() const
+{
+	for (const auto& queue : ready)
+		if (!queue.empty()) return true;
+
+	return false;
+}
+
+/* queues the strand behind the others waiting for its highest pending lane */
+void Net::TaskPool::TaskPool_t::schedule(strand_t* strand)
+{
+	for (int i = 0; i < NET_LANES; ++i)
+	{
+		if (strand->tasks[i].empty()) continue;
+
+		strand->queued = i;
+		ready[i].push_back(strand);
+		cv_work.notify_one();
+		return;
+	}
+}
+
+void Net::TaskPool::TaskPool_t::work()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		cv_work.wait(lock, [this] { return has_ready() || !running; });
+
+		// finish the remaining work before leaving
+		if (!has_ready())
+			break;
+
+		auto& queue = ready[scheduler.next(ready)];
+		auto strand = queue.front();
+		queue.pop_front();
+		strand->queued = -1;
+
+		auto& tasks = strand->tasks[strand->scheduler.next(strand->tasks)];
+		const auto task = tasks.front();
+		tasks.pop_front();
+
+		lock.unlock();
+		(*task.fnc)(task.param);
+		lock.lock();
+
+		_depth--;
+		strand->depth--;
+
+		// one task per turn, soo a busy key can not starve the others
+		bool empty = true;
+		for (const auto& pending : strand->tasks)
+			if (!pending.empty()) empty = false;
+
+		if (empty)
+		{
+			strands.erase(strand->key);
+			delete strand;
+		}
+		else
+		{
+			schedule(strand);
+		}
+
+		cv_done.notify_all();
+	}
+
+	running_threads--;
+	cv_done.notify_all();
+}
+
+bool Net::TaskPool::TaskPool_t::start()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (running || running_threads > 0)
+		return false;
+
+	auto threads = num_threads;
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+
+	if (threads == 0)
+		threads = 1;
+
+	running = true;
+
+	for (size_t i = 0; i < threads; ++i)
+	{
+		if (!Net::Thread::Create(taskpool_worker, (LPVOID)this, thread_attributes.worker(i, false)))
+		{
+			NET_LOG_ERROR(CSTRING("[Net::TaskPool] - failed to create worker thread"));
+			continue;
+		}
+
+		running_threads++;
+	}
+
+	if (running_threads == 0)
+	{
+		running = false;
+		return false;
+	}
+
+	return true;
+}
+
+void Net::TaskPool::TaskPool_t::stop()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	running = false;
+	cv_work.notify_all();
+	cv_done.notify_all();
+
+	// wait for the workers to execute the remaining tasks
+	cv_done.wait(lock, [this] { return running_threads == 0; });
+}
+
+bool Net::TaskPool::TaskPool_t::is_running()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return running;
+}
+
+void Net::TaskPool::TaskPool_t::set_num_threads(size_t num_threads)
+{
+	this->num_threads = num_threads;
+}
+
+size_t Net::TaskPool::TaskPool_t::get_num_threads() const
+{
+	return this->num_threads;
+}
+
+void Net::TaskPool::TaskPool_t::set_thread_attributes(const Net::Thread::Attributes_t& attributes)
+{
+	this->thread_attributes = attributes;
+}
+
+void Net::TaskPool::TaskPool_t::set_max_depth(size_t max_depth)
+{
+	this->max_depth = max_depth;
+}
+
+size_t Net::TaskPool::TaskPool_t::get_max_depth() const
+{
+	return this->max_depth;
+}
+
+void Net::TaskPool::TaskPool_t::set_lane_burst(size_t lane_burst)
+{
+	this->lane_burst = lane_burst;
+	scheduler.set_limit(lane_burst);
+}
+
+size_t Net::TaskPool::TaskPool_t::get_lane_burst() const
+{
+	return this->lane_burst;
+}
+
+bool Net::TaskPool::TaskPool_t::post(void* key, void (*fnc)(void* param), void* param, Net::Lane::Lane_t lane)
+{
+	if (!fnc)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!running)
+		return false;
+
+	task_t task;
+	task.fnc = fnc;
+	task.param = param;
+
+	const auto index = static_cast<int>(lane);
+
+	strand_t* strand = nullptr;
+
+	auto it = strands.find(key);
+	if (it == strands.end())
+	{
+		strand = new strand_t();
+		strand->key = key;
+		strand->depth = 0;
+		strand->scheduler.set_limit(lane_burst);
+		strand->tasks[index].emplace_back(task);
+		strands.emplace(key, strand);
+
+		schedule(strand);
+	}
+	else
+	{
+		// the strand is already scheduled, the worker picks the task up after the previous ones of its lane
+		strand = it->second;
+		strand->tasks[index].emplace_back(task);
+
+		// a waiting strand moves up to the queue of the higher lane
+		if (strand->queued > index)
+		{
+			auto& queue = ready[strand->queued];
+			queue.erase(std::find(queue.begin(), queue.end(), strand));
+			schedule(strand);
+		}
+	}
+
+	// the task is queued anyway, the producer of the key finds out using full
+	if (++strand->depth == max_depth)
+		_throttled++;
+
+	const auto depth = ++_depth;
+	if (depth > _peak_depth)
+		_peak_depth = depth;
+
+	return true;
+}
+
+bool Net::TaskPool::TaskPool_t::full(void* key)
+{
+	if (max_depth == 0)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto it = strands.find(key);
+	return it != strands.end() && it->second->depth >= max_depth;
+}
+
+void Net::TaskPool::TaskPool_t::throttle(void* key)
+{
+	if (max_depth == 0)
+		return;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	cv_done.wait(lock, [this, key]
+		{
+			if (!running)
+				return true;
+
+			const auto it = strands.find(key);
+			return it == strands.end() || it->second->depth < max_depth;
+		});
+}
+
+void Net::TaskPool::TaskPool_t::wait(void* key)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	cv_done.wait(lock, [this, key] { return strands.find(key) == strands.end(); });
+}
+
+size_t Net::TaskPool::TaskPool_t::depth() const
+{
+	return _depth;
+}
+
+size_t Net::TaskPool::TaskPool_t::peak_depth() const
+{
+	return _peak_depth;
+}
+
+size_t Net::TaskPool::TaskPool_t::throttled() const
+{
+	return _throttled;
+}
@@ -0,0 +1,140 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+#pragma once
+
+/*
+* fixed set of worker threads executing tasks that are posted on a key (strand)
+* tasks of the same key run one after another in the order they have been posted,
+* tasks of different keys run in parallel
+* every task belongs to a lane, higher lanes pass the queued tasks of lower lanes (the order is kept within a lane)
+*/
+#include <Net/Net/Net.h>
+#include <Net/Net/NetLane.h>
+#include <Net/assets/thread.h>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <atomic>
+
+namespace Net
+{
+	namespace TaskPool
+	{
+		struct task_t
+		{
+			void (*fnc)(void* param);
+			void* param;
+		};
+
+		/* pending tasks of one key, a strand is either waiting inside of a ready queue or being executed by exactly one worker */
+		struct strand_t
+		{
+			void* key;
+			std::deque<task_t> tasks[NET_LANES];
+			Net::Lane::Scheduler_t scheduler;
+
+			/* the ready queue it is waiting in, -1 while it is being executed */
+			int queued;
+
+			/* pending tasks including the one being executed */
+			size_t depth;
+		};
+
+		class TaskPool_t
+		{
+			std::mutex mutex;
+			std::condition_variable cv_work;
+			std::condition_variable cv_done;
+
+			std::unordered_map<void*, strand_t*> strands;
+
+			/* strands are waiting in the queue of their highest pending lane */
+			std::deque<strand_t*> ready[NET_LANES];
+			Net::Lane::Scheduler_t scheduler;
+			size_t lane_burst;
+
+			bool has_ready() const;
+			void schedule(strand_t* strand);
+
+			bool running;
+			size_t running_threads;
+
+			size_t num_threads;
+			size_t max_depth;
+
+			std::atomic<size_t> _depth;
+			std::atomic<size_t> _peak_depth;
+			std::atomic<size_t> _throttled;
+
+			Net::Thread::Attributes_t thread_attributes;
+
+		public:
+			TaskPool_t();
+			~TaskPool_t();
+
+			bool start();
+
+			/* executes all queued tasks before returning */
+			void stop();
+
+			bool is_running();
+
+			/* has to be set before starting - 0 will use one thread per core */
+			void set_num_threads(size_t num_threads);
+			size_t get_num_threads() const;
+
+			/* has to be set before starting - the workers are not pinned, they share the cores of the set */
+			void set_thread_attributes(const Net::Thread::Attributes_t& attributes);
+
+			/* maximum of queued tasks per key, posting never blocks - the producer of a full key has to stop on its own (see full) */
+			void set_max_depth(size_t max_depth);
+			size_t get_max_depth() const;
+
+			/* has to be set before starting - see Net::Lane::Scheduler_t */
+			void set_lane_burst(size_t lane_burst);
+			size_t get_lane_burst() const;
+
+			/* returns false if the pool is not running, the caller has to execute the task on its own */
+			bool post(void* key, void (*fnc)(void* param), void* param, Net::Lane::Lane_t lane = Net::Lane::Lane_t::BULK);
+
+			/* the key reached the maximum of queued tasks, its producer should stop until it dropped below again */
+			bool full(void* key);
+
+			/* blocks as long as the key is full, only for producers serving nothing but this key - e.g. a thread per connection */
+			void throttle(void* key);
+
+			/* blocks until all tasks of the key have been executed, never call it from a task of the same key */
+			void wait(void* key);
+
+			/* worker side */
+			void work();
+
+			/* metrics */
+			size_t depth() const;
+			size_t peak_depth() const;
+			size_t throttled() const;
+		};
+	}
+}
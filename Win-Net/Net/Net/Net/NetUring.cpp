@@ -0,0 +1,424 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <Net/Net/NetUring.h>
+#include <Net/assets/manager/logmanager.h>
+
+#ifdef BUILD_LINUX
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+static int uring_setup(unsigned entries, io_uring_params* p)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void* arg, size_t argsz)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz));
+}
+
+/* user_data of operations that only the ring itself cares about */
+#define NET_URING_INTERNAL 0
+
+Net::Uring::Ring_t::Ring_t()
+{
+	ring_fd = SOCKET_ERROR;
+
+	sq_ptr = nullptr;
+	sq_ptr_size = 0;
+	sq_head = nullptr;
+	sq_tail = nullptr;
+	sq_mask = nullptr;
+	sq_array = nullptr;
+	sqes = nullptr;
+	sqes_size = 0;
+	sqe_tail = 0;
+
+	cq_ptr = nullptr;
+	cq_ptr_size = 0;
+	cq_head = nullptr;
+	cq_tail = nullptr;
+	cq_mask = nullptr;
+	cqes = nullptr;
+
+	buffers = nullptr;
+	buf_count = 0;
+	buf_size = 0;
+	buf_group = 0;
+}
+
+Net::Uring::Ring_t::~Ring_t()
+{
+	close();
+}
+
+bool Net::Uring::Ring_t::init(const unsigned entries)
+{
+	if (valid())
+		return false;
+
+	// deferring the completion work to our next syscall saves an interrupt per completion
+	io_uring_params p = {};
+	p.flags = IORING_SETUP_COOP_TASKRUN;
+	ring_fd = uring_setup(entries, &p);
+	if (ring_fd == SOCKET_ERROR && errno == EINVAL)
+	{
+		// older kernel
+		p = {};
+		ring_fd = uring_setup(entries, &p);
+	}
+
+	if (ring_fd == SOCKET_ERROR)
+	{
+		NET_LOG_ERROR(CSTRING("[Uring] - io_uring_setup failed with error: %d"), errno);
+		return false;
+	}
+
+	sq_ptr_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	cq_ptr_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+	// both rings share one mapping on newer kernels
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (cq_ptr_size > sq_ptr_size)
+			sq_ptr_size = cq_ptr_size;
+
+		cq_ptr_size = sq_ptr_size;
+	}
+
+	sq_ptr = mmap(nullptr, sq_ptr_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	if (sq_ptr == MAP_FAILED)
+	{
+		sq_ptr = nullptr;
+		NET_LOG_ERROR(CSTRING("[Uring] - unable to map the submission queue, error: %d"), errno);
+		close();
+		return false;
+	}
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		cq_ptr = sq_ptr;
+	}
+	else
+	{
+		cq_ptr = mmap(nullptr, cq_ptr_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+		if (cq_ptr == MAP_FAILED)
+		{
+			cq_ptr = nullptr;
+			NET_LOG_ERROR(CSTRING("[Uring] - unable to map the completion queue, error: %d"), errno);
+			close();
+			return false;
+		}
+	}
+
+	sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+	sqes = (io_uring_sqe*)mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED)
+	{
+		sqes = nullptr;
+		NET_LOG_ERROR(CSTRING("[Uring] - unable to map the submission entries, error: %d"), errno);
+		close();
+		return false;
+	}
+
+	sq_head = (unsigned*)((byte*)sq_ptr + p.sq_off.head);
+	sq_tail = (unsigned*)((byte*)sq_ptr + p.sq_off.tail);
+	sq_mask = (unsigned*)((byte*)sq_ptr + p.sq_off.ring_mask);
+	sq_array = (unsigned*)((byte*)sq_ptr + p.sq_off.array);
+
+	cq_head = (unsigned*)((byte*)cq_ptr + p.cq_off.head);
+	cq_tail = (unsigned*)((byte*)cq_ptr + p.cq_off.tail);
+	cq_mask = (unsigned*)((byte*)cq_ptr + p.cq_off.ring_mask);
+	cqes = (io_uring_cqe*)((byte*)cq_ptr + p.cq_off.cqes);
+
+	// every slot of the submission array points to the entry with the same index
+	for (unsigned i = 0; i < p.sq_entries; ++i)
+		sq_array[i] = i;
+
+	sqe_tail = *sq_tail;
+	return true;
+}
+
+void Net::Uring::Ring_t::close()
+{
+	if (buffers)
+	{
+		FREE<byte>(buffers);
+		buffers = nullptr;
+	}
+
+	if (sqes)
+	{
+		munmap(sqes, sqes_size);
+		sqes = nullptr;
+	}
+
+	if (cq_ptr && cq_ptr != sq_ptr)
+		munmap(cq_ptr, cq_ptr_size);
+
+	cq_ptr = nullptr;
+
+	if (sq_ptr)
+	{
+		munmap(sq_ptr, sq_ptr_size);
+		sq_ptr = nullptr;
+	}
+
+	// closing the ring cancels every request that is still pending
+	if (ring_fd != SOCKET_ERROR)
+	{
+		::close(ring_fd);
+		ring_fd = SOCKET_ERROR;
+	}
+}
+
+bool Net::Uring::Ring_t::valid() const
+{
+	return ring_fd != SOCKET_ERROR;
+}
+
+bool Net::Uring::Ring_t::setup_buffers(const unsigned count, const unsigned size, const unsigned short group)
+{
+	if (!valid() || buffers)
+		return false;
+
+	buffers = ALLOC<byte>(static_cast<size_t>(count) * size);
+	buf_count = count;
+	buf_size = size;
+	buf_group = group;
+
+	// hand all buffers over to the kernel, they get numbered starting at zero
+	auto sqe = get_sqe();
+	if (!sqe)
+	{
+		FREE<byte>(buffers);
+		buffers = nullptr;
+		return false;
+	}
+
+	sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+	sqe->fd = static_cast<int>(count);
+	sqe->addr = (uint64)buffers;
+	sqe->len = size;
+	sqe->off = 0;
+	sqe->buf_group = group;
+	sqe->user_data = NET_URING_INTERNAL;
+
+	int res = submit(1);
+	if (res >= 0)
+	{
+		// nothing else has been submitted yet, the first completion is ours
+		const unsigned head = *cq_head;
+		if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+		{
+			res = -ETIME;
+		}
+		else
+		{
+			res = cqes[head & *cq_mask].res;
+			seen();
+		}
+	}
+
+	if (res < 0)
+	{
+		NET_LOG_ERROR(CSTRING("[Uring] - unable to provide buffers, error: %d"), -res);
+		FREE<byte>(buffers);
+		buffers = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+byte* Net::Uring::Ring_t::buffer(const unsigned short bid) const
+{
+	return buffers + static_cast<size_t>(bid) * buf_size;
+}
+
+void Net::Uring::Ring_t::recycle_buffer(const unsigned short bid)
+{
+	// goes out with the next submit
+	auto sqe = get_sqe();
+	if (!sqe)
+	{
+		NET_LOG_ERROR(CSTRING("[Uring] - submission queue is full, lost buffer %d"), static_cast<int>(bid));
+		return;
+	}
+
+	sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+	sqe->fd = 1;
+	sqe->addr = (uint64)buffer(bid);
+	sqe->len = buf_size;
+	sqe->off = bid;
+	sqe->buf_group = buf_group;
+	sqe->user_data = NET_URING_INTERNAL;
+}
+
+io_uring_sqe* Net::Uring::Ring_t::get_sqe()
+{
+	const unsigned entries = *sq_mask + 1;
+	if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= entries)
+	{
+		// make space by handing the queued entries to the kernel
+		submit();
+		if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= entries)
+			return nullptr;
+	}
+
+	auto sqe = &sqes[sqe_tail & *sq_mask];
+	++sqe_tail;
+
+	memset(sqe, 0, sizeof(io_uring_sqe));
+	return sqe;
+}
+
+unsigned Net::Uring::Ring_t::flush_sq()
+{
+	const unsigned to_submit = sqe_tail - *sq_tail;
+	if (to_submit)
+		__atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+
+	return to_submit;
+}
+
+bool Net::Uring::Ring_t::accept_multishot(const SOCKET fd, const uint64 user_data)
+{
+	auto sqe = get_sqe();
+	if (!sqe)
+		return false;
+
+	sqe->opcode = IORING_OP_ACCEPT;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+	sqe->user_data = user_data;
+	return true;
+}
+
+bool Net::Uring::Ring_t::recv_multishot(const SOCKET fd, const uint64 user_data)
+{
+	auto sqe = get_sqe();
+	if (!sqe)
+		return false;
+
+	sqe->opcode = IORING_OP_RECV;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = buf_group;
+	sqe->user_data = user_data;
+	return true;
+}
+
+bool Net::Uring::Ring_t::read(const int fd, void* buffer, const unsigned size, const uint64 user_data)
+{
+	auto sqe = get_sqe();
+	if (!sqe)
+		return false;
+
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = fd;
+	sqe->addr = (uint64)buffer;
+	sqe->len = size;
+	sqe->user_data = user_data;
+	return true;
+}
+
+bool Net::Uring::Ring_t::cancel(const uint64 target, const uint64 user_data)
+{
+	auto sqe = get_sqe();
+	if (!sqe)
+		return false;
+
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = target;
+	sqe->user_data = user_data;
+	return true;
+}
+
+int Net::Uring::Ring_t::submit(const unsigned wait_nr, const DWORD timeout_ms)
+{
+	const unsigned to_submit = flush_sq();
+	if (!to_submit && !wait_nr)
+		return 0;
+
+	unsigned flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+
+	int ret;
+	if (wait_nr && timeout_ms)
+	{
+		__kernel_timespec ts = {};
+		ts.tv_sec = timeout_ms / 1000;
+		ts.tv_nsec = (timeout_ms % 1000) * 1000000;
+
+		io_uring_getevents_arg arg = {};
+		arg.ts = (uint64)&ts;
+
+		ret = uring_enter(ring_fd, to_submit, wait_nr, flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+	}
+	else
+	{
+		ret = uring_enter(ring_fd, to_submit, wait_nr, flags, nullptr, 0);
+	}
+
+	if (ret == SOCKET_ERROR)
+	{
+		// timed out or interrupted, the caller just looks for completions
+		if (errno == ETIME || errno == EINTR)
+			return 0;
+
+		return -errno;
+	}
+
+	return ret;
+}
+
+io_uring_cqe* Net::Uring::Ring_t::peek()
+{
+	for (;;)
+	{
+		const unsigned head = *cq_head;
+		if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+			return nullptr;
+
+		auto cqe = &cqes[head & *cq_mask];
+		if (cqe->user_data != NET_URING_INTERNAL)
+			return cqe;
+
+		if (cqe->res < 0)
+			NET_LOG_ERROR(CSTRING("[Uring] - returning a buffer failed with error: %d"), -cqe->res);
+
+		seen();
+	}
+}
+
+void Net::Uring::Ring_t::seen()
+{
+	__atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE);
+}
+#endif
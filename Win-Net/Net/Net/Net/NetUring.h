@@ -0,0 +1,113 @@
+/*
+	MIT License
+
+	Copyright (c) 2022 Tobias Staack
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+
+/*
+* Linux only: minimal io_uring wrapper
+* talks to the kernel directly using the io_uring syscalls, no liburing required
+* a ring must only be driven by one thread (single submitter)
+*/
+#define NET_URING_ENTRIES 256
+
+/* provided buffers used for multishot recv */
+#define NET_URING_BUFFER_COUNT 128
+#define NET_URING_BUFFER_SIZE 16384
+
+#include <Net/Net/Net.h>
+
+#ifdef BUILD_LINUX
+#include <linux/io_uring.h>
+
+NET_DSA_BEGIN
+namespace Net
+{
+	namespace Uring
+	{
+		class Ring_t
+		{
+			int ring_fd;
+
+			/* submission queue */
+			void* sq_ptr;
+			size_t sq_ptr_size;
+			unsigned* sq_head;
+			unsigned* sq_tail;
+			unsigned* sq_mask;
+			unsigned* sq_array;
+			io_uring_sqe* sqes;
+			size_t sqes_size;
+			unsigned sqe_tail;
+
+			/* completion queue */
+			void* cq_ptr;
+			size_t cq_ptr_size;
+			unsigned* cq_head;
+			unsigned* cq_tail;
+			unsigned* cq_mask;
+			io_uring_cqe* cqes;
+
+			/* provided buffers */
+			byte* buffers;
+			unsigned buf_count;
+			unsigned buf_size;
+			unsigned short buf_group;
+
+			unsigned flush_sq();
+
+		public:
+			Ring_t();
+			~Ring_t();
+
+			bool init(unsigned entries = NET_URING_ENTRIES);
+			void close();
+			bool valid() const;
+
+			/*
+			* hand a pool of buffers over to the kernel, recv operations pick their buffer from it
+			* has to be called right after init, it waits for its own completion
+			*/
+			bool setup_buffers(unsigned count = NET_URING_BUFFER_COUNT, unsigned size = NET_URING_BUFFER_SIZE, unsigned short group = 0);
+			byte* buffer(unsigned short bid) const;
+			void recycle_buffer(unsigned short bid);
+
+			/* returns nullptr if the submission queue is full even after submitting */
+			io_uring_sqe* get_sqe();
+
+			bool accept_multishot(SOCKET fd, uint64 user_data);
+			bool recv_multishot(SOCKET fd, uint64 user_data);
+			bool read(int fd, void* buffer, unsigned size, uint64 user_data);
+			bool cancel(uint64 target, uint64 user_data);
+
+			/* submit pending entries and wait for atleast wait_nr completions or the timeout, returns -errno on failure */
+			int submit(unsigned wait_nr = 0, DWORD timeout_ms = 0);
+
+			/* completions, call seen() once the returned entry has been handled - internal completions are skipped */
+			io_uring_cqe* peek();
+			void seen();
+		};
+	}
+}
+NET_DSA_END
+#endif
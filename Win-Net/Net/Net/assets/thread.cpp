@@ -27,6 +27,233 @@
 #include <Net/Import/Ntdll.hpp>
 #include <Net/assets/manager/logmanager.h>
 
+#ifdef BUILD_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+Net::Thread::Attributes_t::Attributes_t()
+{
+	name[0] = '\0';
+	priority = Priority_t::NORMAL;
+}
+
+Net::Thread::Attributes_t::Attributes_t(const char* name, const Priority_t priority)
+{
+	set_name(name);
+	this->priority = priority;
+}
+
+void Net::Thread::Attributes_t::set_name(const char* name)
+{
+	this->name[0] = '\0';
+	if (name)
+		snprintf(this->name, sizeof(this->name), CSTRING("%s"), name);
+}
+
+Net::Thread::Attributes_t Net::Thread::Attributes_t::worker(const size_t index, const bool pin) const
+{
+	Attributes_t attributes;
+	attributes.priority = priority;
+
+	if (!pin)
+		attributes.cpus = cpus;
+	else if (!cpus.empty())
+		attributes.cpus.emplace_back(cpus[index % cpus.size()]);
+
+	if (name[0] != '\0')
+		snprintf(attributes.name, sizeof(attributes.name), CSTRING("%s-%u"), name, static_cast<unsigned>(index));
+
+	return attributes;
+}
+
+bool Net::Thread::ParseCpuList(const char* list, std::vector<int>& cpus)
+{
+	cpus.clear();
+	if (!list)
+		return false;
+
+	std::vector<int> parsed;
+	const char* it = list;
+	while (*it != '\0')
+	{
+		char* end = nullptr;
+		const auto first = strtol(it, &end, 10);
+		if (end == it || first < 0)
+			return false;
+
+		auto last = first;
+		it = end;
+		if (*it == '-')
+		{
+			++it;
+			last = strtol(it, &end, 10);
+			if (end == it || last < first)
+				return false;
+
+			it = end;
+		}
+
+		for (auto cpu = first; cpu <= last; ++cpu)
+			parsed.emplace_back(static_cast<int>(cpu));
+
+		if (*it == ',')
+			++it;
+		else if (*it != '\0')
+			return false;
+	}
+
+	if (parsed.empty())
+		return false;
+
+	cpus = parsed;
+	return true;
+}
+
+bool Net::Thread::Apply(const Attributes_t& attributes)
+{
+	bool ret = true;
+
+#ifdef BUILD_LINUX
+	if (!attributes.cpus.empty())
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (const auto cpu : attributes.cpus)
+		{
+			if (cpu >= 0 && cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &set);
+		}
+
+		// memory first touched from now on is placed on the numa node of these cores
+		const auto res = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		if (res != 0)
+		{
+			NET_LOG_WARNING(CSTRING("[Thread] - pthread_setaffinity_np failed with: %d"), res);
+			ret = false;
+		}
+	}
+
+	if (attributes.name[0] != '\0')
+		pthread_setname_np(pthread_self(), attributes.name);
+
+	switch (attributes.priority)
+	{
+	case Priority_t::LOW:
+	case Priority_t::HIGH:
+		// the nice value is per thread on linux
+		if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), attributes.priority == Priority_t::LOW ? 10 : -10) != 0)
+		{
+			NET_LOG_WARNING(CSTRING("[Thread] - setpriority failed with: %d"), errno);
+			ret = false;
+		}
+		break;
+
+	case Priority_t::REALTIME:
+	{
+		sched_param param = {};
+		param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+		const auto res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if (res != 0)
+		{
+			NET_LOG_WARNING(CSTRING("[Thread] - pthread_setschedparam failed with: %d"), res);
+			ret = false;
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+#else
+	if (!attributes.cpus.empty())
+	{
+		DWORD_PTR mask = 0;
+		for (const auto cpu : attributes.cpus)
+		{
+			if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+				mask |= (static_cast<DWORD_PTR>(1) << cpu);
+		}
+
+		if (!Kernel32::SetThreadAffinityMask(Kernel32::GetCurrentThread(), mask))
+		{
+			NET_LOG_WARNING(CSTRING("[Thread] - SetThreadAffinityMask failed with: %lu"), GetLastError());
+			ret = false;
+		}
+	}
+
+	int priority = THREAD_PRIORITY_NORMAL;
+	switch (attributes.priority)
+	{
+	case Priority_t::LOW:
+		priority = THREAD_PRIORITY_BELOW_NORMAL;
+		break;
+
+	case Priority_t::HIGH:
+		priority = THREAD_PRIORITY_ABOVE_NORMAL;
+		break;
+
+	case Priority_t::REALTIME:
+		priority = THREAD_PRIORITY_TIME_CRITICAL;
+		break;
+
+	default:
+		break;
+	}
+
+	if (priority != THREAD_PRIORITY_NORMAL && !Kernel32::SetThreadPriority(Kernel32::GetCurrentThread(), priority))
+	{
+		NET_LOG_WARNING(CSTRING("[Thread] - SetThreadPriority failed with: %lu"), GetLastError());
+		ret = false;
+	}
+#endif
+
+	return ret;
+}
+
+struct thread_start_t
+{
+	NET_THREAD_DWORD(*StartRoutine)(LPVOID);
+	LPVOID parameter;
+	Net::Thread::Attributes_t attributes;
+};
+
+static NET_THREAD(thread_start)
+{
+	const auto start = (thread_start_t*)parameter;
+	if (!start) return 0;
+
+	// the thread keeps on running with whatever could be applied
+	Net::Thread::Apply(start->attributes);
+
+	const auto StartRoutine = start->StartRoutine;
+	const auto routine_parameter = start->parameter;
+	FREE<thread_start_t>(start);
+
+	return StartRoutine(routine_parameter);
+}
+
+bool Net::Thread::Create(NET_THREAD_DWORD(*StartRoutine)(LPVOID), LPVOID const parameter, const Attributes_t& attributes)
+{
+	const auto start = ALLOC<thread_start_t>();
+	if (!start)
+		return false;
+
+	start->StartRoutine = StartRoutine;
+	start->parameter = parameter;
+	start->attributes = attributes;
+
+	if (!Create(thread_start, start))
+	{
+		FREE<thread_start_t>(start);
+		return false;
+	}
+
+	return true;
+}
+
 #ifdef BUILD_LINUX
 bool Net::Thread::Create(NET_THREAD_DWORD(*StartRoutine)(LPVOID), LPVOID const parameter)
 {
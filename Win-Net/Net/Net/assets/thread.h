@@ -34,6 +34,8 @@
 #include <thread>
 #endif
 
+#include <vector>
+
 // on linux we just use std::thread - on windows we use winapi to create threads
 #ifdef BUILD_LINUX
 typedef DWORD NET_THREAD_DWORD;
@@ -53,10 +55,49 @@ namespace Net
 {
 	namespace Thread
 	{
+		enum class Priority_t
+		{
+			LOW = 0,
+			NORMAL,
+			HIGH,
+			REALTIME /* linux: SCHED_FIFO, requires CAP_SYS_NICE */
+		};
+
+		struct Attributes_t
+		{
+			/* cores the thread is allowed to run on - empty keeps the inherited mask */
+			std::vector<int> cpus;
+
+			/* linux only (shows up in top and gdb), cut after 15 characters */
+			char name[16];
+
+			Priority_t priority;
+
+			Attributes_t();
+			Attributes_t(const char* name, Priority_t priority = Priority_t::NORMAL);
+
+			void set_name(const char* name);
+
+			/*
+			* attributes of the n-th worker of a set: the index appended to the name
+			* pin: restricted to a single core of the set (round robin) instead of the whole set
+			*/
+			Attributes_t worker(size_t index, bool pin = true) const;
+		};
+
 #ifdef BUILD_LINUX
 		bool Create(NET_THREAD_DWORD(*)(LPVOID), LPVOID parameter = nullptr);
 #else
 		bool Create(NET_THREAD_DWORD(*)(LPVOID), LPVOID parameter = nullptr);
 #endif
+
+		/* the attributes are being applied by the new thread itself before it enters the routine */
+		bool Create(NET_THREAD_DWORD(*)(LPVOID), LPVOID parameter, const Attributes_t& attributes);
+
+		/* applies the attributes to the calling thread, fails if any of them could not be applied */
+		bool Apply(const Attributes_t& attributes);
+
+		/* parses a cpu list like "0-7,16-23" */
+		bool ParseCpuList(const char* list, std::vector<int>& cpus);
 	}
 }
@@ -131,7 +131,7 @@ NET_HANDLE_TIMER Net::Timer::Create(NET_TimerRet(*func)(void*), const double tim
 	timer_t->finished = false;
 	timer_t->bdelete = bdelete;
 	timer_t->async = false;
-	Thread::Create(NetTimerThread, timer_t);
+	Thread::Create(NetTimerThread, timer_t, Thread::Attributes_t("net-timer"));
 	return timer_t;
 }
 
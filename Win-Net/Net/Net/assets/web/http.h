@@ -98,7 +98,6 @@ namespace Net
 		{
 			Network_t();
 
-			byte dataReceive[NET_OPT_DEFAULT_MAX_PACKET_SIZE];
 			NET_CPOINTER<byte> data;
 			size_t data_size;
 			size_t data_full_size;
@@ -25,6 +25,11 @@
 #include <NetClient/Client.h>
 #include <Net/Import/Kernel32.hpp>
 #include <Net/Import/Ws2_32.hpp>
+#include <Net/Net/NetUring.h>
+
+#ifdef BUILD_LINUX
+#include <sys/un.h>
+#endif
 
 namespace Net
 {
@@ -119,6 +124,14 @@ namespace Net
 #endif
 			}
 
+			// the packets that are left still belong to this instance
+			PacketTaskPool.stop();
+
+#ifdef NET_USE_COROUTINES
+			// suspended handlers still belong to this instance as well
+			Net::Coroutine::Wait(this);
+#endif
+
 			Clear();
 
 			for (auto& entry : socketoption)
@@ -132,6 +145,67 @@ namespace Net
 			option.clear();
 		}
 
+#ifdef BUILD_LINUX
+		/*
+		* waits on completions of a multishot recv instead of polling the socket
+		* returns false if io_uring is not available
+		*/
+		static bool ReceiveUring(Client* client)
+		{
+			// one peer only, a smaller pool is plenty
+			Net::Uring::Ring_t ring;
+			if (!ring.init(32) || !ring.setup_buffers(16, NET_URING_BUFFER_SIZE))
+			{
+				NET_LOG_WARNING(CSTRING("[NET] - io_uring is not available, falling back to polling"));
+				return false;
+			}
+
+			bool armed = false;
+			while (client->IsConnected())
+			{
+				// the kernel ends a multishot recv on its own, e.g. after running out of buffers
+				if (!armed)
+					armed = ring.recv_multishot(client->GetSocket(), 1);
+
+				const int res = ring.submit(1, client->Isset(NET_OPT_FREQUENZ) ? client->GetOption<DWORD>(NET_OPT_FREQUENZ) : NET_OPT_DEFAULT_FREQUENZ);
+				if (res < 0 && res != -EBUSY && res != -EAGAIN)
+				{
+					NET_LOG_ERROR(CSTRING("[NET] - io_uring_enter failed with error: %d"), -res);
+					client->Disconnect();
+					break;
+				}
+
+				while (const auto cqe = ring.peek())
+				{
+					const auto cqe_res = cqe->res;
+					const auto cqe_flags = cqe->flags;
+					ring.seen();
+
+					if (!(cqe_flags & IORING_CQE_F_MORE))
+						armed = false;
+
+					if (cqe_res == -ENOBUFS)
+						continue;
+
+					byte* data = nullptr;
+					unsigned short bid = 0;
+					if (cqe_flags & IORING_CQE_F_BUFFER)
+					{
+						bid = static_cast<unsigned short>(cqe_flags >> IORING_CQE_BUFFER_SHIFT);
+						data = ring.buffer(bid);
+					}
+
+					client->DoReceive(data, cqe_res);
+
+					if (data)
+						ring.recycle_buffer(bid);
+				}
+			}
+
+			return true;
+		}
+#endif
+
 		NET_THREAD(Receive)
 		{
 			const auto client = (Client*)parameter;
@@ -140,7 +214,14 @@ namespace Net
 			client->bReceiveThread = true;
 
 			NET_LOG_DEBUG(CSTRING("[NET] - Receive thread has been started"));
-			while (client->IsConnected())
+
+			bool bUring = false;
+#ifdef BUILD_LINUX
+			if (client->Isset(NET_OPT_USE_URING) ? client->GetOption<bool>(NET_OPT_USE_URING) : NET_OPT_DEFAULT_USE_URING)
+				bUring = ReceiveUring(client);
+#endif
+
+			while (!bUring && client->IsConnected())
 			{
 #ifdef BUILD_LINUX
 				usleep(client->DoReceive() * 1000);
@@ -165,7 +246,7 @@ namespace Net
 			return 0;
 		}
 
-		bool Client::Isset(const DWORD opt) const
+		bool Client::Isset(const uint64_t opt) const
 		{
 			// use the bit flag to perform faster checks
 			return optionBitFlag & opt;
@@ -468,6 +549,54 @@ namespace Net
 				return false;
 			}
 
+			return SetupConnection();
+		}
+
+#ifdef BUILD_LINUX
+		bool Client::ConnectUnix(const char* Path)
+		{
+			if (IsConnected())
+			{
+				NET_LOG_ERROR(CSTRING("[NET] - Can't connect to server, reason: already connected!"));
+				return false;
+			}
+
+			sockaddr_un addr = {};
+			addr.sun_family = AF_UNIX;
+			if (!Path || strlen(Path) >= sizeof(addr.sun_path))
+			{
+				NET_LOG_ERROR(CSTRING("[NET] - Unix socket path is not being valid"));
+				return false;
+			}
+
+			strcpy(addr.sun_path, Path);
+
+			SetServerAddress(Path);
+			SetServerPort(0);
+
+			SetSocket(Ws2_32::socket(AF_UNIX, SOCK_STREAM, 0));
+			if (GetSocket() == INVALID_SOCKET)
+			{
+				NET_LOG_ERROR(CSTRING("[NET] - Unable to create socket, error code: %d"), LAST_ERROR);
+				return false;
+			}
+
+			/* Connect to the server */
+			if (Ws2_32::connect(GetSocket(), (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR)
+			{
+				NET_LOG_ERROR(CSTRING("[Client] - failure on connecting to unix socket: %s"), Path);
+				Ws2_32::closesocket(GetSocket());
+				SetSocket(INVALID_SOCKET);
+				return false;
+			}
+
+			return SetupConnection();
+		}
+#endif
+
+		/* connection has been established, everything from here on is independent of the transport */
+		bool Client::SetupConnection()
+		{
 			// clear the unused vector
 			socketoption.clear();
 
@@ -510,6 +639,18 @@ namespace Net
 				network.hReSyncClockNTP = Timer::Create(NTPReSyncClock, Isset(NET_OPT_NTP_SYNC_INTERVAL) ? GetOption<int>(NET_OPT_NTP_SYNC_INTERVAL) : NET_OPT_DEFAULT_NTP_SYNC_INTERVAL, this);
 			}
 
+			// one worker is enough, all packets share the same strand
+			if ((Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
+				&& !PacketTaskPool.is_running())
+			{
+				PacketTaskPool.set_num_threads(1);
+				PacketTaskPool.set_max_depth(Isset(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) ? GetOption<size_t>(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) : NET_OPT_DEFAULT_EXECUTE_PACKET_QUEUE_LIMIT);
+
+				// packets are still being executed, just on the receiving thread
+				if (!PacketTaskPool.start())
+					NET_LOG_ERROR(CSTRING("[NET] - Unable to start the packet worker, executing packets synchronously"));
+			}
+
 			// Create Loop-Receive Thread
 			Thread::Create(Receive, this);
 
@@ -686,10 +827,39 @@ namespace Net
 			return perc;
 		}
 
+		Net::TaskPool::TaskPool_t* Client::PacketPool()
+		{
+			return PacketTaskPool.is_running() ? &PacketTaskPool : nullptr;
+		}
+
+		size_t Client::GetPacketQueueDepth() const
+		{
+			return PacketTaskPool.depth();
+		}
+
+		size_t Client::GetPacketQueuePeak() const
+		{
+			return PacketTaskPool.peak_depth();
+		}
+
+		size_t Client::GetPacketQueueThrottled() const
+		{
+			return PacketTaskPool.throttled();
+		}
+
+		bool Client::IsPacketDefined(const int id)
+		{
+			Net::Packet probe;
+			probe.SetProbe(true);
+
+			return CheckDataN(id, probe) || CheckData(id, probe);
+		}
+
 		void Client::Network::clear()
 		{
 			recordingData = false;
 			estabilished = false;
+			framing = NET_FRAMING_V1;
 			clearData();
 			deleteRSAKeys();
 
@@ -742,24 +912,21 @@ namespace Net
 			return latency;
 		}
 
-		void Client::SingleSend(const char* data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+		/*
+		* writes the frame using scatter-gather calls, partial writes resume where the socket stopped
+		* requires network._mutex_send to be locked
+		*/
+		bool Client::SendFrame(Net::Frame::Frame_t& frame)
 		{
-			if (!GetSocket())
-				return;
-
-			if (bPreviousSentFailed)
-				return;
-
-			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+			while (!frame.done())
 			{
-				char* ptr = (char*)data;
-				for (size_t it = 0; it < size; ++it)
-					ptr[it] = ptr[it] ^ sendToken;
-			}
+				if (!GetSocket())
+					return false;
 
-			do
-			{
-				const auto res = Ws2_32::send(GetSocket(), reinterpret_cast<const char*>(data), size, MSG_NOSIGNAL);
+				NET_IOVEC vec[NET_FRAME_MAX_IOVEC];
+				const auto count = frame.fill(vec, NET_FRAME_MAX_IOVEC);
+
+				const auto res = Net::Frame::send(GetSocket(), vec, count, MSG_NOSIGNAL);
 				if (res == SOCKET_ERROR)
 				{
 #ifdef BUILD_LINUX
@@ -770,10 +937,9 @@ namespace Net
 					}
 					else
 					{
-						bPreviousSentFailed = true;
 						Disconnect();
 						if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(errno).c_str());
-						return;
+						return false;
 					}
 #else
 					if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
@@ -783,212 +949,99 @@ namespace Net
 					}
 					else
 					{
-						bPreviousSentFailed = true;
 						Disconnect();
 						if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-						return;
+						return false;
 					}
 #endif
 				}
-				if (res < 0)
-					break;
 
-				size -= res;
-			} while (size > 0);
+				if (res <= 0)
+					return false;
+
+				frame.consume(static_cast<size_t>(res));
+			}
+
+			return true;
 		}
 
-		void Client::SingleSend(BYTE*& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+		void Client::SingleSend(const char* data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
 		{
 			if (!GetSocket())
-			{
-				FREE<byte>(data);
 				return;
-			}
 
 			if (bPreviousSentFailed)
-			{
-				FREE<byte>(data);
 				return;
-			}
-
-			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-			{
-				for (size_t it = 0; it < size; ++it)
-					data[it] = data[it] ^ sendToken;
-			}
 
-			do
-			{
-				const auto res = Ws2_32::send(GetSocket(), reinterpret_cast<const char*>(data), size, MSG_NOSIGNAL);
-				if (res == SOCKET_ERROR)
-				{
-#ifdef BUILD_LINUX
-					if (errno == EWOULDBLOCK)
-					{
-						usleep(FREQUENZ * 1000);
-						continue;
-					}
-					else
-					{
-						bPreviousSentFailed = true;
-						FREE(data);
-						Disconnect();
-						if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(errno).c_str());
-						return;
-					}
-#else
-					if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-					{
-						Kernel32::Sleep(FREQUENZ);
-						continue;
-					}
-					else
-					{
-						bPreviousSentFailed = true;
-						FREE<byte>(data);
-						Disconnect();
-						if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-						return;
-					}
-#endif
-				}
-				if (res < 0)
-					break;
+			Net::Frame::Frame_t frame;
+			frame.append(data, size);
 
-				size -= res;
-			} while (size > 0);
+			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+				frame.mask(sendToken);
 
-			FREE<byte>(data);
+			if (!SendFrame(frame))
+				bPreviousSentFailed = true;
 		}
 
-		void Client::SingleSend(NET_CPOINTER<BYTE>& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+		void Client::SingleSend(BYTE*& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
 		{
 			if (!GetSocket())
 			{
-				data.free();
+				FREE<byte>(data);
 				return;
 			}
 
 			if (bPreviousSentFailed)
 			{
-				data.free();
+				FREE<byte>(data);
 				return;
 			}
 
+			// ownership moves into the frame
+			Net::Frame::Frame_t frame;
+			frame.attach(data, size);
+			data = nullptr;
+
 			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-			{
-				for (size_t it = 0; it < size; ++it)
-					data.get()[it] = data.get()[it] ^ sendToken;
-			}
+				frame.mask(sendToken);
 
-			do
-			{
-				const auto res = Ws2_32::send(GetSocket(), reinterpret_cast<const char*>(data.get()), size, MSG_NOSIGNAL);
-				if (res == SOCKET_ERROR)
-				{
-#ifdef BUILD_LINUX
-					if (errno == EWOULDBLOCK)
-					{
-						usleep(FREQUENZ * 1000);
-						continue;
-					}
-					else
-					{
-						bPreviousSentFailed = true;
-						data.free();
-						Disconnect();
-						if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(errno).c_str());
-						return;
-					}
-#else
-					if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-					{
-						Kernel32::Sleep(FREQUENZ);
-						continue;
-					}
-					else
-					{
-						bPreviousSentFailed = true;
-						data.free();
-						Disconnect();
-						if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-						return;
-					}
-#endif
-				}
-				if (res < 0)
-					break;
+			if (!SendFrame(frame))
+				bPreviousSentFailed = true;
+		}
 
-				size -= res;
-			} while (size > 0);
+		void Client::SingleSend(NET_CPOINTER<BYTE>& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+		{
+			auto pointer = data.get();
+			data = nullptr;
 
-			data.free();
+			SingleSend(pointer, size, bPreviousSentFailed, sendToken);
 		}
 
 		void Client::SingleSend(Net::RawData_t& data, bool& bPreviousSentFailed, const uint32_t sendToken)
 		{
 			if (!data.valid()) return;
 
-			if (!GetSocket())
+			// the client writes from memory only, file backed raw data is read in first
+			if (!data.load())
 			{
+				bPreviousSentFailed = true;
 				data.free();
 				return;
 			}
 
-			if (bPreviousSentFailed)
+			if (data.do_free())
 			{
+				// ownership moves into the frame
+				auto pointer = data.value();
+				const auto size = data.size();
+				data.set_free(false);
 				data.free();
-				return;
-			}
 
-			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-			{
-				for (size_t it = 0; it < data.size(); ++it)
-					data.value()[it] = data.value()[it] ^ sendToken;
+				SingleSend(pointer, size, bPreviousSentFailed, sendToken);
+				return;
 			}
 
-			size_t size = data.size();
-			do
-			{
-				const auto res = Ws2_32::send(GetSocket(), reinterpret_cast<const char*>(data.value()), size, MSG_NOSIGNAL);
-				if (res == SOCKET_ERROR)
-				{
-#ifdef BUILD_LINUX
-					if (errno == EWOULDBLOCK)
-					{
-						usleep(FREQUENZ * 1000);
-						continue;
-					}
-					else
-					{
-						bPreviousSentFailed = true;
-						data.free();
-						Disconnect();
-						if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(errno).c_str());
-						return;
-					}
-#else
-					if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-					{
-						Kernel32::Sleep(FREQUENZ);
-						continue;
-					}
-					else
-					{
-						bPreviousSentFailed = true;
-						data.free();
-						Disconnect();
-						if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-						return;
-					}
-#endif
-				}
-				if (res < 0)
-					break;
-
-				size -= res;
-			} while (size > 0);
-
+			SingleSend(reinterpret_cast<const char*>(data.value()), data.size(), bPreviousSentFailed, sendToken);
 			data.free();
 		}
 
@@ -1024,6 +1077,10 @@ namespace Net
 			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
 				sendToken = Net::Coding::TOTP::generateToken(network.totp_secret, network.totp_secret_len, Isset(NET_OPT_USE_NTP) ? GetOption<bool>(NET_OPT_USE_NTP) : NET_OPT_DEFAULT_USE_NTP ? network.curTime : time(nullptr), Isset(NET_OPT_TOTP_INTERVAL) ? (int)(GetOption<int>(NET_OPT_TOTP_INTERVAL) / 2) : (int)(NET_OPT_DEFAULT_TOTP_INTERVAL / 2));
 
+			// the client writes from memory only, file backed raw data is read in first
+			if (PKG.HasRawData() && !PKG.LoadRawFiles())
+				return;
+
 			Net::Json::Document doc;
 			doc[CSTRING("ID")] = id;
 			doc[CSTRING("CONTENT")] = pkg.Data();
@@ -1113,6 +1170,17 @@ namespace Net
 					}
 				}
 
+				if (network.framing == NET_FRAMING_V2)
+				{
+					const uint16_t flags = NET_FRAMING_V2_FLAG_CIPHER
+						| ((Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION) ? NET_FRAMING_V2_FLAG_COMPRESSION : 0);
+
+					Net::Frame::Frame_t frame;
+					Net::Framing::encode(frame, id, flags, Key.get(), aesKeySize, IV.get(), IVSize, dataBuffer.get(), dataBufferSize, original_dataBufferSize, PKG.GetRawData());
+					SendFrame(frame);
+					return;
+				}
+
 				combinedSize = dataBufferSize + NET_PACKET_HEADER_LEN + NET_PACKET_SIZE_LEN + NET_DATA_LEN + NET_PACKET_FOOTER_LEN + NET_AES_KEY_LEN + strlen(NET_AES_IV) + aesKeySize + IVSize + 8;
 
 				/* Compression */
@@ -1139,16 +1207,16 @@ namespace Net
 
 				const auto EntirePacketSizeStr = std::to_string(combinedSize + std::to_string(combinedSize).length());
 
-				auto bPreviousSentFailed = false;
+				Net::Frame::Frame_t frame;
 
 				/* Append Packet Header */
-				SingleSend(NET_PACKET_HEADER, NET_PACKET_HEADER_LEN, bPreviousSentFailed, sendToken);
+				frame.append(NET_PACKET_HEADER, NET_PACKET_HEADER_LEN);
 
 				// Append Packet Size Syntax
-				SingleSend(NET_PACKET_SIZE, NET_PACKET_SIZE_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-				SingleSend(EntirePacketSizeStr.data(), EntirePacketSizeStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+				frame.append(NET_PACKET_SIZE, NET_PACKET_SIZE_LEN);
+				frame.append(NET_PACKET_BRACKET_OPEN, 1);
+				frame.append(EntirePacketSizeStr.data(), EntirePacketSizeStr.length());
+				frame.append(NET_PACKET_BRACKET_CLOSE, 1);
 
 				/* Append Original Uncompressed Packet Size */
 				/* Compression */
@@ -1156,25 +1224,25 @@ namespace Net
 				{
 					const auto UnCompressedPacketSizeStr = std::to_string(original_dataBufferSize + std::to_string(original_dataBufferSize).length());
 
-					SingleSend(NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-					SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-					SingleSend(UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length(), bPreviousSentFailed, sendToken);
-					SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+					frame.append(NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN);
+					frame.append(NET_PACKET_BRACKET_OPEN, 1);
+					frame.append(UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length());
+					frame.append(NET_PACKET_BRACKET_CLOSE, 1);
 				}
 
 				/* Append Packet Key */
-				SingleSend(NET_AES_KEY, NET_AES_KEY_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-				SingleSend(KeySizeStr.data(), KeySizeStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(Key, aesKeySize, bPreviousSentFailed, sendToken);
+				frame.append(NET_AES_KEY, NET_AES_KEY_LEN);
+				frame.append(NET_PACKET_BRACKET_OPEN, 1);
+				frame.append(KeySizeStr.data(), KeySizeStr.length());
+				frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+				frame.attach(Key.get(), aesKeySize); // frame takes over the buffer
 
 				/* Append Packet IV */
-				SingleSend(NET_AES_IV, strlen(NET_AES_IV), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-				SingleSend(IVSizeStr.data(), IVSizeStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(IV, IVSize, bPreviousSentFailed, sendToken);
+				frame.append(NET_AES_IV, strlen(NET_AES_IV));
+				frame.append(NET_PACKET_BRACKET_OPEN, 1);
+				frame.append(IVSizeStr.data(), IVSizeStr.length());
+				frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+				frame.attach(IV.get(), IVSize);
 
 				/* Append Packet Data */
 				if (PKG.HasRawData())
@@ -1182,14 +1250,14 @@ namespace Net
 					for (auto& data : PKG.GetRawData())
 					{
 						// Append Key
-						SingleSend(NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN, bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+						frame.append(NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN);
+						frame.append(NET_PACKET_BRACKET_OPEN, 1);
 
 						const auto KeyLengthStr = std::to_string(strlen(data.key()) + 1);
 
-						SingleSend(KeyLengthStr.data(), KeyLengthStr.length(), bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-						SingleSend(data.key(), strlen(data.key()) + 1, bPreviousSentFailed, sendToken);
+						frame.append(KeyLengthStr.data(), KeyLengthStr.length());
+						frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+						frame.append(data.key(), strlen(data.key()) + 1);
 
 						// Append Original Size
 						/* Compression */
@@ -1197,34 +1265,45 @@ namespace Net
 						{
 							const auto OriginalSizeStr = std::to_string(data.original_size() + std::to_string(data.original_size()).length());
 
-							SingleSend(NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-							SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-							SingleSend(OriginalSizeStr.data(), OriginalSizeStr.length(), bPreviousSentFailed, sendToken);
-							SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+							frame.append(NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN);
+							frame.append(NET_PACKET_BRACKET_OPEN, 1);
+							frame.append(OriginalSizeStr.data(), OriginalSizeStr.length());
+							frame.append(NET_PACKET_BRACKET_CLOSE, 1);
 						}
 
 						// Append Raw Data
-						SingleSend(NET_RAW_DATA, NET_RAW_DATA_LEN, bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+						frame.append(NET_RAW_DATA, NET_RAW_DATA_LEN);
+						frame.append(NET_PACKET_BRACKET_OPEN, 1);
 
 						const auto rawDataLengthStr = std::to_string(data.size());
 
-						SingleSend(rawDataLengthStr.data(), rawDataLengthStr.length(), bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-						SingleSend(data, bPreviousSentFailed, sendToken);
+						frame.append(rawDataLengthStr.data(), rawDataLengthStr.length());
+						frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+
+						// ownership moves into the frame unless the caller keeps the buffer
+						if (data.do_free())
+							frame.attach(data.value(), data.size());
+						else
+							frame.append(data.value(), data.size());
 
 						data.set_free(false);
+						data.free();
 					}
 				}
 
-				SingleSend(NET_DATA, NET_DATA_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-				SingleSend(dataSizeStr.data(), dataSizeStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(dataBuffer, dataBufferSize, bPreviousSentFailed, sendToken);
+				frame.append(NET_DATA, NET_DATA_LEN);
+				frame.append(NET_PACKET_BRACKET_OPEN, 1);
+				frame.append(dataSizeStr.data(), dataSizeStr.length());
+				frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+				frame.attach(dataBuffer.get(), dataBufferSize);
 
 				/* Append Packet Footer */
-				SingleSend(NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN, bPreviousSentFailed, sendToken);
+				frame.append(NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN);
+
+				if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+					frame.mask(sendToken);
+
+				SendFrame(frame);
 			}
 			else
 			{
@@ -1246,6 +1325,16 @@ namespace Net
 					}
 				}
 
+				if (network.framing == NET_FRAMING_V2)
+				{
+					const uint16_t flags = (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION) ? NET_FRAMING_V2_FLAG_COMPRESSION : 0;
+
+					Net::Frame::Frame_t frame;
+					Net::Framing::encode(frame, id, flags, nullptr, 0, nullptr, 0, dataBuffer.get(), dataBufferSize, original_dataBufferSize, PKG.GetRawData());
+					SendFrame(frame);
+					return;
+				}
+
 				combinedSize = dataBufferSize + NET_PACKET_HEADER_LEN + NET_PACKET_SIZE_LEN + NET_DATA_LEN + NET_PACKET_FOOTER_LEN + 4;
 
 				/* Compression */
@@ -1266,16 +1355,16 @@ namespace Net
 
 				const auto EntirePacketSizeStr = std::to_string(combinedSize + std::to_string(combinedSize).length());
 
-				auto bPreviousSentFailed = false;
+				Net::Frame::Frame_t frame;
 
 				/* Append Packet Header */
-				SingleSend(NET_PACKET_HEADER, NET_PACKET_HEADER_LEN, bPreviousSentFailed, sendToken);
+				frame.append(NET_PACKET_HEADER, NET_PACKET_HEADER_LEN);
 
 				// Append Packet Size Syntax
-				SingleSend(NET_PACKET_SIZE, NET_PACKET_SIZE_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-				SingleSend(EntirePacketSizeStr.data(), EntirePacketSizeStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+				frame.append(NET_PACKET_SIZE, NET_PACKET_SIZE_LEN);
+				frame.append(NET_PACKET_BRACKET_OPEN, 1);
+				frame.append(EntirePacketSizeStr.data(), EntirePacketSizeStr.length());
+				frame.append(NET_PACKET_BRACKET_CLOSE, 1);
 
 				/* Append Original Uncompressed Packet Size */
 				/* Compression */
@@ -1283,10 +1372,10 @@ namespace Net
 				{
 					const auto UnCompressedPacketSizeStr = std::to_string(original_dataBufferSize + std::to_string(original_dataBufferSize).length());
 
-					SingleSend(NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-					SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-					SingleSend(UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length(), bPreviousSentFailed, sendToken);
-					SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+					frame.append(NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN);
+					frame.append(NET_PACKET_BRACKET_OPEN, 1);
+					frame.append(UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length());
+					frame.append(NET_PACKET_BRACKET_CLOSE, 1);
 				}
 
 				/* Append Packet Data */
@@ -1295,14 +1384,14 @@ namespace Net
 					for (auto& data : PKG.GetRawData())
 					{
 						// Append Key
-						SingleSend(NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN, bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+						frame.append(NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN);
+						frame.append(NET_PACKET_BRACKET_OPEN, 1);
 
 						const auto KeyLengthStr = std::to_string(strlen(data.key()) + 1);
 
-						SingleSend(KeyLengthStr.data(), KeyLengthStr.length(), bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-						SingleSend(data.key(), strlen(data.key()) + 1, bPreviousSentFailed, sendToken);
+						frame.append(KeyLengthStr.data(), KeyLengthStr.length());
+						frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+						frame.append(data.key(), strlen(data.key()) + 1);
 
 						// Append Original Size
 						/* Compression */
@@ -1310,34 +1399,45 @@ namespace Net
 						{
 							const auto OriginalSizeStr = std::to_string(data.original_size() + std::to_string(data.original_size()).length());
 
-							SingleSend(NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-							SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-							SingleSend(OriginalSizeStr.data(), OriginalSizeStr.length(), bPreviousSentFailed, sendToken);
-							SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+							frame.append(NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN);
+							frame.append(NET_PACKET_BRACKET_OPEN, 1);
+							frame.append(OriginalSizeStr.data(), OriginalSizeStr.length());
+							frame.append(NET_PACKET_BRACKET_CLOSE, 1);
 						}
 
 						// Append Raw Data
-						SingleSend(NET_RAW_DATA, NET_RAW_DATA_LEN, bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+						frame.append(NET_RAW_DATA, NET_RAW_DATA_LEN);
+						frame.append(NET_PACKET_BRACKET_OPEN, 1);
 
 						const auto rawDataLengthStr = std::to_string(data.size());
 
-						SingleSend(rawDataLengthStr.data(), rawDataLengthStr.length(), bPreviousSentFailed, sendToken);
-						SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-						SingleSend(data, bPreviousSentFailed, sendToken);
+						frame.append(rawDataLengthStr.data(), rawDataLengthStr.length());
+						frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+
+						// ownership moves into the frame unless the caller keeps the buffer
+						if (data.do_free())
+							frame.attach(data.value(), data.size());
+						else
+							frame.append(data.value(), data.size());
 
 						data.set_free(false);
+						data.free();
 					}
 				}
 
-				SingleSend(NET_DATA, NET_DATA_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_OPEN, strlen(NET_PACKET_BRACKET_OPEN), bPreviousSentFailed, sendToken);
-				SingleSend(dataSizeStr.data(), dataSizeStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(dataBuffer, dataBufferSize, bPreviousSentFailed, sendToken);
+				frame.append(NET_DATA, NET_DATA_LEN);
+				frame.append(NET_PACKET_BRACKET_OPEN, strlen(NET_PACKET_BRACKET_OPEN));
+				frame.append(dataSizeStr.data(), dataSizeStr.length());
+				frame.append(NET_PACKET_BRACKET_CLOSE, 1);
+				frame.attach(dataBuffer.get(), dataBufferSize);
 
 				/* Append Packet Footer */
-				SingleSend(NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN, bPreviousSentFailed, sendToken);
+				frame.append(NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN);
+
+				if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+					frame.mask(sendToken);
+
+				SendFrame(frame);
 			}
 		}
 
@@ -1367,7 +1467,8 @@ namespace Net
 			if (!IsConnected())
 				return FREQUENZ;
 
-			auto data_size = Ws2_32::recv(GetSocket(), reinterpret_cast<char*>(network.dataReceive), NET_OPT_DEFAULT_MAX_PACKET_SIZE, 0);
+			const auto dataReceive = Net::ReceiveBuffer();
+			auto data_size = Ws2_32::recv(GetSocket(), reinterpret_cast<char*>(dataReceive), NET_OPT_DEFAULT_MAX_PACKET_SIZE, 0);
 			if (data_size == SOCKET_ERROR)
 			{
 #ifdef BUILD_LINUX
@@ -1376,7 +1477,6 @@ namespace Net
 				if (Ws2_32::WSAGetLastError() != WSAEWOULDBLOCK)
 #endif
 				{
-					memset(network.dataReceive, 0, NET_OPT_DEFAULT_MAX_PACKET_SIZE);
 					Disconnect();
 
 #ifdef BUILD_LINUX
@@ -1389,14 +1489,31 @@ namespace Net
 				}
 
 				ProcessPackets();
-				memset(network.dataReceive, 0, NET_OPT_DEFAULT_MAX_PACKET_SIZE);
+				return FREQUENZ;
+			}
+
+			return DoReceive(dataReceive, data_size);
+		}
+
+		/*
+		* processes data that has already been received
+		* size == 0: closed by the remote, size < 0: -errno (io_uring)
+		*/
+		DWORD Client::DoReceive(const byte* dataReceive, const int64 data_size)
+		{
+			if (!IsConnected())
+				return FREQUENZ;
+
+			if (data_size < 0)
+			{
+				Disconnect();
+				NET_LOG_PEER(CSTRING("%s"), Net::sock_err::getString(static_cast<int>(-data_size)).c_str());
 				return FREQUENZ;
 			}
 
 			// graceful disconnect
 			if (data_size == 0)
 			{
-				memset(network.dataReceive, 0, NET_OPT_DEFAULT_MAX_PACKET_SIZE);
 				Disconnect();
 				NET_LOG_PEER(CSTRING("Connection has been gracefully closed"));
 				return FREQUENZ;
@@ -1405,7 +1522,7 @@ namespace Net
 			if (!network.data.valid())
 			{
 				network.AllocData(data_size);
-				memcpy(network.data.get(), network.dataReceive, data_size);
+				memcpy(network.data.get(), dataReceive, data_size);
 				network.data.get()[data_size] = '\0';
 				network.data_size = data_size;
 			}
@@ -1414,7 +1531,7 @@ namespace Net
 				if (network.data_full_size > 0
 					&& network.data_size + data_size < network.data_full_size)
 				{
-					memcpy(&network.data.get()[network.data_size], network.dataReceive, data_size);
+					memcpy(&network.data.get()[network.data_size], dataReceive, data_size);
 					network.data_size += data_size;
 				}
 				else
@@ -1422,7 +1539,7 @@ namespace Net
 					/* store incomming */
 					const auto newBuffer = ALLOC<BYTE>(network.data_size + data_size + 1);
 					memcpy(newBuffer, network.data.get(), network.data_size);
-					memcpy(&newBuffer[network.data_size], network.dataReceive, data_size);
+					memcpy(&newBuffer[network.data_size], dataReceive, data_size);
 					newBuffer[network.data_size + data_size] = '\0';
 					network.data.free();
 					network.data = newBuffer; // pointer swap
@@ -1430,7 +1547,6 @@ namespace Net
 				}
 			}
 
-			memset(network.dataReceive, 0, NET_OPT_DEFAULT_MAX_PACKET_SIZE);
 			ProcessPackets();
 			return 0;
 		}
@@ -1512,16 +1628,20 @@ namespace Net
 			return true;
 		}
 
-		void Client::ProcessPackets()
+		bool Client::ProcessPacket()
 		{
 			// check valid data size
 			if (!network.data_size)
-				return;
+				return false;
 
 			if (network.data_size == INVALID_SIZE)
-				return;
+				return false;
+
+			if (network.data_size < NET_PACKET_HEADER_LEN) return false;
 
-			if (network.data_size < NET_PACKET_HEADER_LEN) return;
+			// binary framing, the server switches to it as soon as it has confirmed it
+			if (UseBinaryFraming() && Net::Framing::is_binary(network.data.get(), network.data_size))
+				return ProcessFrame();
 
 			auto use_old_token = true;
 			bool already_checked = false;
@@ -1530,7 +1650,7 @@ namespace Net
 			if (!network.data_full_size || network.data_full_size == INVALID_SIZE)
 			{
 				already_checked = true;
-				if (!ValidHeader(use_old_token)) return;
+				if (!ValidHeader(use_old_token)) return false;
 
 				// read entire packet size
 				const size_t start = NET_PACKET_HEADER_LEN + NET_PACKET_SIZE_LEN + 1;
@@ -1564,7 +1684,7 @@ namespace Net
 									network.data.get()[it] = network.data.get()[it] ^ (use_old_token ? network.lastToken : network.curToken);
 							}
 
-							return;
+							return false;
 						}
 
 						// shift all the way back
@@ -1579,30 +1699,11 @@ namespace Net
 				}
 			}
 
-			/* Compression */
-			if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-			{
-				const size_t start = network.data_offset + NET_PACKET_ORIGINAL_SIZE_LEN + 2; // 2 - Begin & End Tag
-				for (size_t i = start; i < network.data_size; ++i)
-				{
-					// iterate until we have found the end tag
-					if (!memcmp(&network.data.get()[i], NET_PACKET_BRACKET_CLOSE, 1))
-					{
-						network.data_offset = i;
-						const auto size = i - start;
-						char* end = (char*)network.data.get()[start] + size;
-						network.data_original_uncompressed_size = strtoull((const char*)&network.data.get()[start], &end, 10);
-
-						break;
-					}
-				}
-			}
-
 			// keep going until we have received the entire packet
-			if (!network.data_full_size || network.data_full_size == INVALID_SIZE || network.data_size < network.data_full_size) return;
+			if (!network.data_full_size || network.data_full_size == INVALID_SIZE || network.data_size < network.data_full_size) return false;
 
 			if (!already_checked)
-				if (!ValidHeader(use_old_token)) return;
+				if (!ValidHeader(use_old_token)) return false;
 
 			// shift only as much as required
 			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
@@ -1617,7 +1718,7 @@ namespace Net
 				network.clear();
 				Disconnect();
 				NET_LOG_ERROR(CSTRING("[NET] - Received a frame with an invalid footer"));
-				return;
+				return false;
 			}
 
 			// Execute the packet
@@ -1634,10 +1735,94 @@ namespace Net
 				network.clearData();
 				network.data = leftBuffer; // swap pointer
 				network.data_size = leftSize;
-				return;
+				return true;
 			}
 
 			network.clearData();
+			return true;
+		}
+
+		/* TOTP masks every byte, the binary header could not be read without trying the tokens */
+		bool Client::UseBinaryFraming()
+		{
+			return (Isset(NET_OPT_BINARY_FRAMING) ? GetOption<bool>(NET_OPT_BINARY_FRAMING) : NET_OPT_DEFAULT_BINARY_FRAMING)
+				&& !(Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP);
+		}
+
+		/* binary framing: the frame is delimited by the size field of the fixed header */
+		bool Client::ProcessFrame()
+		{
+			if (!network.data_full_size)
+			{
+				if (network.data_size < NET_FRAMING_V2_HEADER_LEN)
+					return false;
+
+				const auto size = Net::Framing::frame_size(network.data.get());
+				if (size < NET_FRAMING_V2_HEADER_LEN || size == INVALID_SIZE)
+				{
+					network.clear();
+					Disconnect();
+					NET_LOG_ERROR(CSTRING("[NET] - Received a frame with an invalid header"));
+					return false;
+				}
+
+				network.data_full_size = size;
+
+				// the packet id is part of the header, the same result the execution would have had without receiving the body first
+				const auto id = Net::Framing::frame_id(network.data.get());
+				if (id < 0
+					|| ((Isset(NET_OPT_REJECT_UNKNOWN_PACKETS) ? GetOption<bool>(NET_OPT_REJECT_UNKNOWN_PACKETS) : NET_OPT_DEFAULT_REJECT_UNKNOWN_PACKETS) && !IsPacketDefined(id)))
+				{
+					network.clear();
+					Disconnect();
+					NET_LOG_ERROR(CSTRING("[NET] - Frame is not defined"));
+					return false;
+				}
+
+				// awaiting more bytes
+				if (network.data_full_size > network.data_size)
+				{
+					// pre-allocate enough space
+					const auto newBuffer = ALLOC<BYTE>(network.data_full_size + 1);
+					memcpy(newBuffer, network.data.get(), network.data_size);
+					newBuffer[network.data_full_size] = '\0';
+					network.data.free();
+					network.data = newBuffer; // pointer swap
+					return false;
+				}
+			}
+
+			// keep going until we have received the entire frame
+			if (network.data_size < network.data_full_size) return false;
+
+			// Execute the packet
+			ExecutePacket();
+
+			// re-alloc buffer
+			const auto leftSize = network.data_size - network.data_full_size;
+			if (leftSize > 0)
+			{
+				const auto leftBuffer = ALLOC<BYTE>(leftSize + 1);
+				memcpy(leftBuffer, &network.data.get()[network.data_full_size], leftSize);
+				leftBuffer[leftSize] = '\0';
+				network.clearData();
+				network.data = leftBuffer; // swap pointer
+				network.data_size = leftSize;
+				return true;
+			}
+
+			network.clearData();
+			return true;
+		}
+
+		/* a single read might contain several frames, execute all of them before waiting for more */
+		void Client::ProcessPackets()
+		{
+			while (ProcessPacket())
+			{
+				if (!IsConnected())
+					break;
+			}
 		}
 
 
@@ -1648,14 +1833,19 @@ namespace Net
 			int m_packetId;
 		};
 
-		NET_THREAD(ThreadPacketExecute)
+		static void PacketExecuteTask(void* param)
 		{
-			auto tpe = (TPacketExcecute*)parameter;
+			auto tpe = (TPacketExcecute*)param;
 			if (!tpe)
 			{
-				return 1;
+				return;
 			}
 
+#ifdef NET_USE_COROUTINES
+			// a suspended handler continues on the packet worker
+			Net::Coroutine::Scope_t scope(tpe->m_client->PacketPool(), tpe->m_client);
+#endif
+
 			if (!tpe->m_client->CheckDataN(tpe->m_packetId, *tpe->m_packet))
 				if (!tpe->m_client->CheckData(tpe->m_packetId, *tpe->m_packet))
 				{
@@ -1675,7 +1865,6 @@ namespace Net
 
 			FREE<Net::Packet>(tpe->m_packet);
 			FREE<TPacketExcecute>(tpe);
-			return 0;
 		}
 
 		void Client::ExecutePacket()
@@ -1688,466 +1877,34 @@ namespace Net
 				return;
 			}
 
-			/* Crypt */
-			if ((Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && network.RSAHandshake)
+			/* the sections are read in place, the json document and the raw data are the only things being copied */
+			if (!DecodeFrame(*pPacket.get(), data))
 			{
-				auto offset = network.data_offset + 1;
-
-				NET_CPOINTER<BYTE> AESKey;
-				size_t AESKeySize;
-
-				// look for key tag
-				if (!memcmp(&network.data.get()[offset], NET_AES_KEY, NET_AES_KEY_LEN))
-				{
-					offset += NET_AES_KEY_LEN;
-
-					// read size
-					for (auto y = offset; y < network.data_size; ++y)
-					{
-						if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-						{
-							const auto psize = y - offset - 1;
-							NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-							memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-							dataSizeStr.get()[psize] = '\0';
-							AESKeySize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-							dataSizeStr.free();
-
-							offset += psize + 2;
-							break;
-						}
-					}
-
-					// read the data
-					AESKey = ALLOC<BYTE>(AESKeySize + 1);
-					memcpy(AESKey.get(), &network.data.get()[offset], AESKeySize);
-					AESKey.get()[AESKeySize] = '\0';
-
-					offset += AESKeySize;
-				}
-
-				NET_CPOINTER<BYTE> AESIV;
-				size_t AESIVSize;
-
-				// look for iv tag
-				if (!memcmp(&network.data.get()[offset], NET_AES_IV, strlen(NET_AES_IV)))
-				{
-					offset += strlen(NET_AES_IV);
-
-					// read size
-					for (auto y = offset; y < network.data_size; ++y)
-					{
-						if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-						{
-							const auto psize = y - offset - 1;
-							NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-							memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-							dataSizeStr.get()[psize] = '\0';
-							AESIVSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-							dataSizeStr.free();
-
-							offset += psize + 2;
-							break;
-						}
-					}
-
-					// read the data
-					AESIV = ALLOC<BYTE>(AESIVSize + 1);
-					memcpy(AESIV.get(), &network.data.get()[offset], AESIVSize);
-					AESIV.get()[AESIVSize] = '\0';
-
-					offset += AESIVSize;
-				}
-
-				if (!network.RSA.decryptBase64(AESKey.reference().get(), AESKeySize))
-				{
-					AESKey.free();
-					AESIV.free();
-					Disconnect();
-					NET_LOG_ERROR(CSTRING("[NET] - Failure on decrypting frame using AES-Key & RSA and Base64"));
-					goto loc_packet_free;
-					return;
-				}
-
-				if (!network.RSA.decryptBase64(AESIV.reference().get(), AESIVSize))
-				{
-					AESKey.free();
-					AESIV.free();
-					Disconnect();
-					NET_LOG_ERROR(CSTRING("[NET] - Failure on decrypting frame using AES-IV & RSA and Base64"));
-					goto loc_packet_free;
-					return;
-				}
-
-				NET_AES aes;
-				if (!aes.init(reinterpret_cast<const char*>(AESKey.get()), reinterpret_cast<const char*>(AESIV.get())))
+				pPacket.free();
+				return;
+			}
+			
+			/*
+			* binary framing: the packet id is part of the header
+			* the handler parses the json document the first time it reads it
+			*/
+			int packetId = -1;
+			if (Net::Framing::is_binary(network.data.get(), network.data_full_size))
+			{
+				packetId = Net::Framing::frame_id(network.data.get());
+				if (packetId < 0)
 				{
-					AESKey.free();
-					AESIV.free();
+					data.free();
 					Disconnect();
-					NET_LOG_ERROR(CSTRING("[NET] - Initializing AES failure"));
+					NET_LOG_PEER(CSTRING("[NET] - Frame identification is not valid"));
 					goto loc_packet_free;
 					return;
 				}
 
-				AESKey.free();
-				AESIV.free();
-
-				do
-				{
-					// look for raw data tag
-					if (!memcmp(&network.data.get()[offset], NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN))
-					{
-						offset += NET_RAW_DATA_KEY_LEN;
-
-						// read size
-						NET_CPOINTER<BYTE> key;
-						size_t KeySize = 0;
-						{
-							for (auto y = offset; y < network.data_size; ++y)
-							{
-								if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-								{
-									const auto psize = y - offset - 1;
-									NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-									memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-									dataSizeStr.get()[psize] = '\0';
-									KeySize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-									dataSizeStr.free();
-
-									offset += psize + 2;
-									break;
-								}
-							}
-
-							// read the data
-							key = ALLOC<BYTE>(KeySize + 1);
-							memcpy(key.get(), &network.data.get()[offset], KeySize);
-							key.get()[KeySize] = '\0';
-
-							offset += KeySize;
-						}
-
-						// looking for raw data original size tag
-						/* Compression */
-						size_t originalSize = 0;
-						if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-						{
-							if (!memcmp(&network.data.get()[offset], NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN))
-							{
-								offset += NET_RAW_DATA_ORIGINAL_SIZE_LEN;
-
-								// read original size
-								for (auto y = offset; y < network.data_size; ++y)
-								{
-									if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-									{
-										const auto psize = y - offset - 1;
-										NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-										memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-										dataSizeStr.get()[psize] = '\0';
-										originalSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-										dataSizeStr.free();
-
-										offset += psize + 2;
-										break;
-									}
-								}
-							}
-						}
-
-						if (!memcmp(&network.data.get()[offset], NET_RAW_DATA, NET_RAW_DATA_LEN))
-						{
-							offset += NET_RAW_DATA_LEN;
-
-							// read size
-							size_t packetSize = 0;
-							{
-								for (auto y = offset; y < network.data_size; ++y)
-								{
-									if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-									{
-										const auto psize = y - offset - 1;
-										NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-										memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-										dataSizeStr.get()[psize] = '\0';
-										packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-										dataSizeStr.free();
-
-										offset += psize + 2;
-										break;
-									}
-								}
-							}
-
-							Net::RawData_t entry = { (char*)key.get(), &network.data.get()[offset], packetSize, false };
-
-							/* decrypt aes */
-							if (!aes.decrypt(entry.value(), entry.size()))
-							{
-								Disconnect();
-								NET_LOG_PEER(CSTRING("[NET] - Decrypting frame has been failed"));
-								goto loc_packet_free;
-								return;
-							}
-
-							/* Compression */
-							if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-							{
-								BYTE* copy = ALLOC<BYTE>(entry.size());
-								memcpy(copy, entry.value(), entry.size());
-								entry.set(copy);
-
-								entry.set_original_size(originalSize);
-								DecompressData(entry.value(), entry.size(), entry.original_size());
-								entry.set_original_size(entry.size());
-							}
-
-							/* in seperate thread we need to create a copy of this data-set */
-							if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
-							{
-								BYTE* copy = ALLOC<BYTE>(entry.size());
-								memcpy(copy, entry.value(), entry.size());
-								entry.set(copy);
-							}
-
-							pPacket.get()->AddRaw(entry);
-							key.free();
-
-							offset += packetSize;
-						}
-					}
-
-					// look for data tag
-					if (!memcmp(&network.data.get()[offset], NET_DATA, NET_DATA_LEN))
-					{
-						offset += NET_DATA_LEN;
-
-						// read size
-						size_t packetSize = 0;
-						{
-							for (auto y = offset; y < network.data_size; ++y)
-							{
-								if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-								{
-									const auto psize = y - offset - 1;
-									NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-									memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-									dataSizeStr.get()[psize] = '\0';
-									packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-									dataSizeStr.free();
-
-									offset += psize + 2;
-									break;
-								}
-							}
-						}
-
-						// read the data
-						data = ALLOC<BYTE>(packetSize + 1);
-						memcpy(data.get(), &network.data.get()[offset], packetSize);
-						data.get()[packetSize] = '\0';
-
-						offset += packetSize;
-
-						/* decrypt aes */
-						if (!aes.decrypt(data.get(), packetSize))
-						{
-							data.free();
-							Disconnect();
-							NET_LOG_PEER(CSTRING("[NET] - Decrypting frame has been failed"));
-							goto loc_packet_free;
-							return;
-						}
-
-						/* Compression */
-						if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-						{
-							DecompressData(data.reference().get(), packetSize, network.data_original_uncompressed_size);
-						}
-					}
-
-					// we have reached the end of reading
-					if (offset + NET_PACKET_FOOTER_LEN >= network.data_full_size)
-						break;
-
-				} while (true);
+				pPacket.get()->SetBody(data.get());
+				data = nullptr;
 			}
 			else
-			{
-				auto offset = network.data_offset + 1;
-
-				do
-				{
-					// look for raw data tag
-					if (!memcmp(&network.data.get()[offset], NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN))
-					{
-						offset += NET_RAW_DATA_KEY_LEN;
-
-						// read size
-						NET_CPOINTER<BYTE> key;
-						size_t KeySize = 0;
-						{
-							for (auto y = offset; y < network.data_size; ++y)
-							{
-								if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-								{
-									const auto psize = y - offset - 1;
-									NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-									memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-									dataSizeStr.get()[psize] = '\0';
-									KeySize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-									dataSizeStr.free();
-
-									offset += psize + 2;
-									break;
-								}
-							}
-
-							// read the data
-							key = ALLOC<BYTE>(KeySize + 1);
-							memcpy(key.get(), &network.data.get()[offset], KeySize);
-							key.get()[KeySize] = '\0';
-
-							offset += KeySize;
-						}
-
-						// looking for raw data original size tag
-						/* Compression */
-						size_t originalSize = 0;
-						if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-						{
-							if (!memcmp(&network.data.get()[offset], NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN))
-							{
-								offset += NET_RAW_DATA_ORIGINAL_SIZE_LEN;
-
-								// read original size
-								for (auto y = offset; y < network.data_size; ++y)
-								{
-									if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-									{
-										const auto psize = y - offset - 1;
-										NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-										memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-										dataSizeStr.get()[psize] = '\0';
-										originalSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-										dataSizeStr.free();
-
-										offset += psize + 2;
-										break;
-									}
-								}
-							}
-						}
-
-						if (!memcmp(&network.data.get()[offset], NET_RAW_DATA, NET_RAW_DATA_LEN))
-						{
-							offset += NET_RAW_DATA_LEN;
-
-							// read size
-							size_t packetSize = 0;
-							{
-								for (auto y = offset; y < network.data_size; ++y)
-								{
-									if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-									{
-										const auto psize = y - offset - 1;
-										NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-										memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-										dataSizeStr.get()[psize] = '\0';
-										packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-										dataSizeStr.free();
-
-										offset += psize + 2;
-										break;
-									}
-								}
-							}
-
-							Net::RawData_t entry = { (char*)key.get(), &network.data.get()[offset], packetSize, false };
-
-							/* Compression */
-							if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-							{
-								BYTE* copy = ALLOC<BYTE>(entry.size());
-								memcpy(copy, entry.value(), entry.size());
-								entry.set(copy);
-
-								entry.set_original_size(originalSize);
-								DecompressData(entry.value(), entry.size(), entry.original_size());
-								entry.set_original_size(entry.size());
-							}
-
-							/* in seperate thread we need to create a copy of this data-set */
-							if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
-							{
-								BYTE* copy = ALLOC<BYTE>(entry.size());
-								memcpy(copy, entry.value(), entry.size());
-								entry.set(copy);
-							}
-
-							pPacket.get()->AddRaw(entry);
-							key.free();
-
-							offset += packetSize;
-						}
-					}
-
-					// look for data tag
-					if (!memcmp(&network.data.get()[offset], NET_DATA, NET_DATA_LEN))
-					{
-						offset += NET_DATA_LEN;
-
-						// read size
-						size_t packetSize = 0;
-						{
-							for (auto y = offset; y < network.data_size; ++y)
-							{
-								if (!memcmp(&network.data.get()[y], NET_PACKET_BRACKET_CLOSE, 1))
-								{
-									const auto psize = y - offset - 1;
-									NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-									memcpy(dataSizeStr.get(), &network.data.get()[offset + 1], psize);
-									dataSizeStr.get()[psize] = '\0';
-									packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-									dataSizeStr.free();
-
-									offset += psize + 2;
-									break;
-								}
-							}
-						}
-
-						// read the data
-						data = ALLOC<BYTE>(packetSize + 1);
-						memcpy(data.get(), &network.data.get()[offset], packetSize);
-						data.get()[packetSize] = '\0';
-
-						offset += packetSize;
-
-						/* Compression */
-						if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-						{
-							DecompressData(data.reference().get(), packetSize, network.data_original_uncompressed_size);
-						}
-					}
-
-					// we have reached the end of reading
-					if (offset + NET_PACKET_FOOTER_LEN >= network.data_full_size)
-						break;
-
-				} while (true);
-			}
-
-			if (!data.valid())
-			{
-				Disconnect();
-				NET_LOG_PEER(CSTRING("[NET] - JSON data is not valid"));
-				goto loc_packet_free;
-				return;
-			}
-			
-			int packetId = -1;
 			{
 				Net::Json::Document doc;
 				if (!doc.Deserialize(reinterpret_cast<char*>(data.get())))
@@ -2198,7 +1955,7 @@ namespace Net
 			}
 
 			/*
-			* check for option async to execute the callback in a seperate thread
+			* check for option async to execute the callback on the packet worker
 			*/
 			if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
 			{
@@ -2206,7 +1963,10 @@ namespace Net
 				tpe->m_packet = pPacket.get();
 				tpe->m_client = this;
 				tpe->m_packetId = packetId;
-				if (Net::Thread::Create(ThreadPacketExecute, tpe))
+
+				// the receiving thread only serves this connection, it waits until the worker caught up
+				PacketTaskPool.throttle(this);
+				if (PacketTaskPool.post(this, &PacketExecuteTask, tpe))
 				{
 					return;
 				}
@@ -2217,17 +1977,26 @@ namespace Net
 			/*
 			* execute in current thread
 			*/
-			if (!CheckDataN(packetId, *pPacket.ref().get()))
-				if (!CheckData(packetId, *pPacket.ref().get()))
-				{
-					Disconnect();
-					NET_LOG_PEER(CSTRING("[NET] - Frame is not defined"));
-				}
+			{
+#ifdef NET_USE_COROUTINES
+				// without the packet worker a suspended handler continues on the coroutine workers
+				Net::Coroutine::Scope_t scope(PacketPool(), this);
+#endif
+
+				if (!CheckDataN(packetId, *pPacket.ref().get()))
+					if (!CheckData(packetId, *pPacket.ref().get()))
+					{
+						Disconnect();
+						NET_LOG_PEER(CSTRING("[NET] - Frame is not defined"));
+					}
+			}
 
 		loc_packet_free:
 			// if we use compression mode here, then we had to take a copy of the buffer to process the algo to decompress the block, now we have to handle the deletion of this block
+			// the same applies to the copy being taken for the packet worker if it did not accept the packet
 			/* Compression */
-			if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+			if ((Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+				|| (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC))
 			{
 				if (pPacket.get()->HasRawData())
 				{
@@ -2242,6 +2011,153 @@ namespace Net
 			pPacket.free();
 		}
 
+		/*
+		* both framings go through the same view: every length has been validated once, the sections are read in place
+		* both sides agree on cipher and compression before the first frame, the flags have to match them
+		*/
+		bool Client::DecodeFrame(Net::Packet& packet, NET_CPOINTER<BYTE>& data)
+		{
+			const bool cipher = (Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && network.RSAHandshake;
+			const bool compression = Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION;
+			const bool copy = compression || (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC);
+
+			NET_CPOINTER<BYTE> AESKey;
+			size_t AESKeySize = 0;
+			NET_CPOINTER<BYTE> AESIV;
+			size_t AESIVSize = 0;
+			NET_AES aes;
+			bool aes_ready = false;
+
+			const auto fail = [&](const char* reason) -> bool
+			{
+				AESKey.free();
+				AESIV.free();
+				data.free();
+
+				// the raw data copies belong to us until the packet gets executed
+				if (copy)
+				{
+					for (auto& entry : packet.GetRawData())
+						entry.free();
+				}
+
+				Disconnect();
+				NET_LOG_PEER(CSTRING("[NET] - %s"), reason);
+				return false;
+			};
+
+			Net::Framing::View_t view;
+			if (!view.parse(network.data.get(), network.data_full_size))
+				return fail(CSTRING("Received a frame with an invalid header"));
+
+			if (((view.flags() & NET_FRAMING_V2_FLAG_CIPHER) != 0) != cipher
+				|| ((view.flags() & NET_FRAMING_V2_FLAG_COMPRESSION) != 0) != compression)
+				return fail(CSTRING("Received a frame using different options"));
+
+			Net::Framing::section_t section;
+			while (view.next(section))
+			{
+				switch (section.type)
+				{
+				case Net::Framing::Section_t::AES_KEY:
+					if (!cipher || AESKey.valid())
+						return fail(CSTRING("Received an unexpected AES-Key"));
+
+					AESKeySize = section.size;
+					AESKey = ALLOC<BYTE>(AESKeySize + 1);
+					memcpy(AESKey.get(), section.data, AESKeySize);
+					AESKey.get()[AESKeySize] = '\0';
+					break;
+
+				case Net::Framing::Section_t::AES_IV:
+					if (!cipher || AESIV.valid())
+						return fail(CSTRING("Received an unexpected AES-IV"));
+
+					AESIVSize = section.size;
+					AESIV = ALLOC<BYTE>(AESIVSize + 1);
+					memcpy(AESIV.get(), section.data, AESIVSize);
+					AESIV.get()[AESIVSize] = '\0';
+					break;
+
+				default:
+					// key and iv are in front of the first section using them
+					if (cipher && !aes_ready)
+					{
+						if (!AESKey.valid() || !AESIV.valid())
+							return fail(CSTRING("Received a frame without AES-Key & AES-IV"));
+
+						if (!network.RSA.decryptBase64(AESKey.reference().get(), AESKeySize))
+							return fail(CSTRING("Failure on decrypting frame using AES-Key & RSA and Base64"));
+
+						if (!network.RSA.decryptBase64(AESIV.reference().get(), AESIVSize))
+							return fail(CSTRING("Failure on decrypting frame using AES-IV & RSA and Base64"));
+
+						if (!aes.init(reinterpret_cast<const char*>(AESKey.get()), reinterpret_cast<const char*>(AESIV.get())))
+							return fail(CSTRING("Initializing AES failure"));
+
+						AESKey.free();
+						AESIV.free();
+						aes_ready = true;
+					}
+
+					if (section.type == Net::Framing::Section_t::RAW_DATA)
+					{
+						Net::RawData_t entry = { section.key, section.data, section.size, false };
+
+						/* decrypt aes */
+						if (cipher && !aes.decrypt(entry.value(), entry.size()))
+							return fail(CSTRING("Decrypting frame has been failed"));
+
+						/* Compression */
+						if (compression)
+						{
+							BYTE* buffer = ALLOC<BYTE>(entry.size());
+							memcpy(buffer, entry.value(), entry.size());
+							entry.set(buffer);
+
+							entry.set_original_size(section.original_size);
+							DecompressData(entry.value(), entry.size(), entry.original_size());
+							entry.set_original_size(entry.size());
+						}
+						/* in seperate thread we need to create a copy of this data-set */
+						else if (copy)
+						{
+							BYTE* buffer = ALLOC<BYTE>(entry.size());
+							memcpy(buffer, entry.value(), entry.size());
+							entry.set(buffer);
+						}
+
+						packet.AddRaw(entry);
+						break;
+					}
+
+					// one json document per frame
+					if (data.valid())
+						return fail(CSTRING("Received a frame containing more than one data section"));
+
+					size_t dataSize = section.size;
+					data = ALLOC<BYTE>(dataSize + 1);
+					memcpy(data.get(), section.data, dataSize);
+					data.get()[dataSize] = '\0';
+
+					/* decrypt aes */
+					if (cipher && !aes.decrypt(data.get(), dataSize))
+						return fail(CSTRING("Decrypting frame has been failed"));
+
+					/* Compression */
+					if (compression)
+						DecompressData(data.reference().get(), dataSize, section.original_size);
+
+					break;
+				}
+			}
+
+			if (!data.valid())
+				return fail(CSTRING("JSON data is not valid"));
+
+			return true;
+		}
+
 		void Client::CompressData(BYTE*& data, size_t& size)
 		{
 #ifdef DEBUG
@@ -2459,6 +2375,10 @@ namespace Net
 		reply[CSTRING("Revision")] = Version::Revision();
 		const auto Key = Version::Key().get();
 		reply[CSTRING("Key")] = Key.get();
+
+		// older servers ignore it and keep on using the text framing
+		if (UseBinaryFraming()) reply[CSTRING("Framing")] = NET_FRAMING_V2;
+
 		NET_SEND(NET_NATIVE_PACKET_ID::PKG_Version, reply);
 		NET_END_PACKET;
 
@@ -2478,6 +2398,15 @@ namespace Net
 
 		network.estabilished = true;
 
+		// the server has confirmed the binary framing, everything we send from now on uses it
+		if (UseBinaryFraming()
+			&& PKG[CSTRING("Framing")] && PKG[CSTRING("Framing")]->is_int()
+			&& PKG[CSTRING("Framing")]->as_int() == NET_FRAMING_V2)
+		{
+			std::lock_guard<std::mutex> guard(network._mutex_send);
+			network.framing = NET_FRAMING_V2;
+		}
+
 		// Callback
 		// connection has been estabilished, now call entry function
 		OnConnectionEstabilished();
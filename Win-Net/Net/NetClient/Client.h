@@ -33,6 +33,13 @@
 #define NET_END_PACKET }
 #define NET_DECLARE_PACKET(fnc) void On##fnc(NET_PACKET&)
 
+/* NET_USE_COROUTINES: the handler is a coroutine, end it using NET_END_PACKET as well */
+#define NET_BEGIN_PACKET_CO(cs, fnc) Net::Coroutine::Task_t cs::On##fnc(Net::Coroutine::Packet_t packet_owner) { \
+	NET_PACKET& PKG = packet_owner.get(); \
+	const char* NET_FUNCTIONNAME = CASTRING("On"#fnc);
+
+#define NET_DECLARE_PACKET_CO(fnc) Net::Coroutine::Task_t On##fnc(Net::Coroutine::Packet_t)
+
 #define NET_NATIVE_PACKET_DEFINITION_BEGIN(classname) \
 bool classname::CheckDataN(const int id, NET_PACKET& pkg) \
 { \
@@ -48,7 +55,8 @@ switch (id) \
 #define NET_DEFINE_PACKET(xxx, yyy) \
     case yyy: \
     { \
-      On##xxx(pkg); \
+      if (!pkg.IsProbe()) \
+        On##xxx(pkg); \
       break; \
     } \
 
@@ -67,6 +75,10 @@ return true; \
 #include <Net/Net/NetPacket.h>
 #include <Net/Net/NetCodes.h>
 #include <Net/Net/NetVersion.h>
+#include <Net/Net/NetFrame.h>
+#include <Net/Net/NetFraming.h>
+#include <Net/Net/NetTaskPool.h>
+#include <Net/Net/NetCoroutine.h>
 
 #include <Net/Cryption/AES.h>
 #include <Net/Cryption/RSA.h>
@@ -94,7 +106,6 @@ return true; \
 #define NET_NO_ERROR NO_ERROR
 #endif
 
-NET_DSA_BEGIN
 namespace Net
 {
 	namespace Client
@@ -103,7 +114,6 @@ namespace Net
 		{
 			struct Network
 			{
-				byte dataReceive[NET_OPT_DEFAULT_MAX_PACKET_SIZE];
 				NET_CPOINTER<byte> data;
 				size_t data_size;
 				size_t data_full_size;
@@ -115,6 +125,9 @@ namespace Net
 
 				bool estabilished;
 
+				/* framing of the frames we send, the server confirms the binary framing when estabilishing */
+				int framing;
+
 				typeLatency latency;
 				bool bLatency;
 				NET_HANDLE_TIMER hCalcLatency;
@@ -136,7 +149,6 @@ namespace Net
 
 				Network()
 				{
-					memset(dataReceive, 0, NET_OPT_DEFAULT_MAX_PACKET_SIZE);
 					data = nullptr;
 					data_size = 0;
 					data_full_size = 0;
@@ -145,6 +157,7 @@ namespace Net
 					recordingData = false;
 					RSAHandshake = false;
 					estabilished = false;
+					framing = NET_FRAMING_V1;
 					latency = -1;
 					bLatency = false;
 					hCalcLatency = nullptr;
@@ -169,7 +182,7 @@ namespace Net
 			std::mutex _mutex_disconnect;
 
 		private:
-			DWORD optionBitFlag;
+			uint64_t optionBitFlag;
 			std::vector<OptionInterface_t*> option;
 
 			DWORD socketOptionBitFlag;
@@ -201,10 +214,10 @@ namespace Net
 				optionBitFlag |= o.opt;
 			}
 
-			bool Isset(DWORD) const;
+			bool Isset(uint64_t) const;
 
 			template <class T>
-			T GetOption(const DWORD opt)
+			T GetOption(const uint64_t opt)
 			{
 				if (!Isset(opt)) return NULL;
 				for (auto& entry : option)
@@ -249,6 +262,9 @@ namespace Net
 			u_short ServerPort;
 			bool connected;
 
+			/* NET_OPT_EXECUTE_PACKET_ASYNC: a single strand, the packets are executed in the order they have been received */
+			Net::TaskPool::TaskPool_t PacketTaskPool;
+
 			void SetRecordingData(bool);
 
 			/* clear all stored data */
@@ -259,6 +275,8 @@ namespace Net
 			void DecompressData(BYTE*&, size_t&, size_t);
 			void DecompressData(BYTE*&, BYTE*&, size_t&, size_t, bool = false);
 
+			bool SetupConnection();
+
 		public:
 			Client();
 			~Client();
@@ -267,6 +285,10 @@ namespace Net
 
 			char* ResolveHostname(const char*);
 			bool Connect(const char*, u_short);
+#ifdef BUILD_LINUX
+			/* linux only: connect to a server listening on an AF_UNIX stream socket (NET_OPT_UNIX_PATH) */
+			bool ConnectUnix(const char*);
+#endif
 			bool Disconnect();
 			void Clear();
 
@@ -286,26 +308,45 @@ namespace Net
 			size_t GetReceivedPacketSize() const;
 			float GetReceivedPacketSizeAsPerc() const;
 
+			/* NET_OPT_EXECUTE_PACKET_ASYNC: packets waiting for their execution, the highest amount seen and how often receiving had to wait */
+			size_t GetPacketQueueDepth() const;
+			size_t GetPacketQueuePeak() const;
+			size_t GetPacketQueueThrottled() const;
+
+			/* the packet worker if it is running */
+			Net::TaskPool::TaskPool_t* PacketPool();
+
 			bool bReceiveThread;
 			DWORD DoReceive();
+			DWORD DoReceive(const byte*, int64);
 
 		public:
 			bool CheckDataN(int id, NET_PACKET& pkg);
 			NET_DEFINE_CALLBACK(bool, CheckData, const int id, NET_PACKET& pkg) { return false; }
 
+			/* asks the packet definitions without executing them, only if NET_OPT_REJECT_UNKNOWN_PACKETS has been enabled */
+			bool IsPacketDefined(int id);
+
 		private:
 			void SingleSend(const char*, size_t, bool&, uint32_t = INVALID_UINT_SIZE);
 			void SingleSend(BYTE*&, size_t, bool&, uint32_t = INVALID_UINT_SIZE);
 			void SingleSend(NET_CPOINTER<BYTE>&, size_t, bool&, uint32_t = INVALID_UINT_SIZE);
 			void SingleSend(Net::RawData_t&, bool&, uint32_t = INVALID_UINT_SIZE);
+			bool SendFrame(Net::Frame::Frame_t&);
 
 		public:
 			void DoSend(int, NET_PACKET&);
 
 		private:
 			bool ValidHeader(bool&);
+			bool ProcessPacket();
 			void ProcessPackets();
 			void ExecutePacket();
+
+			/* binary framing */
+			bool UseBinaryFraming();
+			bool ProcessFrame();
+			bool DecodeFrame(Net::Packet&, NET_CPOINTER<BYTE>&);
 			bool CreateTOTPSecret();
 
 			NET_DECLARE_PACKET(RSAHandshake);
@@ -325,4 +366,3 @@ namespace Net
 		};
 	}
 }
-NET_DSA_END
\ No newline at end of file
@@ -26,6 +26,13 @@
 #include <Net/Import/Kernel32.hpp>
 #include <Net/Import/Ws2_32.hpp>
 
+#ifdef BUILD_LINUX
+#include <linux/errqueue.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
 Net::Server::IPRef::IPRef(const char* pointer)
 {
 	this->pointer = (char*)pointer;
@@ -50,6 +57,7 @@ Net::Server::Server::Server()
 	hReSyncClockNTP = nullptr;
 	optionBitFlag = 0;
 	socketOptionBitFlag = 0;
+	CorkedPeerFlushing = nullptr;
 }
 
 Net::Server::Server::~Server()
@@ -65,7 +73,7 @@ Net::Server::Server::~Server()
 	option.clear();
 }
 
-bool Net::Server::Server::Isset(const DWORD opt) const
+bool Net::Server::Server::Isset(const uint64_t opt) const
 {
 	// use the bit flag to perform faster checks
 	return optionBitFlag & opt;
@@ -78,54 +86,121 @@ bool Net::Server::Server::Isset_SocketOpt(const DWORD opt) const
 }
 
 #pragma region Network Structure
-void Net::Server::Server::network_t::setData(byte* pointer)
+void Net::Server::Server::network_t::deallocData()
 {
-	deallocData();
-	_data = pointer;
+	_data.free();
+	_data_capacity = 0;
+	_data_read = 0;
+	_data_write = 0;
 }
 
-void Net::Server::Server::network_t::allocData(const size_t size)
+bool Net::Server::Server::network_t::reserveData(const size_t size)
 {
-	clear();
-	_data = ALLOC<byte>(size + 1);
-	memset(getData(), NULL, size * sizeof(byte));
-	getData()[size] = '\0';
+	// one extra byte to keep the buffer null terminated
+	if (_data_capacity - _data_read >= size + 1)
+		return true;
 
-	setDataSize(size);
-}
+	const auto unread = _data_write - _data_read;
+
+	// enough space if we move the unread bytes to the front
+	if (_data_capacity >= size + 1)
+	{
+		memmove(_data.get(), _data.get() + _data_read, unread);
+		_data_read = 0;
+		_data_write = unread;
+		_data.get()[_data_write] = '\0';
+		return true;
+	}
+
+	auto capacity = _data_capacity * 2;
+	if (capacity < size + 1)
+		capacity = size + 1;
+
+	const auto newBuffer = ALLOC<byte>(capacity);
+	if (!newBuffer)
+		return false;
+
+	if (unread > 0)
+		memcpy(newBuffer, _data.get() + _data_read, unread);
+
+	newBuffer[unread] = '\0';
 
-void Net::Server::Server::network_t::deallocData()
-{
 	_data.free();
+	_data = newBuffer; // pointer swap
+	_data_capacity = capacity;
+	_data_read = 0;
+	_data_write = unread;
+	return true;
 }
 
-byte* Net::Server::Server::network_t::getData() const
+bool Net::Server::Server::network_t::appendData(const byte* data, size_t size)
 {
-	return _data.get();
+	// the rest of a dropped frame, never stored
+	if (_data_skip > 0)
+	{
+		const auto skip = (_data_skip < size ? _data_skip : size);
+		_data_skip -= skip;
+		data += skip;
+		size -= skip;
+
+		if (!size)
+			return true;
+	}
+
+	if (!reserveData(getDataSize() + size))
+		return false;
+
+	memcpy(_data.get() + _data_write, data, size);
+	_data_write += size;
+	_data.get()[_data_write] = '\0';
+	return true;
 }
 
-void Net::Server::Server::network_t::reset()
+void Net::Server::Server::network_t::consumeData(const size_t size)
 {
-	memset(_dataReceive, NULL, NET_OPT_DEFAULT_MAX_PACKET_SIZE);
+	_data_read += size;
+	if (_data_read < _data_write)
+		return;
+
+	// everything has been consumed, an idle peer does not keep a receive buffer
+	deallocData();
 }
 
-void Net::Server::Server::network_t::clear()
+void Net::Server::Server::network_t::skipData(const size_t size)
 {
-	deallocData();
-	_data_size = 0;
+	const auto buffered = getDataSize();
+	if (size > buffered)
+	{
+		_data_skip = size - buffered;
+		consumeData(buffered);
+	}
+	else
+	{
+		consumeData(size);
+	}
+
 	_data_full_size = 0;
 	_data_offset = 0;
 	_data_original_uncompressed_size = 0;
 }
 
-void Net::Server::Server::network_t::setDataSize(const size_t size)
+byte* Net::Server::Server::network_t::getData() const
+{
+	return _data.get() + _data_read;
+}
+
+void Net::Server::Server::network_t::clear()
 {
-	_data_size = size;
+	deallocData();
+	_data_full_size = 0;
+	_data_offset = 0;
+	_data_original_uncompressed_size = 0;
+	_data_skip = 0;
 }
 
 size_t Net::Server::Server::network_t::getDataSize() const
 {
-	return _data_size;
+	return _data_write - _data_read;
 }
 
 void Net::Server::Server::network_t::setDataFullSize(const size_t size)
@@ -165,7 +240,86 @@ bool Net::Server::Server::network_t::dataValid() const
 
 byte* Net::Server::Server::network_t::getDataReceive()
 {
-	return _dataReceive;
+	return Net::ReceiveBuffer();
+}
+
+Net::Server::Server::network_t::send_queue_t* Net::Server::Server::network_t::getSendQueue()
+{
+	if (!_send)
+		_send = ALLOC<send_queue_t>();
+
+	return _send;
+}
+
+/* the queues are dropped as soon as everything went out */
+void Net::Server::Server::network_t::releaseSendQueue()
+{
+	if (!_send || !_send->queue.empty())
+		return;
+
+	for (const auto& lane : _send->lanes)
+	{
+		if (!lane.empty())
+			return;
+	}
+
+#ifdef BUILD_LINUX
+	if (!_send->zerocopy_pending.empty())
+		return;
+#endif
+
+	FREE<send_queue_t>(_send);
+	_send = nullptr;
+	_send_queue_committed = 0;
+}
+
+/* moves frames out of their lanes into the wire order, higher lanes first */
+void Net::Server::Server::network_t::commitSendQueue()
+{
+	if (!_send)
+		return;
+
+	while (_send_queue_committed < NET_SEND_COMMIT_SIZE)
+	{
+		const auto lane = _send_scheduler.next(_send->lanes);
+		if (lane == -1)
+			break;
+
+		auto frame = _send->lanes[lane].front();
+		_send->lanes[lane].pop_front();
+
+		_send->queue.emplace_back(frame);
+		_send_queue_committed += frame->remaining();
+	}
+}
+
+void Net::Server::Server::network_t::clearSendQueue()
+{
+	_send_queue_committed = 0;
+	_send_queue_size = 0;
+	_send_queue_full = false;
+	_send_corked = 0;
+
+	if (!_send)
+		return;
+
+	for (auto& lane : _send->lanes)
+	{
+		for (auto& frame : lane)
+			FREE<Net::Frame::Frame_t>(frame);
+	}
+
+	for (auto& frame : _send->queue)
+		FREE<Net::Frame::Frame_t>(frame);
+
+#ifdef BUILD_LINUX
+	// the connection is gone, nobody is going to look at the pinned pages anymore
+	for (auto& entry : _send->zerocopy_pending)
+		FREE<Net::Frame::Frame_t>(entry.second);
+#endif
+
+	FREE<send_queue_t>(_send);
+	_send = nullptr;
 }
 #pragma endregion
 
@@ -244,11 +398,45 @@ NET_TIMER(NTPReSyncClock)
 
 Net::Server::Server::peerInfo* Net::Server::Server::CreatePeer(const sockaddr_in client_addr, const SOCKET socket)
 {
+	// admission control, unix sockets do not have an address to count
+	bool bCountedAddress = false;
+	const auto max_connections = Isset(NET_OPT_MAX_CONNECTIONS_PER_IP) ? GetOption<size_t>(NET_OPT_MAX_CONNECTIONS_PER_IP) : NET_OPT_DEFAULT_MAX_CONNECTIONS_PER_IP;
+	if (max_connections > 0 && client_addr.sin_family == AF_INET)
+	{
+		std::lock_guard<std::mutex> guard(ConnectionsPerIPMutex);
+
+		auto& connections = ConnectionsPerIP[client_addr.sin_addr.s_addr];
+		if (connections >= max_connections)
+		{
+			char buf[INET_ADDRSTRLEN] = {};
+			Ws2_32::inet_ntop(AF_INET, &client_addr.sin_addr, buf, INET_ADDRSTRLEN);
+			NET_LOG_PEER(CSTRING("'%s' :: [%s] => rejected, too many connections from the same address"), SERVERNAME(this), buf);
+
+			Ws2_32::closesocket(socket);
+			++RateLimitCounters.rejected;
+			return nullptr;
+		}
+
+		++connections;
+		bCountedAddress = true;
+	}
+
 	// UniqueID is equal to socket, since socket is already an unique ID
 	const auto peer = ALLOC<NET_IPEER>();
 	peer->UniqueID = socket;
 	peer->pSocket = socket;
 	peer->client_addr = client_addr;
+	peer->bCountedAddress = bCountedAddress;
+
+	// the buckets start full, soo a peer is allowed to burst right away
+	const auto burst = static_cast<double>(Isset(NET_OPT_RATE_LIMIT_BURST) ? GetOption<int>(NET_OPT_RATE_LIMIT_BURST) : NET_OPT_DEFAULT_RATE_LIMIT_BURST) / 1000.0;
+	const auto rate_bytes = static_cast<double>(Isset(NET_OPT_RATE_LIMIT_BYTES) ? GetOption<size_t>(NET_OPT_RATE_LIMIT_BYTES) : NET_OPT_DEFAULT_RATE_LIMIT_BYTES);
+	const auto rate_packets = static_cast<double>(Isset(NET_OPT_RATE_LIMIT_PACKETS) ? GetOption<size_t>(NET_OPT_RATE_LIMIT_PACKETS) : NET_OPT_DEFAULT_RATE_LIMIT_PACKETS);
+	peer->bytes_bucket.set(rate_bytes, rate_bytes * burst);
+	peer->packets_bucket.set(rate_packets, rate_packets * burst);
+
+	if (Isset(NET_OPT_COALESCE) ? GetOption<bool>(NET_OPT_COALESCE) : NET_OPT_DEFAULT_COALESCE)
+		peer->network._send_coalesce = true;
 
 	/* Set Read Timeout */
 	timeval tv = {};
@@ -259,6 +447,10 @@ Net::Server::Server::peerInfo* Net::Server::Server::CreatePeer(const sockaddr_in
 	// Set socket options
 	for (const auto& entry : socketoption)
 	{
+		// there is no TCP layer on unix sockets
+		if (client_addr.sin_family == AF_UNIX && entry->level == IPPROTO_TCP)
+			continue;
+
 		const auto res = Ws2_32::setsockopt(peer->pSocket, entry->level, entry->opt, entry->value(), entry->optlen());
 		if (res == SOCKET_ERROR) NET_LOG_ERROR(CSTRING("'%s' => unable to apply socket option { %i : %i }"), SERVERNAME(this), entry->opt, LAST_ERROR);
 	}
@@ -282,6 +474,21 @@ Net::Server::Server::peerInfo* Net::Server::Server::CreatePeer(const sockaddr_in
 	return peer;
 }
 
+#ifdef NET_USE_COROUTINES
+struct TPeerErase
+{
+	Net::Server::Server* m_server;
+	NET_PEER m_peer;
+};
+
+static void PeerEraseTask(void* param)
+{
+	auto erase = (TPeerErase*)param;
+	erase->m_server->FinishErasePeer(erase->m_peer);
+	FREE<TPeerErase>(erase);
+}
+#endif
+
 bool Net::Server::Server::ErasePeer(NET_PEER peer, bool clear)
 {
 	PEER_NOT_VALID(peer,
@@ -290,62 +497,119 @@ bool Net::Server::Server::ErasePeer(NET_PEER peer, bool clear)
 
 	if (clear)
 	{
-		// close endpoint
-		SOCKET_VALID(peer->pSocket)
+		// broadcasts must not see it cleared either, a running one finishes first
+		PeerRegistry.remove(peer->UniqueID);
+
+		// the same applies to the coalescing thread
+		Uncork(peer);
+
+		if (peer->bCountedAddress)
+		{
+			std::lock_guard<std::mutex> guard(ConnectionsPerIPMutex);
+
+			const auto it = ConnectionsPerIP.find(peer->client_addr.sin_addr.s_addr);
+			if (it != ConnectionsPerIP.end() && --it->second == 0)
+				ConnectionsPerIP.erase(it);
+
+			peer->bCountedAddress = false;
+		}
+
+		// the packets of this peer that are still queued must not see it cleared
+		PacketPipelinePool.wait(peer);
+		PacketTaskPool.wait(peer);
+
+#ifdef NET_USE_COROUTINES
+		/*
+		* suspended handlers of this peer must not see it cleared either, the last one of them finishes the erase
+		* nobody drains the inbox of the peer anymore, they continue on the coroutine workers
+		*/
+		peer->coroutines.close(peer);
+
+		const auto erase = ALLOC<TPeerErase>();
+		if (erase)
+		{
+			erase->m_server = this;
+			erase->m_peer = peer;
+			Net::Coroutine::WhenFinished(peer, &PeerEraseTask, erase);
+			return true;
+		}
+
+		Net::Coroutine::Wait(peer);
+#endif
+
+		FinishErasePeer(peer);
+		return true;
+	}
+
+	/*
+	* the reactor does not visit idle peers
+	* shutting down the receiving side will wake up the owning worker to perform the cleanup
+	*/
+#ifdef BUILD_LINUX
+	if (!peer->bErase && PeerReactorManager.is_running())
+	{
+		peer->bErase = true;
+		SOCKET_VALID(peer->pSocket) Ws2_32::shutdown(peer->pSocket, SOCKET_RD);
+		return true;
+	}
+#endif
+
+	peer->bErase = true;
+	return true;
+}
+
+void Net::Server::Server::FinishErasePeer(NET_PEER peer)
+{
+	// close endpoint
+	SOCKET_VALID(peer->pSocket)
+	{
+		bool bBlocked = false;
+		do
 		{
-			bool bBlocked = false;
-			do
+			bBlocked = false;
+			Ws2_32::shutdown(peer->pSocket, SOCKET_WR);
+			if (Ws2_32::closesocket(peer->pSocket) == SOCKET_ERROR)
 			{
-				bBlocked = false;
-				Ws2_32::shutdown(peer->pSocket, SOCKET_WR);
-				if (Ws2_32::closesocket(peer->pSocket) == SOCKET_ERROR)
-				{
 #ifdef BUILD_LINUX
-					if (errno == EWOULDBLOCK)
+				if (errno == EWOULDBLOCK)
 #else
-					if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
+				if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
 #endif
-					{
-						bBlocked = true;
+				{
+					bBlocked = true;
 #ifdef BUILD_LINUX
-						usleep(FREQUENZ(this) * 1000);
+					usleep(FREQUENZ(this) * 1000);
 #else
-						Kernel32::Sleep(FREQUENZ(this));
+					Kernel32::Sleep(FREQUENZ(this));
 #endif
-					}
 				}
+			}
 
-			} while (bBlocked);
+		} while (bBlocked);
 
-			peer->pSocket = INVALID_SOCKET;
-		}
+		peer->pSocket = INVALID_SOCKET;
+	}
 
-		Net::Timer::WaitSingleObjectStopped(peer->hWaitForNetProtocol);
-		peer->hWaitForNetProtocol = nullptr;
+	Net::Timer::WaitSingleObjectStopped(peer->hWaitForNetProtocol);
+	peer->hWaitForNetProtocol = nullptr;
 
-		if (peer->hCalcLatency)
-		{
-			// stop latency interval
-			//Timer::WaitSingleObjectStopped(peer->hCalcLatency);
-			peer->hCalcLatency = nullptr;
-		}
+	if (peer->hCalcLatency)
+	{
+		// stop latency interval
+		//Timer::WaitSingleObjectStopped(peer->hCalcLatency);
+		peer->hCalcLatency = nullptr;
+	}
 
-		// callback
+	// callback
 #ifdef BUILD_LINUX
-		OnPeerDisconnect(peer, errno);
+	OnPeerDisconnect(peer, errno);
 #else
-		OnPeerDisconnect(peer, Ws2_32::WSAGetLastError());
+	OnPeerDisconnect(peer, Ws2_32::WSAGetLastError());
 #endif
 
-		NET_LOG_PEER(CSTRING("'%s' :: [%s] => finished"), SERVERNAME(this), peer->IPAddr().get());
-
-		peer->clear();
-
-		return true;
-	}
+	NET_LOG_PEER(CSTRING("'%s' :: [%s] => finished"), SERVERNAME(this), peer->IPAddr().get());
 
-	peer->bErase = true;
-	return true;
+	peer->clear();
 }
 
 size_t Net::Server::Server::GetNextPacketSize(NET_PEER peer)
@@ -395,12 +659,22 @@ void Net::Server::Server::peerInfo::clear()
 	client_addr = sockaddr_in();
 	estabilished = false;
 	NetVersionMatched = false;
+	framing = NET_FRAMING_V1;
 	bErase = false;
+	bytes_bucket = Net::RateLimit::Bucket_t();
+	packets_bucket = Net::RateLimit::Bucket_t();
+	bDelayed = false;
+	bCountedAddress = false;
 	latency = -1;
 	hCalcLatency = nullptr;
 
 	network.clear();
-	network.reset();
+
+	{
+		std::lock_guard<std::mutex> guard(network._mutex_send);
+		network.clearSendQueue();
+		network._send_coalesce = false;
+	}
 
 	cryption.deleteKeyPair();
 
@@ -408,6 +682,29 @@ void Net::Server::Server::peerInfo::clear()
 	totp_secret_len = 0;
 	curToken = 0;
 	lastToken = 0;
+
+	stream.clear();
+}
+
+void Net::Server::Server::peerInfo::stream_t::clear()
+{
+	state = State_t::IDLE;
+	id = -1;
+	cipher = false;
+	paused = false;
+	started = false;
+
+	reader.end();
+
+	FREE<NET_AES>(aes);
+	aes = nullptr;
+
+	key.free();
+	key_size = 0;
+	iv.free();
+	iv_size = 0;
+	json.free();
+	json_size = 0;
 }
 
 typeLatency Net::Server::Server::peerInfo::getLatency() const
@@ -418,6 +715,14 @@ typeLatency Net::Server::Server::peerInfo::getLatency() const
 Net::Server::IPRef Net::Server::Server::peerInfo::IPAddr() const
 {
 	const auto buf = ALLOC<char>(INET_ADDRSTRLEN);
+
+	// same host peer, there is no address to show
+	if (client_addr.sin_family == AF_UNIX)
+	{
+		strcpy(buf, CSTRING("unix"));
+		return IPRef(buf);
+	}
+
 	return IPRef(Ws2_32::inet_ntop(AF_INET, &client_addr.sin_addr, buf, INET_ADDRSTRLEN));
 }
 
@@ -491,6 +796,15 @@ NET_THREAD(TickThread)
 	return 0;
 }
 
+NET_THREAD(CoalesceThread)
+{
+	const auto server = (Net::Server::Server*)parameter;
+	if (!server) return 0;
+
+	server->FlushCorkedLoop();
+	return 0;
+}
+
 NET_THREAD(AcceptorThread)
 {
 	const auto server = (Net::Server::Server*)parameter;
@@ -514,82 +828,282 @@ static void usleep_wrapper(DWORD duration)
 {
 	usleep(duration * 1000);
 }
-#endif
 
-bool Net::Server::Server::Run()
+struct Listener_t
 {
-	if (IsRunning())
-		return false;
+	Net::Server::Server* server;
+	SOCKET socket;
+	size_t worker;
+};
 
-	// our sockets for the server
-	SetListenSocket(INVALID_SOCKET);
+static Net::PeerPool::WorkStatus_t ListenerWorker(void* pdata)
+{
+	const auto data = (Listener_t*)pdata;
+	if (!data) return Net::PeerPool::WorkStatus_t::STOP;
 
-	// address info for the server to listen to
-	addrinfo* result = nullptr;
-	int res = 0;
+	// the listener stays registered until the reactor gets stopped
+	data->server->DrainAcceptor(data->socket, data->worker);
+	return Net::PeerPool::WorkStatus_t::CONTINUE;
+}
 
-#ifndef BUILD_LINUX
-	WSADATA wsaData;
-	res = Ws2_32::WSAStartup(MAKEWORD(2, 2), &wsaData);
-	if (res != NULL)
-	{
-		NET_LOG_ERROR(CSTRING("'%s' => [WSAStartup] failed with error: %d"), SERVERNAME(this), res);
-		return false;
-	}
+static Net::PeerPool::WorkStatus_t ListenerAccept(void* pdata, byte*, int64 size)
+{
+	const auto data = (Listener_t*)pdata;
+	if (!data) return Net::PeerPool::WorkStatus_t::STOP;
 
-	if (LOBYTE(wsaData.wVersion) != 2 || HIBYTE(wsaData.wVersion) != 2)
+	// io_uring hands out the accepted socket as result
+	if (size < 0)
 	{
-		NET_LOG_ERROR(CSTRING("'%s' => unable to find usable version of [Winsock.dll]"), SERVERNAME(this));
-		Ws2_32::WSACleanup();
-		return false;
+		if (size != -ECONNABORTED && size != -EINTR)
+			NET_LOG_ERROR(CSTRING("'%s' => [accept] failed with error %d"), SERVERNAME(data->server), static_cast<int>(-size));
+
+		return Net::PeerPool::WorkStatus_t::CONTINUE;
 	}
-#endif
 
-	// set address information
-	struct addrinfo hints = {};
-	hints.ai_family = AF_INET;
-	hints.ai_socktype = SOCK_STREAM;
-	hints.ai_protocol = IPPROTO_TCP;
-	hints.ai_flags = AI_PASSIVE;
+	data->server->AcceptPeer(static_cast<SOCKET>(size), data->worker);
+	return Net::PeerPool::WorkStatus_t::CONTINUE;
+}
 
-	const auto Port = std::to_string(Isset(NET_OPT_PORT) ? GetOption<u_short>(NET_OPT_PORT) : NET_OPT_DEFAULT_PORT);
-	res = Ws2_32::getaddrinfo(NULLPTR, Port.data(), &hints, &result);
+static void OnListenerDelete(void* pdata)
+{
+	const auto data = (Listener_t*)pdata;
+	if (!data) return;
 
-	if (res != 0) {
-		NET_LOG_ERROR(CSTRING("'%s' => [getaddrinfo] failed with error: %d"), SERVERNAME(this), res);
-#ifndef BUILD_LINUX
-		Ws2_32::WSACleanup();
-#endif
+	// the primary listen socket gets closed by Close()
+	if (data->socket != INVALID_SOCKET && data->socket != data->server->GetListenSocket())
+		Ws2_32::closesocket(data->socket);
+
+	FREE<Listener_t>(data);
+}
+
+bool Net::Server::Server::UseReusePort()
+{
+	if (!(Isset(NET_OPT_USE_REACTOR) ? GetOption<bool>(NET_OPT_USE_REACTOR) : NET_OPT_DEFAULT_USE_REACTOR))
 		return false;
-	}
 
-	// Create a SOCKET for connecting to server
-	SetListenSocket(Ws2_32::socket(result->ai_family, result->ai_socktype, result->ai_protocol));
+	// reuseport groups are only supported for TCP and UDP
+	if (UnixPath())
+		return false;
 
-	if (GetListenSocket() == INVALID_SOCKET)
+	return Isset(NET_OPT_REUSEPORT) ? GetOption<bool>(NET_OPT_REUSEPORT) : NET_OPT_DEFAULT_REUSEPORT;
+}
+
+SOCKET Net::Server::Server::CreateReusePortListener()
+{
+	// bind to the same address as the primary listen socket
+	sockaddr_storage addr = {};
+	socklen_t addrlen = sizeof(addr);
+	if (Ws2_32::getsockname(GetListenSocket(), (sockaddr*)&addr, &addrlen) == SOCKET_ERROR)
 	{
-		NET_LOG_ERROR(CSTRING("'%s' => creation of a listener socket failed with error: %ld"), SERVERNAME(this), LAST_ERROR);
-		Ws2_32::freeaddrinfo(result);
-#ifndef BUILD_LINUX
-		Ws2_32::WSACleanup();
-#endif
-		return false;
+		NET_LOG_ERROR(CSTRING("'%s' => [getsockname] failed with error: %d"), SERVERNAME(this), LAST_ERROR);
+		return INVALID_SOCKET;
 	}
 
-	// Set the mode of the socket to be nonblocking
-	unsigned long iMode = 1;
-	res = Ws2_32::ioctlsocket(GetListenSocket(), FIONBIO, &iMode);
+	const SOCKET listen_socket = Ws2_32::socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+	if (listen_socket == INVALID_SOCKET)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => creation of a listener socket failed with error: %ld"), SERVERNAME(this), LAST_ERROR);
+		return INVALID_SOCKET;
+	}
 
-	if (res == SOCKET_ERROR)
+	int reuse = 1;
+	if (Ws2_32::setsockopt(listen_socket, SOL_SOCKET, SO_REUSEPORT, (SOCKET_OPT_TYPE)&reuse, sizeof(reuse)) == SOCKET_ERROR
+		|| Ws2_32::bind(listen_socket, (sockaddr*)&addr, addrlen) == SOCKET_ERROR
+		|| Ws2_32::listen(listen_socket, SOMAXCONN) == SOCKET_ERROR)
 	{
-		NET_LOG_ERROR(CSTRING("'%s' => [ioctlsocket] failed with error: %d"), SERVERNAME(this), LAST_ERROR);
-		Ws2_32::closesocket(GetListenSocket());
-#ifndef BUILD_LINUX
-		Ws2_32::WSACleanup();
-#endif
-		return false;
+		NET_LOG_ERROR(CSTRING("'%s' => unable to setup [SO_REUSEPORT] listener with error: %d"), SERVERNAME(this), LAST_ERROR);
+		Ws2_32::closesocket(listen_socket);
+		return INVALID_SOCKET;
 	}
 
+	return listen_socket;
+}
+
+const char* Net::Server::Server::UnixPath()
+{
+	return Isset(NET_OPT_UNIX_PATH) ? GetOption<char*>(NET_OPT_UNIX_PATH) : NET_OPT_DEFAULT_UNIX_PATH;
+}
+
+SOCKET Net::Server::Server::CreateUnixListener(const char* path)
+{
+	sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path))
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => unix socket path '%s' is too long"), SERVERNAME(this), path);
+		return INVALID_SOCKET;
+	}
+
+	strcpy(addr.sun_path, path);
+
+	const SOCKET listen_socket = Ws2_32::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (listen_socket == INVALID_SOCKET)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => creation of a listener socket failed with error: %ld"), SERVERNAME(this), LAST_ERROR);
+		return INVALID_SOCKET;
+	}
+
+	/*
+	* a crashed server leaves its socket file behind, binding would fail with EADDRINUSE
+	* only remove it if nobody is listening on it anymore
+	*/
+	struct stat st = {};
+	if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+	{
+		const SOCKET probe = Ws2_32::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (probe != INVALID_SOCKET)
+		{
+			if (Ws2_32::connect(probe, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR && errno == ECONNREFUSED)
+				unlink(path);
+
+			Ws2_32::closesocket(probe);
+		}
+	}
+
+	if (Ws2_32::bind(listen_socket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR
+		|| Ws2_32::listen(listen_socket, SOMAXCONN) == SOCKET_ERROR)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => unable to listen on unix socket '%s' with error: %d"), SERVERNAME(this), path, LAST_ERROR);
+		Ws2_32::closesocket(listen_socket);
+		return INVALID_SOCKET;
+	}
+
+	return listen_socket;
+}
+
+bool Net::Server::Server::UseZeroCopy(NET_PEER peer, const size_t size)
+{
+	const auto threshold = Isset(NET_OPT_ZEROCOPY_THRESHOLD) ? GetOption<size_t>(NET_OPT_ZEROCOPY_THRESHOLD) : NET_OPT_DEFAULT_ZEROCOPY_THRESHOLD;
+	if (threshold == 0 || size < threshold)
+		return false;
+
+	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+
+	// has to be enabled once per socket
+	if (peer->network._zerocopy == 0)
+	{
+		int one = 1;
+		if (Ws2_32::setsockopt(peer->pSocket, SOL_SOCKET, SO_ZEROCOPY, (SOCKET_OPT_TYPE)&one, sizeof(one)) == SOCKET_ERROR)
+		{
+			NET_LOG_PEER(CSTRING("'%s' :: [%s] => [SO_ZEROCOPY] is not supported, error: %d"), SERVERNAME(this), peer->IPAddr().get(), LAST_ERROR);
+			peer->network._zerocopy = -1;
+		}
+		else
+		{
+			peer->network._zerocopy = 1;
+		}
+	}
+
+	return peer->network._zerocopy == 1;
+}
+
+/*
+* releases zero copy frames the kernel is done with
+* the completions are read from the error queue of the socket
+* requires peer->network._mutex_send to be locked
+*/
+void Net::Server::Server::ReapZeroCopy(NET_PEER peer)
+{
+	if (!peer->network._send)
+		return;
+
+	auto& pending = peer->network._send->zerocopy_pending;
+	while (!pending.empty())
+	{
+		char control[128];
+		msghdr msg = {};
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		if (Ws2_32::recvmsg(peer->pSocket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == SOCKET_ERROR)
+			return;
+
+		for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+				&& !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+				continue;
+
+			const auto serr = (sock_extended_err*)CMSG_DATA(cmsg);
+			if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+				continue;
+
+			// completions arrive in order, everything up to ee_data has been released
+			while (!pending.empty() && static_cast<int32_t>(pending.front().first - serr->ee_data) <= 0)
+			{
+				FREE<Net::Frame::Frame_t>(pending.front().second);
+				pending.pop_front();
+			}
+		}
+	}
+}
+#endif
+
+bool Net::Server::Server::CreateTCPListener()
+{
+	// address info for the server to listen to
+	addrinfo* result = nullptr;
+	int res = 0;
+
+	// set address information
+	struct addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	hints.ai_flags = AI_PASSIVE;
+
+	const auto Port = std::to_string(Isset(NET_OPT_PORT) ? GetOption<u_short>(NET_OPT_PORT) : NET_OPT_DEFAULT_PORT);
+	res = Ws2_32::getaddrinfo(NULLPTR, Port.data(), &hints, &result);
+
+	if (res != 0) {
+		NET_LOG_ERROR(CSTRING("'%s' => [getaddrinfo] failed with error: %d"), SERVERNAME(this), res);
+#ifndef BUILD_LINUX
+		Ws2_32::WSACleanup();
+#endif
+		return false;
+	}
+
+	// Create a SOCKET for connecting to server
+	SetListenSocket(Ws2_32::socket(result->ai_family, result->ai_socktype, result->ai_protocol));
+
+	if (GetListenSocket() == INVALID_SOCKET)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => creation of a listener socket failed with error: %ld"), SERVERNAME(this), LAST_ERROR);
+		Ws2_32::freeaddrinfo(result);
+#ifndef BUILD_LINUX
+		Ws2_32::WSACleanup();
+#endif
+		return false;
+	}
+
+	// Set the mode of the socket to be nonblocking
+	unsigned long iMode = 1;
+	res = Ws2_32::ioctlsocket(GetListenSocket(), FIONBIO, &iMode);
+
+	if (res == SOCKET_ERROR)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => [ioctlsocket] failed with error: %d"), SERVERNAME(this), LAST_ERROR);
+		Ws2_32::closesocket(GetListenSocket());
+#ifndef BUILD_LINUX
+		Ws2_32::WSACleanup();
+#endif
+		return false;
+	}
+
+#ifdef BUILD_LINUX
+	// every listen socket of the group has to be flagged before binding it
+	if (UseReusePort())
+	{
+		int reuse = 1;
+		if (Ws2_32::setsockopt(GetListenSocket(), SOL_SOCKET, SO_REUSEPORT, (SOCKET_OPT_TYPE)&reuse, sizeof(reuse)) == SOCKET_ERROR)
+		{
+			NET_LOG_ERROR(CSTRING("'%s' => unable to set [SO_REUSEPORT] with error: %d"), SERVERNAME(this), LAST_ERROR);
+			Ws2_32::freeaddrinfo(result);
+			Ws2_32::closesocket(GetListenSocket());
+			return false;
+		}
+	}
+#endif
+
 	// Setup the TCP listening socket
 	res = Ws2_32::bind(GetListenSocket(), result->ai_addr, static_cast<int>(result->ai_addrlen));
 
@@ -619,6 +1133,47 @@ bool Net::Server::Server::Run()
 		return false;
 	}
 
+	return true;
+}
+
+bool Net::Server::Server::Run()
+{
+	if (IsRunning())
+		return false;
+
+	// our sockets for the server
+	SetListenSocket(INVALID_SOCKET);
+
+#ifndef BUILD_LINUX
+	WSADATA wsaData;
+	const int res = Ws2_32::WSAStartup(MAKEWORD(2, 2), &wsaData);
+	if (res != NULL)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => [WSAStartup] failed with error: %d"), SERVERNAME(this), res);
+		return false;
+	}
+
+	if (LOBYTE(wsaData.wVersion) != 2 || HIBYTE(wsaData.wVersion) != 2)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => unable to find usable version of [Winsock.dll]"), SERVERNAME(this));
+		Ws2_32::WSACleanup();
+		return false;
+	}
+#endif
+
+#ifdef BUILD_LINUX
+	// same host traffic skips the TCP/IP stack
+	if (UnixPath())
+	{
+		SetListenSocket(CreateUnixListener(UnixPath()));
+		if (GetListenSocket() == INVALID_SOCKET)
+			return false;
+	}
+	else
+#endif
+	if (!CreateTCPListener())
+		return false;
+
 	// Create all needed Threads
 	// spawn timer thread to sync clock with ntp - only effects having 2-step enabled
 	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
@@ -639,7 +1194,86 @@ bool Net::Server::Server::Run()
 		}
 	}
 
-	PeerPoolManager.set_max_peers(4);
+	Net::Thread::Attributes_t worker_attributes;
+	const auto worker_cpus = Isset(NET_OPT_WORKER_CPUS) ? GetOption<char*>(NET_OPT_WORKER_CPUS) : NET_OPT_DEFAULT_WORKER_CPUS;
+	if (worker_cpus && !Net::Thread::ParseCpuList(worker_cpus, worker_attributes.cpus))
+		NET_LOG_ERROR(CSTRING("'%s' => invalid cpu list '%s', the workers are not pinned"), SERVERNAME(this), worker_cpus);
+
+#ifdef BUILD_LINUX
+	if (Isset(NET_OPT_USE_REACTOR) ? GetOption<bool>(NET_OPT_USE_REACTOR) : NET_OPT_DEFAULT_USE_REACTOR)
+	{
+		worker_attributes.set_name(CSTRING("net-reactor"));
+		PeerReactorManager.set_thread_attributes(worker_attributes);
+		PeerReactorManager.set_tick_time(FREQUENZ(this));
+		PeerReactorManager.set_use_uring(Isset(NET_OPT_USE_URING) ? GetOption<bool>(NET_OPT_USE_URING) : NET_OPT_DEFAULT_USE_URING);
+		if (!PeerReactorManager.start(Isset(NET_OPT_WORKER_THREADS) ? GetOption<size_t>(NET_OPT_WORKER_THREADS) : NET_OPT_DEFAULT_WORKER_THREADS))
+		{
+			NET_LOG_ERROR(CSTRING("'%s' => unable to start the reactor"), SERVERNAME(this));
+			Ws2_32::closesocket(GetListenSocket());
+			return false;
+		}
+
+		/*
+		* reuseport: one listen socket per worker, the kernel will balance the incoming connections between them
+		* io_uring: the first worker accepts on the primary listen socket using multishot accept
+		*/
+		const size_t listeners = UseReusePort() ? PeerReactorManager.count_workers() : (PeerReactorManager.uses_uring() ? 1 : 0);
+		for (size_t i = 0; i < listeners; ++i)
+		{
+			const auto listener = ALLOC<Listener_t>();
+			listener->server = this;
+			listener->socket = (i == 0) ? GetListenSocket() : CreateReusePortListener();
+			listener->worker = i;
+
+			Net::PeerPool::peerInfo_t pInfo;
+			pInfo.SetPeer(listener);
+			pInfo.SetWorker(&ListenerWorker);
+			pInfo.SetCallbackOnReceive(&ListenerAccept);
+			pInfo.SetCallbackOnDelete(&OnListenerDelete);
+
+			if (listener->socket == INVALID_SOCKET || !PeerReactorManager.add_listener(listener->socket, pInfo, i))
+			{
+				NET_LOG_ERROR(CSTRING("'%s' => unable to create listen socket for worker %i"), SERVERNAME(this), static_cast<int>(i));
+				OnListenerDelete(listener);
+				PeerReactorManager.stop();
+				Ws2_32::closesocket(GetListenSocket());
+				return false;
+			}
+		}
+	}
+#endif
+
+	if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
+	{
+		PacketTaskPool.set_num_threads(Isset(NET_OPT_EXECUTE_PACKET_THREADS) ? GetOption<size_t>(NET_OPT_EXECUTE_PACKET_THREADS) : NET_OPT_DEFAULT_EXECUTE_PACKET_THREADS);
+		PacketTaskPool.set_max_depth(Isset(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) ? GetOption<size_t>(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) : NET_OPT_DEFAULT_EXECUTE_PACKET_QUEUE_LIMIT);
+		PacketTaskPool.set_lane_burst(Isset(NET_OPT_LANE_BURST) ? GetOption<size_t>(NET_OPT_LANE_BURST) : NET_OPT_DEFAULT_LANE_BURST);
+
+		worker_attributes.set_name(CSTRING("net-exec"));
+		PacketTaskPool.set_thread_attributes(worker_attributes);
+
+		// packets are still being executed, just on the receiving thread
+		if (!PacketTaskPool.start())
+			NET_LOG_ERROR(CSTRING("'%s' => unable to start the packet workers, executing packets synchronously"), SERVERNAME(this));
+	}
+
+	if (Isset(NET_OPT_PIPELINE) ? GetOption<bool>(NET_OPT_PIPELINE) : NET_OPT_DEFAULT_PIPELINE)
+	{
+		PacketPipelinePool.set_num_threads(Isset(NET_OPT_PIPELINE_THREADS) ? GetOption<size_t>(NET_OPT_PIPELINE_THREADS) : NET_OPT_DEFAULT_PIPELINE_THREADS);
+		PacketPipelinePool.set_max_depth(Isset(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) ? GetOption<size_t>(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) : NET_OPT_DEFAULT_EXECUTE_PACKET_QUEUE_LIMIT);
+
+		worker_attributes.set_name(CSTRING("net-decode"));
+		PacketPipelinePool.set_thread_attributes(worker_attributes);
+
+		// frames are still being decoded, just on the receiving thread
+		if (!PacketPipelinePool.start())
+			NET_LOG_ERROR(CSTRING("'%s' => unable to start the pipeline workers, decoding packets synchronously"), SERVERNAME(this));
+	}
+
+	PeerPoolManager.set_num_threads(Isset(NET_OPT_WORKER_THREADS) ? GetOption<size_t>(NET_OPT_WORKER_THREADS) : NET_OPT_DEFAULT_WORKER_THREADS);
+
+	worker_attributes.set_name(CSTRING("net-pool"));
+	PeerPoolManager.set_thread_attributes(worker_attributes);
 
 	PeerPoolManager.set_sleep_time(FREQUENZ(this));
 
@@ -649,10 +1283,45 @@ bool Net::Server::Server::Run()
 	PeerPoolManager.set_sleep_function(&Kernel32::Sleep);
 #endif;
 
+	// the reactor takes care of all peers on its own
+#ifdef BUILD_LINUX
+	if (!PeerReactorManager.is_running())
+#endif
+	{
+		if (!PeerPoolManager.start())
+		{
+			NET_LOG_ERROR(CSTRING("'%s' => unable to start the peer pool"), SERVERNAME(this));
+#ifdef BUILD_LINUX
+			PeerReactorManager.stop();
+#endif
+			Ws2_32::closesocket(GetListenSocket());
+			return false;
+		}
+	}
+
 	Thread::Create(TickThread, this);
+
+#ifdef BUILD_LINUX
+	// the reactor workers are accepting on their own
+	if (!UseReusePort() && !peer_reactor_uses_uring())
+		Thread::Create(AcceptorThread, this);
+#else
 	Thread::Create(AcceptorThread, this);
+#endif
 
 	SetRunning(true);
+
+	// started once the server is running, it stops as soon as it is not
+	Thread::Create(CoalesceThread, this);
+
+#ifdef BUILD_LINUX
+	if (UnixPath())
+	{
+		NET_LOG_SUCCESS(CSTRING("'%s' => running on unix socket '%s'"), SERVERNAME(this), UnixPath());
+		return true;
+	}
+#endif
+
 	NET_LOG_SUCCESS(CSTRING("'%s' => running on port %d"), SERVERNAME(this), SERVERPORT(this));
 	return true;
 }
@@ -681,9 +1350,31 @@ bool Net::Server::Server::Close()
 
 	SetRunning(false);
 
+	// wake up the coalescing thread, the lock makes sure it is either waiting or about to see it
+	{
+		std::lock_guard<std::mutex> guard(CorkedPeersMutex);
+	}
+	CorkedPeersCondition.notify_all();
+
+#ifdef BUILD_LINUX
+	PeerReactorManager.stop();
+#endif
+
+	PeerPoolManager.stop();
+
+	// the peers are gone, execute the packets that are left - the pipeline still hands packets over to the packet workers
+	PacketPipelinePool.stop();
+	PacketTaskPool.stop();
+
 	if (GetListenSocket())
 		Ws2_32::closesocket(GetListenSocket());
 
+#ifdef BUILD_LINUX
+	// the socket file outlives the socket
+	if (UnixPath())
+		unlink(UnixPath());
+#endif
+
 #ifndef BUILD_LINUX
 	Ws2_32::WSACleanup();
 #endif
@@ -692,270 +1383,454 @@ bool Net::Server::Server::Close()
 	return true;
 }
 
-void Net::Server::Server::SingleSend(NET_PEER peer, const char* data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+bool Net::Server::Server::EnqueueSend(NET_PEER peer, Net::Frame::Frame_t* frame, const Net::Lane::Lane_t lane)
 {
 	PEER_NOT_VALID(peer,
-		return;
+		FREE<Net::Frame::Frame_t>(frame);
+		return false;
 	);
 
-	if (peer->bErase) return;
-	if (bPreviousSentFailed)
-		return;
-
-	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+	if (peer->bErase || frame->size() == 0)
 	{
-		char* ptr = (char*)data;
-		for (size_t it = 0; it < size; ++it)
-			ptr[it] = ptr[it] ^ sendToken;
+		const bool ret = !peer->bErase;
+		FREE<Net::Frame::Frame_t>(frame);
+		return ret;
 	}
 
-	do
+	const auto limit = Isset(NET_OPT_SEND_QUEUE_LIMIT) ? GetOption<size_t>(NET_OPT_SEND_QUEUE_LIMIT) : NET_OPT_DEFAULT_SEND_QUEUE_LIMIT;
+
+	size_t queued = 0;
+	bool notify = false;
 	{
-		const auto res = Ws2_32::send(peer->pSocket, reinterpret_cast<const char*>(data), size, MSG_NOSIGNAL);
-		if (res == SOCKET_ERROR)
+		std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+
+		const auto send = peer->network.getSendQueue();
+		if (!send)
 		{
-#ifdef BUILD_LINUX
-			if (errno == EWOULDBLOCK)
-			{
-				usleep(FREQUENZ(this) * 1000);
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				ErasePeer(peer);
-				if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
-				return;
-			}
-#else
-			if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-			{
-				Kernel32::Sleep(FREQUENZ(this));
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				ErasePeer(peer);
-				if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-				return;
-			}
-#endif
+			FREE<Net::Frame::Frame_t>(frame);
+			return false;
 		}
-		if (res < 0)
-			break;
 
-		size -= res;
-	} while (size > 0);
-}
+		peer->network._send_scheduler.set_limit(Isset(NET_OPT_LANE_BURST) ? GetOption<size_t>(NET_OPT_LANE_BURST) : NET_OPT_DEFAULT_LANE_BURST);
+		send->lanes[static_cast<int>(lane)].emplace_back(frame);
+		peer->network._send_queue_size += frame->size();
 
-void Net::Server::Server::SingleSend(NET_PEER peer, BYTE*& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
-{
-	PEER_NOT_VALID(peer,
-		FREE<byte>(data);
-	return;
-	);
+		// coalescing: the frame waits for the ones following it, unless it has been waiting long enough - the handshake is never held back
+		bool flush = true;
+		bool start = false;
+		if (peer->network._send_coalesce && peer->estabilished)
+		{
+			const auto now = std::chrono::steady_clock::now();
+			if (!peer->network._send_corked)
+			{
+				const auto window = Isset(NET_OPT_COALESCE_WINDOW) ? GetOption<int>(NET_OPT_COALESCE_WINDOW) : NET_OPT_DEFAULT_COALESCE_WINDOW;
+				peer->network._send_corked_until = now + std::chrono::milliseconds(window);
+				start = true;
+			}
 
-	if (peer->bErase)
-	{
-		FREE<byte>(data);
-		return;
-	}
+			peer->network._send_corked += frame->size();
 
-	if (bPreviousSentFailed)
-	{
-		FREE<byte>(data);
-		return;
-	}
+			const auto bytes = Isset(NET_OPT_COALESCE_BYTES) ? GetOption<size_t>(NET_OPT_COALESCE_BYTES) : NET_OPT_DEFAULT_COALESCE_BYTES;
+			flush = peer->network._send_corked >= bytes || now >= peer->network._send_corked_until;
+		}
 
-	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-	{
-		for (size_t it = 0; it < size; ++it)
-			data[it] = data[it] ^ sendToken;
+		if (flush)
+		{
+			if (!FlushSendQueue(peer))
+				return false;
+		}
+		else if (start)
+		{
+			// nothing might follow, the frame must not wait any longer than the window
+			Cork(peer, peer->network._send_corked_until);
+		}
+
+		queued = peer->network._send_queue_size;
+		if (queued > limit && !peer->network._send_queue_full)
+		{
+			peer->network._send_queue_full = true;
+			notify = true;
+		}
 	}
 
-	do
+	// callback outside of the lock, it might want to disconnect the peer
+	if (notify)
+		OnPeerSendQueueFull(peer, queued);
+
+	return true;
+}
+
+/*
+* sends as much of the outbound queue as the socket accepts without blocking
+* the queued frames are handed over as one scatter-gather list
+* requires peer->network._mutex_send to be locked
+*/
+bool Net::Server::Server::FlushSendQueue(NET_PEER peer)
+{
+#ifdef BUILD_LINUX
+	ReapZeroCopy(peer);
+#endif
+
+	// everything that has been held back goes out now
+	peer->network._send_corked = 0;
+
+	if (!peer->network._send)
+		return true;
+
+	auto& queue = peer->network._send->queue;
+	for (;;)
 	{
-		const auto res = Ws2_32::send(peer->pSocket, reinterpret_cast<const char*>(data), size, MSG_NOSIGNAL);
-		if (res == SOCKET_ERROR)
-		{
+		peer->network.commitSendQueue();
+		if (queue.empty())
+			break;
+
+		bool zerocopy = queue.front()->zerocopy();
+
+		int64 res = 0;
 #ifdef BUILD_LINUX
-			if (errno == EWOULDBLOCK)
+		// file segments go out using sendfile, their data never passes through user memory
+		if (queue.front()->at_file())
+		{
+			zerocopy = false;
+			res = queue.front()->send_file(peer->pSocket);
+		}
+		else
+#endif
+		{
+			NET_IOVEC vec[NET_FRAME_MAX_IOVEC];
+			size_t count = 0;
+			for (auto it = queue.begin(); it != queue.end() && count < NET_FRAME_MAX_IOVEC; ++it)
 			{
-				usleep(FREQUENZ(this) * 1000);
-				continue;
+				// zero copy frames are not mixed with others, frames behind a file segment have to wait for it
+				if ((*it)->zerocopy() != zerocopy)
+					break;
+
+				count += (*it)->fill(vec + count, NET_FRAME_MAX_IOVEC - count);
+				if ((*it)->has_file())
+					break;
 			}
-			else
+
+			int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+#ifdef BUILD_LINUX
+			if (zerocopy) flags |= MSG_ZEROCOPY;
+
+			// coalescing: more frames follow within this flush, the kernel keeps on filling up its segments
+			if (peer->network._send_coalesce)
 			{
-				bPreviousSentFailed = true;
-				FREE(data);
-				ErasePeer(peer);
-				if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
-				return;
+				size_t batch = 0;
+				for (size_t i = 0; i < count; ++i)
+					batch += vec[i].iov_len;
+
+				if (batch < peer->network._send_queue_size)
+					flags |= MSG_MORE;
 			}
+#endif
+
+			res = Net::Frame::send(peer->pSocket, vec, count, flags);
+		}
+
+		if (res == SOCKET_ERROR)
+		{
+#ifdef BUILD_LINUX
+			// socket buffer is full, continue as soon as the socket becomes writable
+			if (errno == EWOULDBLOCK)
+				return true;
+
+			// out of option memory for the pinned pages, continue once completions have been reported
+			if (zerocopy && errno == ENOBUFS)
+				return true;
+
+			if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
 #else
+			// socket buffer is full, continue as soon as the socket becomes writable
 			if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-			{
-				Kernel32::Sleep(FREQUENZ(this));
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				FREE<byte>(data);
-				ErasePeer(peer);
-				if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-				return;
-			}
+				return true;
+
+			if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
 #endif
+
+			peer->network.clearSendQueue();
+			ErasePeer(peer);
+			return false;
 		}
-		if (res < 0)
+
+		if (res == 0)
 			break;
 
-		size -= res;
-	} while (size > 0);
+#ifdef BUILD_LINUX
+		// the kernel numbers every zero copy call, completions are reported using these numbers
+		if (zerocopy)
+			peer->network._zerocopy_next++;
+#endif
+
+		auto sent = static_cast<size_t>(res);
+		peer->network._send_queue_size -= sent;
+		peer->network._send_queue_committed -= sent;
+
+		// release every frame that went out completely, a partial written frame resumes on the next call
+		while (!queue.empty())
+		{
+			sent = queue.front()->consume(sent);
+			if (!queue.front()->done())
+				break;
+
+#ifdef BUILD_LINUX
+			// the kernel still references the pages of a zero copy frame until the last call touching it completes
+			if (queue.front()->zerocopy())
+				peer->network._send->zerocopy_pending.emplace_back(peer->network._zerocopy_next - 1, queue.front());
+			else
+#endif
+				FREE<Net::Frame::Frame_t>(queue.front());
+
+			queue.pop_front();
+		}
+	}
+
+	const auto limit = Isset(NET_OPT_SEND_QUEUE_LIMIT) ? GetOption<size_t>(NET_OPT_SEND_QUEUE_LIMIT) : NET_OPT_DEFAULT_SEND_QUEUE_LIMIT;
+	if (peer->network._send_queue_size <= limit)
+		peer->network._send_queue_full = false;
 
-	FREE<byte>(data);
+	peer->network.releaseSendQueue();
+	return true;
 }
 
-void Net::Server::Server::SingleSend(NET_PEER peer, NET_CPOINTER<BYTE>& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+void Net::Server::Server::DoFlush(NET_PEER peer)
 {
 	PEER_NOT_VALID(peer,
-		data.free();
-	return;
+		return;
 	);
 
 	if (peer->bErase)
-	{
-		data.free();
 		return;
-	}
 
-	if (bPreviousSentFailed)
-	{
-		data.free();
+	// a sender holding the lock is going to flush on its own
+	std::unique_lock<std::mutex> lock(peer->network._mutex_send, std::try_to_lock);
+	if (!lock.owns_lock())
 		return;
-	}
 
-	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+	FlushSendQueue(peer);
+}
+
+void Net::Server::Server::SetCoalescing(NET_PEER peer, const bool coalesce)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+	peer->network._send_coalesce = coalesce;
+
+	// nothing is held back anymore
+	if (!coalesce && peer->network._send_corked && !peer->bErase)
+		FlushSendQueue(peer);
+}
+
+bool Net::Server::Server::IsCoalescing(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return false;
+	);
+
+	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+	return peer->network._send_coalesce;
+}
+
+void Net::Server::Server::Flush(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	if (peer->bErase)
+		return;
+
+	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+	FlushSendQueue(peer);
+}
+
+void Net::Server::Server::FlushCorked(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	if (peer->bErase)
+		return;
+
+	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+	if (peer->network._send_corked)
+		FlushSendQueue(peer);
+}
+
+/* requires peer->network._mutex_send to be locked, the list is never locked first */
+void Net::Server::Server::Cork(NET_PEER peer, const std::chrono::steady_clock::time_point until)
+{
+	bool wake = false;
 	{
-		for (size_t it = 0; it < size; ++it)
-			data.get()[it] = data.get()[it] ^ sendToken;
+		std::lock_guard<std::mutex> guard(CorkedPeersMutex);
+		wake = CorkedPeers.empty();
+		CorkedPeers.push_back({ peer, until });
 	}
 
-	do
+	// the windows end in the order they started, only an empty list changes the next deadline - Uncork might be waiting as well
+	if (wake)
+		CorkedPeersCondition.notify_all();
+}
+
+void Net::Server::Server::Uncork(NET_PEER peer)
+{
+	std::unique_lock<std::mutex> lock(CorkedPeersMutex);
+	CorkedPeers.erase(std::remove_if(CorkedPeers.begin(), CorkedPeers.end(), [peer](const corked_t& corked) { return corked.peer == peer; }), CorkedPeers.end());
+	CorkedPeersCondition.wait(lock, [this, peer] { return CorkedPeerFlushing != peer; });
+}
+
+void Net::Server::Server::FlushExpired(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	if (peer->bErase)
+		return;
+
+	// flushed and corked again in between, the entry of the new window takes care of it
+	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+	if (peer->network._send_corked && std::chrono::steady_clock::now() >= peer->network._send_corked_until)
+		FlushSendQueue(peer);
+}
+
+void Net::Server::Server::FlushCorkedLoop()
+{
+	std::unique_lock<std::mutex> lock(CorkedPeersMutex);
+	while (IsRunning())
 	{
-		const auto res = Ws2_32::send(peer->pSocket, reinterpret_cast<const char*>(data.get()), size, MSG_NOSIGNAL);
-		if (res == SOCKET_ERROR)
+		if (CorkedPeers.empty())
 		{
-#ifdef BUILD_LINUX
-			if (errno == EWOULDBLOCK)
-			{
-				usleep(FREQUENZ(this) * 1000);
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				data.free();
-				ErasePeer(peer);
-				if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
-				return;
-			}
-#else
-			if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-			{
-				Kernel32::Sleep(FREQUENZ(this));
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				data.free();
-				ErasePeer(peer);
-				if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-				return;
-			}
-#endif
+			CorkedPeersCondition.wait(lock);
+			continue;
 		}
-		if (res < 0)
-			break;
 
-		size -= res;
-	} while (size > 0);
+		const auto corked = CorkedPeers.front();
+		if (std::chrono::steady_clock::now() < corked.until)
+		{
+			CorkedPeersCondition.wait_until(lock, corked.until);
+			continue;
+		}
 
-	data.free();
+		CorkedPeers.pop_front();
+		CorkedPeerFlushing = corked.peer;
+
+		// the peer gets locked without holding the list
+		lock.unlock();
+		FlushExpired(corked.peer);
+		lock.lock();
+
+		CorkedPeerFlushing = nullptr;
+		CorkedPeersCondition.notify_all();
+	}
+
+	CorkedPeers.clear();
 }
 
-void Net::Server::Server::SingleSend(NET_PEER peer, Net::RawData_t& data, bool& bPreviousSentFailed, const uint32_t sendToken)
+void Net::Server::Server::SingleSend(NET_PEER peer, const char* data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
 {
-	if (!data.valid()) return;
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	if (peer->bErase) return;
+	if (bPreviousSentFailed)
+		return;
+
+	auto frame = ALLOC<Net::Frame::Frame_t>();
+	frame->append(data, size);
+
+	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+		frame->mask(sendToken);
+
+	if (!EnqueueSend(peer, frame))
+		bPreviousSentFailed = true;
+}
 
+void Net::Server::Server::SingleSend(NET_PEER peer, BYTE*& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+{
 	PEER_NOT_VALID(peer,
-		data.free();
+		FREE<byte>(data);
 	return;
 	);
 
-	if (peer->bErase)
+	if (peer->bErase || bPreviousSentFailed)
 	{
-		data.free();
+		FREE<byte>(data);
 		return;
 	}
 
-	if (bPreviousSentFailed)
+	// ownership moves into the frame
+	auto frame = ALLOC<Net::Frame::Frame_t>();
+	frame->attach(data, size);
+	data = nullptr;
+
+	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+		frame->mask(sendToken);
+
+	if (!EnqueueSend(peer, frame))
+		bPreviousSentFailed = true;
+}
+
+void Net::Server::Server::SingleSend(NET_PEER peer, NET_CPOINTER<BYTE>& data, size_t size, bool& bPreviousSentFailed, const uint32_t sendToken)
+{
+	auto pointer = data.get();
+	data = nullptr;
+
+	SingleSend(peer, pointer, size, bPreviousSentFailed, sendToken);
+}
+
+void Net::Server::Server::SingleSend(NET_PEER peer, Net::RawData_t& data, bool& bPreviousSentFailed, const uint32_t sendToken)
+{
+	if (!data.valid()) return;
+
+#ifdef BUILD_LINUX
+	// untouched files are handed to sendfile
+	if (data.is_file() && sendToken == INVALID_UINT_SIZE)
 	{
+		if (bPreviousSentFailed)
+		{
+			data.free();
+			return;
+		}
+
+		auto frame = ALLOC<Net::Frame::Frame_t>();
+		frame->attach_file(data.file(), data.file_offset(), data.size(), data.do_free());
+		data.set_free(false);
 		data.free();
+
+		if (!EnqueueSend(peer, frame))
+			bPreviousSentFailed = true;
+
 		return;
 	}
+#endif
 
-	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+	if (!data.load())
 	{
-		for (size_t it = 0; it < data.size(); ++it)
-			data.value()[it] = data.value()[it] ^ sendToken;
+		bPreviousSentFailed = true;
+		data.free();
+		return;
 	}
 
-	size_t size = data.size();
-	do
+	if (data.do_free())
 	{
-		const auto res = Ws2_32::send(peer->pSocket, reinterpret_cast<const char*>(data.value()), size, MSG_NOSIGNAL);
-		if (res == SOCKET_ERROR)
-		{
-#ifdef BUILD_LINUX
-			if (errno == EWOULDBLOCK)
-			{
-				usleep(FREQUENZ(this) * 1000);
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				data.free();
-				ErasePeer(peer);
-				if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
-				return;
-			}
-#else
-			if (Ws2_32::WSAGetLastError() == WSAEWOULDBLOCK)
-			{
-				Kernel32::Sleep(FREQUENZ(this));
-				continue;
-			}
-			else
-			{
-				bPreviousSentFailed = true;
-				data.free();
-				ErasePeer(peer);
-				if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
-				return;
-			}
-#endif
-		}
-		if (res < 0)
-			break;
+		// ownership moves into the frame
+		auto pointer = data.value();
+		const auto size = data.size();
+		data.set_free(false);
+		data.free();
 
-		size -= res;
-	} while (size > 0);
+		SingleSend(peer, pointer, size, bPreviousSentFailed, sendToken);
+		return;
+	}
 
+	SingleSend(peer, reinterpret_cast<const char*>(data.value()), data.size(), bPreviousSentFailed, sendToken);
 	data.free();
 }
 
@@ -986,31 +1861,101 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 		return;
 	);
 
-	if (peer->bErase)
+	if (peer->bErase)
+		return;
+
+	uint32_t sendToken = INVALID_UINT_SIZE;
+	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+		sendToken = Net::Coding::TOTP::generateToken(peer->totp_secret, peer->totp_secret_len, Isset(NET_OPT_USE_NTP) ? GetOption<bool>(NET_OPT_USE_NTP) : NET_OPT_DEFAULT_USE_NTP ? curTime : time(nullptr), Isset(NET_OPT_TOTP_INTERVAL) ? (int)(GetOption<int>(NET_OPT_TOTP_INTERVAL) / 2) : (int)(NET_OPT_DEFAULT_TOTP_INTERVAL / 2));
+
+	/* file backed raw data can only be sent using sendfile if it goes out unmodified */
+	if (PKG.HasRawData()
+		&& (((Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && peer->cryption.getHandshakeStatus())
+			|| (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+			|| (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)))
+	{
+		if (!PKG.LoadRawFiles())
+			return;
+	}
+
+	Net::Json::Document doc;
+	doc[CSTRING("ID")] = id;
+	doc[CSTRING("CONTENT")] = pkg.Data();
+
+	auto buffer = doc.Serialize(Net::Json::SerializeType::UNFORMATTED);
+
+	auto dataBufferSize = buffer.size();
+	NET_CPOINTER<BYTE> dataBuffer(ALLOC<BYTE>(dataBufferSize + 1));
+	memcpy(dataBuffer.get(), buffer.get().get(), dataBufferSize);
+	dataBuffer.get()[dataBufferSize] = '\0';
+	buffer.clear();
+
+	const bool cipher = (Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && peer->cryption.getHandshakeStatus();
+
+#ifdef BUILD_LINUX
+	/* big raw data that has been handed over goes out straight from its buffer */
+	size_t zerocopy_size = 0;
+	if (PKG.HasRawData()
+		&& !cipher
+		&& !(Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+		&& !(Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP))
+	{
+		for (const auto& data : PKG.GetRawData())
+			if (data.do_free() && !data.is_file()) zerocopy_size += data.size();
+	}
+#endif
+
+	/* Compression */
+	size_t original_dataBufferSize = dataBufferSize;
+	if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+	{
+		/* Compress Data */
+		CompressData(dataBuffer.reference().get(), dataBufferSize);
+
+		/* Compress Raw Data */
+		if (PKG.HasRawData())
+		{
+			for (auto& entry : PKG.GetRawData())
+			{
+				entry.set_original_size(entry.size());
+				CompressData(entry.value(), entry.size());
+			}
+		}
+	}
+
+	auto frame = EncodeFrame(peer, cipher, peer->framing, id, dataBuffer, dataBufferSize, original_dataBufferSize, pkg);
+	if (!frame)
+	{
+		dataBuffer.free();
 		return;
+	}
 
-	std::lock_guard<std::mutex> guard(peer->network._mutex_send);
+#ifdef BUILD_LINUX
+	if (zerocopy_size > 0)
+		frame->set_zerocopy(UseZeroCopy(peer, zerocopy_size));
+#endif
 
-	uint32_t sendToken = INVALID_UINT_SIZE;
 	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-		sendToken = Net::Coding::TOTP::generateToken(peer->totp_secret, peer->totp_secret_len, Isset(NET_OPT_USE_NTP) ? GetOption<bool>(NET_OPT_USE_NTP) : NET_OPT_DEFAULT_USE_NTP ? curTime : time(nullptr), Isset(NET_OPT_TOTP_INTERVAL) ? (int)(GetOption<int>(NET_OPT_TOTP_INTERVAL) / 2) : (int)(NET_OPT_DEFAULT_TOTP_INTERVAL / 2));
-
-	Net::Json::Document doc;
-	doc[CSTRING("ID")] = id;
-	doc[CSTRING("CONTENT")] = pkg.Data();
-
-	auto buffer = doc.Serialize(Net::Json::SerializeType::UNFORMATTED);
+		frame->mask(sendToken);
 
-	auto dataBufferSize = buffer.size();
-	NET_CPOINTER<BYTE> dataBuffer(ALLOC<BYTE>(dataBufferSize + 1));
-	memcpy(dataBuffer.get(), buffer.get().get(), dataBufferSize);
-	dataBuffer.get()[dataBufferSize] = '\0';
-	buffer.clear();
+	EnqueueSend(peer, frame, GetPacketLane(id));
+}
 
+/*
+* writes the serialized (and compressed) packet into a frame, the data buffer and the raw data of the packet are consumed
+* cipher: encrypted using a fresh AES key, which is sent encrypted with the public key of the peer
+* framing: NET_FRAMING_V1 (text) or NET_FRAMING_V2 (binary), the id is only part of the binary header
+* the peer is only used by the cipher, returns nullptr if it has been disconnected
+*/
+Net::Frame::Frame_t* Net::Server::Server::EncodeFrame(NET_PEER peer, const bool cipher, const int framing, const int id, NET_CPOINTER<BYTE>& dataBuffer, size_t dataBufferSize, const size_t original_dataBufferSize, NET_PACKET& pkg)
+{
 	size_t combinedSize = 0;
 
+	const uint16_t flags = (cipher ? NET_FRAMING_V2_FLAG_CIPHER : 0)
+		| ((Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION) ? NET_FRAMING_V2_FLAG_COMPRESSION : 0);
+
 	/* Crypt */
-	if ((Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && peer->cryption.getHandshakeStatus())
+	if (cipher)
 	{
 		NET_AES aes;
 
@@ -1029,7 +1974,7 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 			Key.free();
 			IV.free();
 			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_InitAES, true);
-			return;
+			return nullptr;
 		}
 
 		/* Encrypt AES Keypair using RSA */
@@ -1038,7 +1983,7 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 			Key.free();
 			IV.free();
 			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_CryptKeyBase64, true);
-			return;
+			return nullptr;
 		}
 
 		size_t IVSize = CryptoPP::AES::BLOCKSIZE;
@@ -1047,25 +1992,7 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 			Key.free();
 			IV.free();
 			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_CryptIVBase64, true);
-			return;
-		}
-
-		/* Compression */
-		size_t original_dataBufferSize = dataBufferSize;
-		if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-		{
-			/* Compress Data */
-			CompressData(dataBuffer.reference().get(), dataBufferSize);
-
-			/* Compress Raw Data */
-			if (PKG.HasRawData())
-			{
-				for (auto& entry : PKG.GetRawData())
-				{
-					entry.set_original_size(entry.size());
-					CompressData(entry.value(), entry.size());
-				}
-			}
+			return nullptr;
 		}
 
 		/* Crypt Buffer using AES and Encode to Base64 */
@@ -1078,6 +2005,13 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 				aes.encrypt(data.value(), data.size());
 		}
 
+		if (framing == NET_FRAMING_V2)
+		{
+			auto frame = ALLOC<Net::Frame::Frame_t>();
+			Net::Framing::encode(*frame, id, flags, Key.get(), aesKeySize, IV.get(), IVSize, dataBuffer.get(), dataBufferSize, original_dataBufferSize, PKG.GetRawData());
+			return frame;
+		}
+
 		combinedSize = dataBufferSize + NET_PACKET_HEADER_LEN + NET_PACKET_SIZE_LEN + NET_DATA_LEN + NET_PACKET_FOOTER_LEN + NET_AES_KEY_LEN + NET_AES_IV_LEN + aesKeySize + IVSize + 8;
 
 		/* Compression */
@@ -1104,16 +2038,16 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 
 		const auto EntirePacketSizeStr = std::to_string(combinedSize + std::to_string(combinedSize).length());
 
-		auto bPreviousSentFailed = false;
+		auto frame = ALLOC<Net::Frame::Frame_t>();
 
 		/* Append Packet Header */
-		SingleSend(peer, NET_PACKET_HEADER, NET_PACKET_HEADER_LEN, bPreviousSentFailed, sendToken);
+		frame->append(NET_PACKET_HEADER, NET_PACKET_HEADER_LEN);
 
 		// Append Packet Size Syntax
-		SingleSend(peer, NET_PACKET_SIZE, NET_PACKET_SIZE_LEN, bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, EntirePacketSizeStr.data(), EntirePacketSizeStr.length(), bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+		frame->append(NET_PACKET_SIZE, NET_PACKET_SIZE_LEN);
+		frame->append(NET_PACKET_BRACKET_OPEN, 1);
+		frame->append(EntirePacketSizeStr.data(), EntirePacketSizeStr.length());
+		frame->append(NET_PACKET_BRACKET_CLOSE, 1);
 
 		/* Append Original Uncompressed Packet Size */
 		/* Compression */
@@ -1121,25 +2055,25 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 		{
 			const auto UnCompressedPacketSizeStr = std::to_string(original_dataBufferSize + std::to_string(original_dataBufferSize).length());
 
-			SingleSend(peer, NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-			SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-			SingleSend(peer, UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length(), bPreviousSentFailed, sendToken);
-			SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+			frame->append(NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN);
+			frame->append(NET_PACKET_BRACKET_OPEN, 1);
+			frame->append(UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length());
+			frame->append(NET_PACKET_BRACKET_CLOSE, 1);
 		}
 
 		/* Append Packet Key */
-		SingleSend(peer, NET_AES_KEY, NET_AES_KEY_LEN, bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, KeySizeStr.data(), KeySizeStr.length(), bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, Key, aesKeySize, bPreviousSentFailed, sendToken);
+		frame->append(NET_AES_KEY, NET_AES_KEY_LEN);
+		frame->append(NET_PACKET_BRACKET_OPEN, 1);
+		frame->append(KeySizeStr.data(), KeySizeStr.length());
+		frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+		frame->attach(Key.get(), aesKeySize); // frame takes over the buffer
 
 		/* Append Packet IV */
-		SingleSend(peer, NET_AES_IV, NET_AES_IV_LEN, bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, IVSizeStr.data(), IVSizeStr.length(), bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, IV, IVSize, bPreviousSentFailed, sendToken);
+		frame->append(NET_AES_IV, NET_AES_IV_LEN);
+		frame->append(NET_PACKET_BRACKET_OPEN, 1);
+		frame->append(IVSizeStr.data(), IVSizeStr.length());
+		frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+		frame->attach(IV.get(), IVSize);
 
 		/* Append Packet Data */
 		if (PKG.HasRawData())
@@ -1147,14 +2081,14 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 			for (auto& data : PKG.GetRawData())
 			{
 				// Append Key
-				SingleSend(peer, NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+				frame->append(NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN);
+				frame->append(NET_PACKET_BRACKET_OPEN, 1);
 
 				const auto KeyLengthStr = std::to_string(strlen(data.key()) + 1);
 
-				SingleSend(peer, KeyLengthStr.data(), KeyLengthStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(peer, data.key(), strlen(data.key()) + 1, bPreviousSentFailed, sendToken);
+				frame->append(KeyLengthStr.data(), KeyLengthStr.length());
+				frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+				frame->append(data.key(), strlen(data.key()) + 1);
 
 				// Append Original Size
 				/* Compression */
@@ -1162,53 +2096,50 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 				{
 					const auto OriginalSizeStr = std::to_string(data.original_size() + std::to_string(data.original_size()).length());
 
-					SingleSend(peer, NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-					SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-					SingleSend(peer, OriginalSizeStr.data(), OriginalSizeStr.length(), bPreviousSentFailed, sendToken);
-					SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+					frame->append(NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN);
+					frame->append(NET_PACKET_BRACKET_OPEN, 1);
+					frame->append(OriginalSizeStr.data(), OriginalSizeStr.length());
+					frame->append(NET_PACKET_BRACKET_CLOSE, 1);
 				}
 
 				// Append Raw Data
-				SingleSend(peer, NET_RAW_DATA, NET_RAW_DATA_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+				frame->append(NET_RAW_DATA, NET_RAW_DATA_LEN);
+				frame->append(NET_PACKET_BRACKET_OPEN, 1);
 
 				const auto rawDataLengthStr = std::to_string(data.size());
 
-				SingleSend(peer, rawDataLengthStr.data(), rawDataLengthStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(peer, data, bPreviousSentFailed, sendToken);
+				frame->append(rawDataLengthStr.data(), rawDataLengthStr.length());
+				frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+
+				// ownership moves into the frame unless the caller keeps the buffer
+				if (data.do_free())
+					frame->attach(data.value(), data.size());
+				else
+					frame->append(data.value(), data.size());
 
 				data.set_free(false);
+				data.free();
 			}
 		}
 
-		SingleSend(peer, NET_DATA, NET_DATA_LEN, bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, dataSizeStr.data(), dataSizeStr.length(), bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, dataBuffer, dataBufferSize, bPreviousSentFailed, sendToken);
+		frame->append(NET_DATA, NET_DATA_LEN);
+		frame->append(NET_PACKET_BRACKET_OPEN, 1);
+		frame->append(dataSizeStr.data(), dataSizeStr.length());
+		frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+		frame->attach(dataBuffer.get(), dataBufferSize);
 
 		/* Append Packet Footer */
-		SingleSend(peer, NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN, bPreviousSentFailed, sendToken);
+		frame->append(NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN);
+
+		return frame;
 	}
 	else
 	{
-		/* Compression */
-		size_t original_dataBufferSize = dataBufferSize;
-		if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+		if (framing == NET_FRAMING_V2)
 		{
-			/* Compress Data */
-			CompressData(dataBuffer.reference().get(), dataBufferSize);
-
-			/* Compress Raw Data */
-			if (PKG.HasRawData())
-			{
-				for (auto& entry : PKG.GetRawData())
-				{
-					entry.set_original_size(entry.size());
-					CompressData(entry.value(), entry.size());
-				}
-			}
+			auto frame = ALLOC<Net::Frame::Frame_t>();
+			Net::Framing::encode(*frame, id, flags, nullptr, 0, nullptr, 0, dataBuffer.get(), dataBufferSize, original_dataBufferSize, PKG.GetRawData());
+			return frame;
 		}
 
 		combinedSize = dataBufferSize + NET_PACKET_HEADER_LEN + NET_PACKET_SIZE_LEN + NET_DATA_LEN + NET_PACKET_FOOTER_LEN + 4;
@@ -1231,16 +2162,16 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 
 		const auto EntirePacketSizeStr = std::to_string(combinedSize + std::to_string(combinedSize).length());
 
-		auto bPreviousSentFailed = false;
+		auto frame = ALLOC<Net::Frame::Frame_t>();
 
 		/* Append Packet Header */
-		SingleSend(peer, NET_PACKET_HEADER, NET_PACKET_HEADER_LEN, bPreviousSentFailed, sendToken);
+		frame->append(NET_PACKET_HEADER, NET_PACKET_HEADER_LEN);
 
 		// Append Packet Size Syntax
-		SingleSend(peer, NET_PACKET_SIZE, NET_PACKET_SIZE_LEN, bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, EntirePacketSizeStr.data(), EntirePacketSizeStr.length(), bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+		frame->append(NET_PACKET_SIZE, NET_PACKET_SIZE_LEN);
+		frame->append(NET_PACKET_BRACKET_OPEN, 1);
+		frame->append(EntirePacketSizeStr.data(), EntirePacketSizeStr.length());
+		frame->append(NET_PACKET_BRACKET_CLOSE, 1);
 
 		/* Append Original Uncompressed Packet Size */
 		/* Compression */
@@ -1248,10 +2179,10 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 		{
 			const auto UnCompressedPacketSizeStr = std::to_string(original_dataBufferSize + std::to_string(original_dataBufferSize).length());
 
-			SingleSend(peer, NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-			SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-			SingleSend(peer, UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length(), bPreviousSentFailed, sendToken);
-			SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+			frame->append(NET_PACKET_ORIGINAL_SIZE, NET_PACKET_ORIGINAL_SIZE_LEN);
+			frame->append(NET_PACKET_BRACKET_OPEN, 1);
+			frame->append(UnCompressedPacketSizeStr.data(), UnCompressedPacketSizeStr.length());
+			frame->append(NET_PACKET_BRACKET_CLOSE, 1);
 		}
 
 		/* Append Packet Data */
@@ -1260,14 +2191,14 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 			for (auto& data : PKG.GetRawData())
 			{
 				// Append Key
-				SingleSend(peer, NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+				frame->append(NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN);
+				frame->append(NET_PACKET_BRACKET_OPEN, 1);
 
 				const auto KeyLengthStr = std::to_string(strlen(data.key()) + 1);
 
-				SingleSend(peer, KeyLengthStr.data(), KeyLengthStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(peer, data.key(), strlen(data.key()) + 1, bPreviousSentFailed, sendToken);
+				frame->append(KeyLengthStr.data(), KeyLengthStr.length());
+				frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+				frame->append(data.key(), strlen(data.key()) + 1);
 
 				// Append Original Size
 				/* Compression */
@@ -1275,34 +2206,47 @@ void Net::Server::Server::DoSend(NET_PEER peer, const int id, NET_PACKET& pkg)
 				{
 					const auto OriginalSizeStr = std::to_string(data.original_size() + std::to_string(data.original_size()).length());
 
-					SingleSend(peer, NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN, bPreviousSentFailed, sendToken);
-					SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
-					SingleSend(peer, OriginalSizeStr.data(), OriginalSizeStr.length(), bPreviousSentFailed, sendToken);
-					SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
+					frame->append(NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN);
+					frame->append(NET_PACKET_BRACKET_OPEN, 1);
+					frame->append(OriginalSizeStr.data(), OriginalSizeStr.length());
+					frame->append(NET_PACKET_BRACKET_CLOSE, 1);
 				}
 
 				// Append Raw Data
-				SingleSend(peer, NET_RAW_DATA, NET_RAW_DATA_LEN, bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_OPEN, 1, bPreviousSentFailed, sendToken);
+				frame->append(NET_RAW_DATA, NET_RAW_DATA_LEN);
+				frame->append(NET_PACKET_BRACKET_OPEN, 1);
 
 				const auto rawDataLengthStr = std::to_string(data.size());
 
-				SingleSend(peer, rawDataLengthStr.data(), rawDataLengthStr.length(), bPreviousSentFailed, sendToken);
-				SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-				SingleSend(peer, data, bPreviousSentFailed, sendToken);
+				frame->append(rawDataLengthStr.data(), rawDataLengthStr.length());
+				frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+
+				// ownership moves into the frame unless the caller keeps the buffer
+#ifdef BUILD_LINUX
+				if (data.is_file())
+					frame->attach_file(data.file(), data.file_offset(), data.size(), data.do_free());
+				else
+#endif
+				if (data.do_free())
+					frame->attach(data.value(), data.size());
+				else
+					frame->append(data.value(), data.size());
 
 				data.set_free(false);
+				data.free();
 			}
 		}
 
-		SingleSend(peer, NET_DATA, NET_DATA_LEN, bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_OPEN, strlen(NET_PACKET_BRACKET_OPEN), bPreviousSentFailed, sendToken);
-		SingleSend(peer, dataSizeStr.data(), dataSizeStr.length(), bPreviousSentFailed, sendToken);
-		SingleSend(peer, NET_PACKET_BRACKET_CLOSE, 1, bPreviousSentFailed, sendToken);
-		SingleSend(peer, dataBuffer, dataBufferSize, bPreviousSentFailed, sendToken);
+		frame->append(NET_DATA, NET_DATA_LEN);
+		frame->append(NET_PACKET_BRACKET_OPEN, strlen(NET_PACKET_BRACKET_OPEN));
+		frame->append(dataSizeStr.data(), dataSizeStr.length());
+		frame->append(NET_PACKET_BRACKET_CLOSE, 1);
+		frame->attach(dataBuffer.get(), dataBufferSize);
 
 		/* Append Packet Footer */
-		SingleSend(peer, NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN, bPreviousSentFailed, sendToken);
+		frame->append(NET_PACKET_FOOTER, NET_PACKET_FOOTER_LEN);
+
+		return frame;
 	}
 }
 
@@ -1310,6 +2254,16 @@ struct Receive_t
 {
 	Net::Server::Server* server;
 	NET_PEER peer;
+
+	/* reactor worker that accepted the peer */
+	size_t reactor_worker;
+
+	Receive_t()
+	{
+		server = nullptr;
+		peer = nullptr;
+		reactor_worker = INVALID_SIZE;
+	}
 };
 
 Net::PeerPool::WorkStatus_t PeerWorker(void* pdata)
@@ -1326,8 +2280,83 @@ Net::PeerPool::WorkStatus_t PeerWorker(void* pdata)
 
 	server->OnPeerUpdate(peer);
 
-	return (!server->DoReceive(peer) ? Net::PeerPool::WorkStatus_t::FORWARD : Net::PeerPool::WorkStatus_t::CONTINUE);
+#ifdef NET_USE_COROUTINES
+	// handlers executed by this worker continue in between the packets of the peer
+	peer->coroutines.drain();
+#endif
+
+	// continue on pending outbound frames, the socket might be writable again
+	server->DoFlush(peer);
+
+	if (server->DoReceive(peer))
+	{
+		// peer got marked for erase while receiving, no need to wait for another visit
+		if (peer->bErase) return Net::PeerPool::WorkStatus_t::STOP;
+
+		// rate limited, the socket is not read until the next tick refilled the buckets
+		if (peer->bDelayed) return Net::PeerPool::WorkStatus_t::WAIT;
+
+#ifdef NET_USE_COROUTINES
+		// suspended handlers, the peer gets visited on each tick without having received anything
+		if (peer->coroutines.pending()) return Net::PeerPool::WorkStatus_t::WAIT;
+#endif
+
+		return Net::PeerPool::WorkStatus_t::CONTINUE;
+	}
+
+	// receive budget has been used up, come back as soon as the other peers had their turn
+	return Net::PeerPool::WorkStatus_t::FORWARD;
+}
+
+#ifdef BUILD_LINUX
+/* io_uring: receiving is driven by completions, the worker only gets called every tick */
+static Net::PeerPool::WorkStatus_t PeerTick(void* pdata)
+{
+	const auto data = (Receive_t*)pdata;
+	if (!data) return Net::PeerPool::WorkStatus_t::STOP;
+
+	auto peer = data->peer;
+	const auto server = data->server;
+
+	if (!server->IsRunning()) return Net::PeerPool::WorkStatus_t::STOP;
+	if (peer->bErase) return Net::PeerPool::WorkStatus_t::STOP;
+	if (peer->pSocket == INVALID_SOCKET) return Net::PeerPool::WorkStatus_t::STOP;
+
+	server->OnPeerUpdate(peer);
+
+#ifdef NET_USE_COROUTINES
+	peer->coroutines.drain();
+#endif
+
+	// continue on pending outbound frames
+	server->DoFlush(peer);
+
+	// completions keep on arriving, a delayed frame is only picked up again in here
+	server->ContinueDelayed(peer);
+
+	return (peer->bErase ? Net::PeerPool::WorkStatus_t::STOP : Net::PeerPool::WorkStatus_t::CONTINUE);
+}
+
+static Net::PeerPool::WorkStatus_t PeerReceive(void* pdata, byte* buffer, int64 size)
+{
+	const auto data = (Receive_t*)pdata;
+	if (!data) return Net::PeerPool::WorkStatus_t::STOP;
+
+	auto peer = data->peer;
+	const auto server = data->server;
+
+	if (!server->IsRunning()) return Net::PeerPool::WorkStatus_t::STOP;
+	if (peer->bErase) return Net::PeerPool::WorkStatus_t::STOP;
+
+#ifdef NET_USE_COROUTINES
+	peer->coroutines.drain();
+#endif
+
+	server->DoReceive(peer, buffer, size);
+
+	return (peer->bErase ? Net::PeerPool::WorkStatus_t::STOP : Net::PeerPool::WorkStatus_t::CONTINUE);
 }
+#endif
 
 void OnPeerDelete(void* pdata)
 {
@@ -1405,6 +2434,30 @@ NET_THREAD(PeerStartRoutine)
 	pInfo.SetPeer(parameter);
 	pInfo.SetWorker(&PeerWorker);
 	pInfo.SetCallbackOnDelete(&OnPeerDelete);
+
+#ifdef BUILD_LINUX
+	if (server->Isset(NET_OPT_USE_REACTOR) ? server->GetOption<bool>(NET_OPT_USE_REACTOR) : NET_OPT_DEFAULT_USE_REACTOR)
+	{
+		if (server->peer_reactor_uses_uring())
+		{
+			pInfo.SetWorker(&PeerTick);
+			pInfo.SetCallbackOnReceive(&PeerReceive);
+		}
+
+		if (!server->add_to_peer_reactor(peer->pSocket, pInfo, data->reactor_worker))
+			OnPeerDelete(parameter);
+
+		return 0;
+	}
+#endif
+
+#ifdef BUILD_LINUX
+	// the workers of the pool are shared by many peers, none of them is allowed to block on a read
+	const int flags = fcntl(peer->pSocket, F_GETFL, 0);
+	if (flags == SOCKET_ERROR || fcntl(peer->pSocket, F_SETFL, flags | O_NONBLOCK) == SOCKET_ERROR)
+		NET_LOG_ERROR(CSTRING("'%s' :: [%s] => unable to set socket into non-blocking mode, error: %d"), SERVERNAME(server), peer->IPAddr().get(), errno);
+#endif
+
 	server->add_to_peer_threadpool(pInfo);
 
 	return 0;
@@ -1448,7 +2501,63 @@ void Net::Server::Server::Acceptor()
 	pdata->server = this;
 	pdata->peer = CreatePeer(client_addr, accept_socket);
 	if (pdata->peer) Net::Thread::Create(PeerStartRoutine, pdata);
+	else FREE<Receive_t>(pdata);
+}
+
+#ifdef BUILD_LINUX
+void Net::Server::Server::DrainAcceptor(const SOCKET listen_socket, const size_t worker)
+{
+	/* we are edge-triggered, accept until the backlog has been drained */
+	for (;;)
+	{
+		auto client_addr = sockaddr_in();
+		socklen_t slen = sizeof(client_addr);
+
+		const SOCKET accept_socket = accept4(listen_socket, (sockaddr*)&client_addr, &slen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (accept_socket == INVALID_SOCKET)
+		{
+			if (errno == EWOULDBLOCK || errno == EAGAIN)
+				return;
+
+			// connection got aborted before we picked it up
+			if (errno == ECONNABORTED || errno == EINTR)
+				continue;
+
+			NET_LOG_ERROR(CSTRING("'%s' => [accept4] failed with error %d"), SERVERNAME(this), LAST_ERROR);
+			return;
+		}
+
+		// keep the peer on the worker that accepted it
+		const auto pdata = ALLOC<Receive_t>();
+		pdata->server = this;
+		pdata->reactor_worker = worker;
+		pdata->peer = CreatePeer(client_addr, accept_socket);
+		if (pdata->peer) Net::Thread::Create(PeerStartRoutine, pdata);
+		else FREE<Receive_t>(pdata);
+	}
+}
+
+void Net::Server::Server::AcceptPeer(const SOCKET accept_socket, const size_t worker)
+{
+	// multishot accept does not hand out the address of the peer
+	auto client_addr = sockaddr_in();
+	socklen_t slen = sizeof(client_addr);
+	if (Ws2_32::getpeername(accept_socket, (sockaddr*)&client_addr, &slen) == SOCKET_ERROR)
+	{
+		NET_LOG_ERROR(CSTRING("'%s' => [getpeername] failed with error %d"), SERVERNAME(this), LAST_ERROR);
+		Ws2_32::closesocket(accept_socket);
+		return;
+	}
+
+	// keep the peer on the worker that accepted it
+	const auto pdata = ALLOC<Receive_t>();
+	pdata->server = this;
+	pdata->reactor_worker = worker;
+	pdata->peer = CreatePeer(client_addr, accept_socket);
+	if (pdata->peer) Net::Thread::Create(PeerStartRoutine, pdata);
+	else FREE<Receive_t>(pdata);
 }
+#endif
 
 /*
 *							Visualisation of packet structure in NET
@@ -1480,67 +2589,101 @@ bool Net::Server::Server::DoReceive(NET_PEER peer)
 	SOCKET_NOT_VALID(peer->pSocket)
 		return true;
 
-	auto data_size = Ws2_32::recv(peer->pSocket, reinterpret_cast<char*>(peer->network.getDataReceive()), NET_OPT_DEFAULT_MAX_PACKET_SIZE, 0);
-	if (data_size == SOCKET_ERROR)
+	// the socket is left alone until the waiting frame got its tokens
+	if (peer->bDelayed)
+	{
+		ProcessPackets(peer);
+		if (peer->bDelayed || peer->bErase)
+			return true;
+	}
+
+	const auto budget = Isset(NET_OPT_RECEIVE_BUDGET) ? GetOption<size_t>(NET_OPT_RECEIVE_BUDGET) : NET_OPT_DEFAULT_RECEIVE_BUDGET;
+
+	/* keep on reading until the socket has been drained or the peer used up its budget */
+	size_t received = 0;
+	do
 	{
 #ifdef BUILD_LINUX
-		if (errno != EWOULDBLOCK)
+		// only the first read is allowed to wait for data
+		const int flags = received ? MSG_DONTWAIT : 0;
 #else
-		if (Ws2_32::WSAGetLastError() != WSAEWOULDBLOCK)
+		const int flags = 0;
 #endif
+
+		auto data_size = Ws2_32::recv(peer->pSocket, reinterpret_cast<char*>(peer->network.getDataReceive()), NET_OPT_DEFAULT_MAX_PACKET_SIZE, flags);
+		if (data_size == SOCKET_ERROR)
 		{
-			peer->network.reset();
-			ErasePeer(peer);
+#ifdef BUILD_LINUX
+			if (errno != EWOULDBLOCK)
+#else
+			if (Ws2_32::WSAGetLastError() != WSAEWOULDBLOCK)
+#endif
+			{
+				ErasePeer(peer);
 
 #ifdef BUILD_LINUX
-			if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
+				if (ERRNO_ERROR_TRIGGERED) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(errno).c_str());
 #else
-			if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
+				if (Ws2_32::WSAGetLastError() != 0) NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(Ws2_32::WSAGetLastError()).c_str());
 #endif
 
+				return true;
+			}
+
+			ProcessPackets(peer);
 			return true;
 		}
 
-		ProcessPackets(peer);
-		peer->network.reset();
+		if (DoReceive(peer, peer->network.getDataReceive(), data_size))
+			return true;
+
+		if (peer->bErase || peer->bDelayed)
+			return true;
+
+		// a short read means the socket has been drained, spare the call that would only report EWOULDBLOCK
+		if (data_size < NET_OPT_DEFAULT_MAX_PACKET_SIZE)
+			return true;
+
+		received += data_size;
+	} while (!budget || received < budget);
+
+	// more data might be pending
+	return false;
+}
+
+/*
+* processes data that has already been received
+* size == 0: closed by the remote, size < 0: -errno (completion based backends)
+*/
+bool Net::Server::Server::DoReceive(NET_PEER peer, const byte* data, const int64 size)
+{
+	PEER_NOT_VALID(peer,
+		return true;
+	);
+
+	if (size < 0)
+	{
+		ErasePeer(peer);
+		NET_LOG_PEER(CSTRING("'%s' :: [%s] => %s"), SERVERNAME(this), peer->IPAddr().get(), Net::sock_err::getString(static_cast<int>(-size)).c_str());
 		return true;
 	}
 
 	// graceful disconnect
-	if (data_size == 0)
+	if (size == 0)
 	{
-		peer->network.reset();
 		ErasePeer(peer);
 		NET_LOG_PEER(CSTRING("'%s' :: [%s] => connection gracefully closed"), SERVERNAME(this), peer->IPAddr().get());
 		return true;
 	}
 
-	if (!peer->network.dataValid())
-	{
-		peer->network.allocData(data_size);
-		memcpy(peer->network.getData(), peer->network.getDataReceive(), data_size);
-	}
-	else
+	/* store incomming */
+	if (!peer->network.appendData(data, static_cast<size_t>(size)))
 	{
-		if (peer->network.getDataFullSize() > 0
-			&& peer->network.getDataSize() + data_size < peer->network.getDataFullSize())
-		{
-			memcpy(&peer->network.getData()[peer->network.getDataSize()], peer->network.getDataReceive(), data_size);
-			peer->network.setDataSize(peer->network.getDataSize() + data_size);
-		}
-		else
-		{
-			/* store incomming */
-			const auto newBuffer = ALLOC<BYTE>(peer->network.getDataSize() + data_size + 1);
-			memcpy(newBuffer, peer->network.getData(), peer->network.getDataSize());
-			memcpy(&newBuffer[peer->network.getDataSize()], peer->network.getDataReceive(), data_size);
-			newBuffer[peer->network.getDataSize() + data_size] = '\0';
-			peer->network.setDataSize(peer->network.getDataSize() + data_size);
-			peer->network.setData(newBuffer); // pointer swap
-		}
+		peer->network.clear();
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
+		return true;
 	}
 
-	peer->network.reset();
 	ProcessPackets(peer);
 	return false;
 }
@@ -1620,19 +2763,27 @@ bool Net::Server::Server::ValidHeader(NET_PEER peer, bool& use_old_token)
 	return true;
 }
 
-void Net::Server::Server::ProcessPackets(NET_PEER peer)
+bool Net::Server::Server::ProcessPacket(NET_PEER peer)
 {
 	PEER_NOT_VALID(peer,
-		return;
+		return false;
 	);
 
+	// the frame of a streamed packet is consumed piece by piece
+	if (peer->stream.state != peerInfo::stream_t::State_t::IDLE)
+		return ProcessStream(peer);
+
 	if (!peer->network.getDataSize())
-		return;
+		return false;
 
 	if (peer->network.getDataSize() == INVALID_SIZE)
-		return;
+		return false;
 
-	if (peer->network.getDataSize() < NET_PACKET_HEADER_LEN) return;
+	if (peer->network.getDataSize() < NET_PACKET_HEADER_LEN) return false;
+
+	// binary framing, the peer might switch to it as soon as we have offered it
+	if (UseBinaryFraming() && Net::Framing::is_binary(peer->network.getData(), peer->network.getDataSize()))
+		return ProcessFrame(peer);
 
 	auto use_old_token = true;
 	bool already_checked = false;
@@ -1641,67 +2792,50 @@ void Net::Server::Server::ProcessPackets(NET_PEER peer)
 	if (!peer->network.getDataFullSize() || peer->network.getDataFullSize() == INVALID_SIZE)
 	{
 		already_checked = true;
-		if (!ValidHeader(peer, use_old_token)) return;
+		if (!ValidHeader(peer, use_old_token)) return false;
 
 		const size_t start = NET_PACKET_HEADER_LEN + NET_PACKET_SIZE_LEN + 1;
 		for (size_t i = start; i < peer->network.getDataSize(); ++i)
 		{
-			// shift the bytes
-			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-				peer->network.getData()[i] = peer->network.getData()[i] ^ (use_old_token ? peer->lastToken : peer->curToken);
-
-			// iterate until we have found the end tag
-			if (!memcmp(&peer->network.getData()[i], NET_PACKET_BRACKET_CLOSE, 1))
-			{
-				peer->network.SetDataOffset(i);
-				const auto size = i - start;
-				char* end = (char*)peer->network.getData()[start] + size;
-				peer->network.setDataFullSize(strtoull((const char*)&peer->network.getData()[start], &end, 10));
-
-				// awaiting more bytes
-				if (peer->network.getDataFullSize() > peer->network.getDataSize())
-				{
-					// pre-allocate enough space
-					const auto newBuffer = ALLOC<BYTE>(peer->network.getDataFullSize() + 1);
-					memcpy(newBuffer, peer->network.getData(), peer->network.getDataSize());
-					newBuffer[peer->network.getDataFullSize()] = '\0';
-					peer->network.setData(newBuffer); // pointer swap
-
-					// shift all the way back
-					if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-					{
-						for (size_t it = start; it < i + 1; ++it)
-							peer->network.getData()[it] = peer->network.getData()[it] ^ (use_old_token ? peer->lastToken : peer->curToken);
-					}
-
-					return;
-				}
-
-				// shift all the way back
-				if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
-				{
-					for (size_t it = start; it < i + 1; ++it)
-						peer->network.getData()[it] = peer->network.getData()[it] ^ (use_old_token ? peer->lastToken : peer->curToken);
-				}
-
-				break;
-			}
-		}
-	}
-
-	/* Compression */
-	if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-	{
-		const size_t start = peer->network.getDataOffset() + NET_PACKET_ORIGINAL_SIZE_LEN + 2; // 2 - Begin & End Tag
-		for (size_t i = start; i < peer->network.getDataSize(); ++i)
-		{
+			// shift the bytes
+			if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+				peer->network.getData()[i] = peer->network.getData()[i] ^ (use_old_token ? peer->lastToken : peer->curToken);
+
 			// iterate until we have found the end tag
 			if (!memcmp(&peer->network.getData()[i], NET_PACKET_BRACKET_CLOSE, 1))
 			{
 				peer->network.SetDataOffset(i);
 				const auto size = i - start;
 				char* end = (char*)peer->network.getData()[start] + size;
-				peer->network.SetUncompressedSize(strtoull((const char*)&peer->network.getData()[start], &end, 10));
+				peer->network.setDataFullSize(strtoull((const char*)&peer->network.getData()[start], &end, 10));
+
+				// shift all the way back
+				if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
+				{
+					for (size_t it = start; it < i + 1; ++it)
+						peer->network.getData()[it] = peer->network.getData()[it] ^ (use_old_token ? peer->lastToken : peer->curToken);
+				}
+
+				// the size is known, decide before anything gets allocated for it
+				if (!AdmitFrame(peer))
+				{
+					// a dropped frame might be followed by the next one
+					return !peer->bErase && !peer->bDelayed && peer->network.getDataSize() >= NET_PACKET_HEADER_LEN;
+				}
+
+				// awaiting more bytes
+				if (peer->network.getDataFullSize() > peer->network.getDataSize())
+				{
+					// pre-allocate enough space
+					if (!peer->network.reserveData(peer->network.getDataFullSize()))
+					{
+						peer->network.clear();
+						DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
+						return false;
+					}
+
+					return false;
+				}
 
 				break;
 			}
@@ -1709,10 +2843,10 @@ void Net::Server::Server::ProcessPackets(NET_PEER peer)
 	}
 
 	// keep going until we have received the entire packet
-	if (!peer->network.getDataFullSize() || peer->network.getDataFullSize() == INVALID_SIZE || peer->network.getDataSize() < peer->network.getDataFullSize()) return;
+	if (!peer->network.getDataFullSize() || peer->network.getDataFullSize() == INVALID_SIZE || peer->network.getDataSize() < peer->network.getDataFullSize()) return false;
 
 	if (!already_checked)
-		if (!ValidHeader(peer, use_old_token)) return;
+		if (!ValidHeader(peer, use_old_token)) return false;
 
 	// shift only as much as required
 	if (Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP)
@@ -1726,532 +2860,369 @@ void Net::Server::Server::ProcessPackets(NET_PEER peer)
 	{
 		peer->network.clear();
 		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_InvalidFrameFooter);
-		return;
+		return false;
 	}
 
-	// Execute the packet
-	ExecutePacket(peer);
-
-	// re-alloc buffer
-	const auto leftSize = static_cast<int>(peer->network.getDataSize() - peer->network.getDataFullSize()) > 0 ? peer->network.getDataSize() - peer->network.getDataFullSize() : INVALID_SIZE;
-	if (leftSize != INVALID_SIZE
-		&& leftSize > 0)
-	{
-		const auto leftBuffer = ALLOC<BYTE>(leftSize + 1);
-		memcpy(leftBuffer, &peer->network.getData()[peer->network.getDataFullSize()], leftSize);
-		leftBuffer[leftSize] = '\0';
-		peer->network.clear();
-		peer->network.setData(leftBuffer); // swap pointer
-		peer->network.setDataSize(leftSize);
-		return;
-	}
+	received_frame_t frame;
+	frame.data = peer->network.getData();
+	frame.size = peer->network.getDataFullSize();
 
-	peer->network.clear();
+	// Execute the packet
+	if (!DecodeAsync(peer, frame))
+		ExecutePacket(peer, frame);
+
+	// the remaining bytes already belong to the next packet, keep them in place
+	peer->network.consumeData(peer->network.getDataFullSize());
+	peer->network.setDataFullSize(0);
+	peer->network.SetDataOffset(0);
+	peer->network.SetUncompressedSize(0);
+	return true;
 }
 
-struct TPacketExcecute
-{
-	Net::Packet* m_packet;
-	Net::Server::Server* m_server;
-	NET_PEER m_peer;
-	int m_packetId;
-};
-
-NET_THREAD(ThreadPacketExecute)
+/* TOTP masks every byte, the binary header could not be read without trying the tokens */
+bool Net::Server::Server::UseBinaryFraming()
 {
-	auto tpe = (TPacketExcecute*)parameter;
-	if (!tpe)
-	{
-		return 1;
-	}
-
-	if (!tpe->m_server->CheckDataN(tpe->m_peer, tpe->m_packetId, *tpe->m_packet))
-		if (!tpe->m_server->CheckData(tpe->m_peer, tpe->m_packetId, *tpe->m_packet))
-			tpe->m_server->DisconnectPeer(tpe->m_peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
-
-	/* because we had to create a copy to work with this data in seperate thread, we also have to handle the deletion of this block */
-	if (tpe->m_packet->HasRawData())
-	{
-		std::vector<Net::RawData_t>& rawData = tpe->m_packet->GetRawData();
-		for (auto& data : rawData)
-		{
-			data.free();
-		}
-	}
-
-	FREE<Net::Packet>(tpe->m_packet);
-	FREE<TPacketExcecute>(tpe);
-	return 0;
+	return (Isset(NET_OPT_BINARY_FRAMING) ? GetOption<bool>(NET_OPT_BINARY_FRAMING) : NET_OPT_DEFAULT_BINARY_FRAMING)
+		&& !(Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP);
 }
 
-void Net::Server::Server::ExecutePacket(NET_PEER peer)
+/* binary framing: the frame is delimited by the size field of the fixed header */
+bool Net::Server::Server::ProcessFrame(NET_PEER peer)
 {
-	PEER_NOT_VALID(peer,
-		return;
-	);
-
-	NET_CPOINTER<BYTE> data;
-	NET_CPOINTER<Net::Packet> pPacket(ALLOC<Net::Packet>());
-	if (!pPacket.valid())
-	{
-		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
-		return;
-	}
-
-	/* Crypt */
-	if ((Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && peer->cryption.getHandshakeStatus())
+	if (!peer->network.getDataFullSize())
 	{
-		auto offset = peer->network.getDataOffset() + 1;
-
-		NET_CPOINTER<BYTE> AESKey;
-		size_t AESKeySize;
+		if (peer->network.getDataSize() < NET_FRAMING_V2_HEADER_LEN)
+			return false;
 
-		// look for key tag
-		if (!memcmp(&peer->network.getData()[offset], NET_AES_KEY, NET_AES_KEY_LEN))
+		const auto size = Net::Framing::frame_size(peer->network.getData());
+		if (size < NET_FRAMING_V2_HEADER_LEN || size == INVALID_SIZE)
 		{
-			offset += NET_AES_KEY_LEN;
-
-			// read size
-			for (auto y = offset; y < peer->network.getDataSize(); ++y)
-			{
-				if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-				{
-					const auto psize = y - offset - 1;
-					NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-					memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-					dataSizeStr.get()[psize] = '\0';
-					AESKeySize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-					dataSizeStr.free();
-
-					offset += psize + 2;
-					break;
-				}
-			}
-
-			// read the data
-			AESKey = ALLOC<BYTE>(AESKeySize + 1);
-			memcpy(AESKey.get(), &peer->network.getData()[offset], AESKeySize);
-			AESKey.get()[AESKeySize] = '\0';
-
-			offset += AESKeySize;
+			peer->network.clear();
+			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_InvalidFrameHeader);
+			return false;
 		}
 
-		NET_CPOINTER<BYTE> AESIV;
-		size_t AESIVSize;
+		peer->network.setDataFullSize(size);
 
-		// look for iv tag
-		if (!memcmp(&peer->network.getData()[offset], NET_AES_IV, NET_AES_IV_LEN))
+		// the size and the packet id are known, decide before anything gets allocated for it
+		const auto id = Net::Framing::frame_id(peer->network.getData());
+		if (!AdmitFrame(peer) || !RouteFrame(peer, id))
 		{
-			offset += NET_AES_IV_LEN;
-
-			// read size
-			for (auto y = offset; y < peer->network.getDataSize(); ++y)
-			{
-				if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-				{
-					const auto psize = y - offset - 1;
-					NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-					memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-					dataSizeStr.get()[psize] = '\0';
-					AESIVSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-					dataSizeStr.free();
-
-					offset += psize + 2;
-					break;
-				}
-			}
-
-			// read the data
-			AESIV = ALLOC<BYTE>(AESIVSize + 1);
-			memcpy(AESIV.get(), &peer->network.getData()[offset], AESIVSize);
-			AESIV.get()[AESIVSize] = '\0';
-
-			offset += AESIVSize;
+			// a dropped frame might be followed by the next one
+			return !peer->bErase && !peer->bDelayed && peer->network.getDataSize() >= NET_PACKET_HEADER_LEN;
 		}
 
-		if (!peer->cryption.RSA.decryptBase64(AESKey.reference().get(), AESKeySize))
+		// streamed packets are handed out while being received, their frame is never buffered as a whole
+		if (peer->estabilished
+			&& IsPacketStreaming(id)
+			&& !(Net::Framing::frame_flags(peer->network.getData()) & NET_FRAMING_V2_FLAG_COMPRESSION))
 		{
-			AESKey.free();
-			AESIV.free();
-			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DecryptKeyBase64);
-			goto loc_packet_free;
-			return;
-		}
+			peer->stream.state = peerInfo::stream_t::State_t::TABLE;
+			peer->stream.id = id;
 
-		if (!peer->cryption.RSA.decryptBase64(AESIV.reference().get(), AESIVSize))
-		{
-			AESKey.free();
-			AESIV.free();
-			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DecryptIVBase64);
-			goto loc_packet_free;
-			return;
+			// a pause requested while no stream was running is dropped
+			peer->stream.paused = false;
+			return ProcessStream(peer);
 		}
 
-		NET_AES aes;
-		if (!aes.init(reinterpret_cast<const char*>(AESKey.get()), reinterpret_cast<const char*>(AESIV.get())))
+		// pre-allocate enough space
+		if (!peer->network.reserveData(size))
 		{
-			AESKey.free();
-			AESIV.free();
-			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_InitAES);
-			goto loc_packet_free;
-			return;
+			peer->network.clear();
+			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
+			return false;
 		}
+	}
 
-		AESKey.free();
-		AESIV.free();
-
-		do
-		{
-			// look for raw data tag
-			if (!memcmp(&peer->network.getData()[offset], NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN))
-			{
-				offset += NET_RAW_DATA_KEY_LEN;
-
-				// read size
-				NET_CPOINTER<BYTE> key;
-				size_t KeySize = 0;
-				{
-					for (auto y = offset; y < peer->network.getDataSize(); ++y)
-					{
-						if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-						{
-							const auto psize = y - offset - 1;
-							NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-							memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-							dataSizeStr.get()[psize] = '\0';
-							KeySize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-							dataSizeStr.free();
-
-							offset += psize + 2;
-							break;
-						}
-					}
-
-					// read the data
-					key = ALLOC<BYTE>(KeySize + 1);
-					memcpy(key.get(), &peer->network.getData()[offset], KeySize);
-					key.get()[KeySize] = '\0';
-
-					offset += KeySize;
-				}
-
-				// looking for raw data original size tag
-				/* Compression */
-				size_t originalSize = 0;
-				if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-				{
-					if (!memcmp(&peer->network.getData()[offset], NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN))
-					{
-						offset += NET_RAW_DATA_ORIGINAL_SIZE_LEN;
-
-						// read original size
-						for (auto y = offset; y < peer->network.getDataSize(); ++y)
-						{
-							if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-							{
-								const auto psize = y - offset - 1;
-								NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-								memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-								dataSizeStr.get()[psize] = '\0';
-								originalSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-								dataSizeStr.free();
-
-								offset += psize + 2;
-								break;
-							}
-						}
-					}
-				}
+	// keep going until we have received the entire frame
+	if (peer->network.getDataSize() < peer->network.getDataFullSize())
+		return false;
 
-				if (!memcmp(&peer->network.getData()[offset], NET_RAW_DATA, NET_RAW_DATA_LEN))
-				{
-					offset += NET_RAW_DATA_LEN;
+	received_frame_t frame;
+	frame.data = peer->network.getData();
+	frame.size = peer->network.getDataFullSize();
 
-					// read size
-					size_t packetSize = 0;
-					{
-						for (auto y = offset; y < peer->network.getDataSize(); ++y)
-						{
-							if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-							{
-								const auto psize = y - offset - 1;
-								NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-								memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-								dataSizeStr.get()[psize] = '\0';
-								packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-								dataSizeStr.free();
-
-								offset += psize + 2;
-								break;
-							}
-						}
-					}
+	// Execute the packet
+	if (!DecodeAsync(peer, frame))
+		ExecutePacket(peer, frame);
+
+	// the remaining bytes already belong to the next packet, keep them in place
+	peer->network.consumeData(peer->network.getDataFullSize());
+	peer->network.setDataFullSize(0);
+	peer->network.SetDataOffset(0);
+	peer->network.SetUncompressedSize(0);
+	return true;
+}
 
-					Net::RawData_t entry = { (char*)key.get(), &peer->network.getData()[offset], packetSize, false };
+struct TPacketDecode
+{
+	Net::Server::Server* m_server;
+	NET_PEER m_peer;
+	Net::Server::Server::received_frame_t m_frame;
+};
 
-					/* decrypt aes */
-					if (!aes.decrypt(entry.value(), entry.size()))
-					{
-						DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DecryptAES);
-						goto loc_packet_free;
-						return;
-					}
+static void PacketDecodeTask(void* param)
+{
+	auto tpd = (TPacketDecode*)param;
+	if (!tpd)
+	{
+		return;
+	}
 
-					/* Compression */
-					if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-					{
-						BYTE* copy = ALLOC<BYTE>(entry.size());
-						memcpy(copy, entry.value(), entry.size());
-						entry.set(copy);
+	tpd->m_server->ExecutePacket(tpd->m_peer, tpd->m_frame);
 
-						entry.set_original_size(originalSize);
-						DecompressData(entry.value(), entry.size(), entry.original_size());
-						entry.set_original_size(entry.size());
-					}
+	FREE<byte>(tpd->m_frame.data);
+	FREE<TPacketDecode>(tpd);
+}
 
-					/* in seperate thread we need to create a copy of this data-set */
-					if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
-					{
-						BYTE* copy = ALLOC<BYTE>(entry.size());
-						memcpy(copy, entry.value(), entry.size());
-						entry.set(copy);
-					}
+/*
+* NET_OPT_PIPELINE: hand a copy of the frame over to the pipeline workers
+* they decrypt, decompress and parse it, soo the receiving thread continues with the next peer
+*/
+bool Net::Server::Server::DecodeAsync(NET_PEER peer, const received_frame_t& frame)
+{
+	if (!(Isset(NET_OPT_PIPELINE) ? GetOption<bool>(NET_OPT_PIPELINE) : NET_OPT_DEFAULT_PIPELINE))
+		return false;
 
-					pPacket.get()->AddRaw(entry);
-					key.free();
+	TPacketDecode* tpd = ALLOC<TPacketDecode>();
+	if (!tpd)
+		return false;
 
-					offset += packetSize;
-				}
-			}
+	tpd->m_server = this;
+	tpd->m_peer = peer;
+	tpd->m_frame = frame;
+	tpd->m_frame.data = ALLOC<byte>(frame.size);
+	if (!tpd->m_frame.data)
+	{
+		FREE<TPacketDecode>(tpd);
+		return false;
+	}
 
-			// look for data tag
-			if (!memcmp(&peer->network.getData()[offset], NET_DATA, NET_DATA_LEN))
-			{
-				offset += NET_DATA_LEN;
+	memcpy(tpd->m_frame.data, frame.data, frame.size);
 
-				// read size
-				size_t packetSize = 0;
-				{
-					for (auto y = offset; y < peer->network.getDataSize(); ++y)
-					{
-						if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-						{
-							const auto psize = y - offset - 1;
-							NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-							memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-							dataSizeStr.get()[psize] = '\0';
-							packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-							dataSizeStr.free();
-
-							offset += psize + 2;
-							break;
-						}
-					}
-				}
+	// the peer is the key of the strand, soo its frames are decoded in the order they have been received
+	// the binary header tells the packet id, the frame gets decoded within the lane the packet is executed in
+	const auto lane = Net::Framing::is_binary(frame.data, frame.size) ? GetPacketLane(Net::Framing::frame_id(frame.data)) : Net::Lane::Lane_t::BULK;
+	if (PacketPipelinePool.post(peer, &PacketDecodeTask, tpd, lane))
+		return true;
 
-				// read the data
-				size_t dataSize = packetSize;
-				data = ALLOC<BYTE>(dataSize + 1);
-				memcpy(data.get(), &peer->network.getData()[offset], dataSize);
-				data.get()[dataSize] = '\0';
+	FREE<byte>(tpd->m_frame.data);
+	FREE<TPacketDecode>(tpd);
+	return false;
+}
 
-				offset += packetSize;
+/*
+* admission control for the frame whose size has just been read
+* returns false if the frame must not be processed now, it got dropped, delayed or the peer has been disconnected
+*/
+bool Net::Server::Server::AdmitFrame(NET_PEER peer)
+{
+	const auto size = peer->network.getDataFullSize();
+	const auto action = Isset(NET_OPT_RATE_LIMIT_ACTION) ? GetOption<int>(NET_OPT_RATE_LIMIT_ACTION) : NET_OPT_DEFAULT_RATE_LIMIT_ACTION;
 
-				/* decrypt aes */
-				if (!aes.decrypt(data.get(), dataSize))
-				{
-					data.free();
-					DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DecryptAES);
-					goto loc_packet_free;
-					return;
-				}
+	const auto max_frame_size = Isset(NET_OPT_MAX_FRAME_SIZE) ? GetOption<size_t>(NET_OPT_MAX_FRAME_SIZE) : NET_OPT_DEFAULT_MAX_FRAME_SIZE;
+	if (max_frame_size > 0 && size > max_frame_size)
+	{
+		// waiting would not help
+		if (action == NET_RATE_LIMIT_DROP)
+		{
+			++RateLimitCounters.dropped;
+			peer->network.skipData(size);
+			return false;
+		}
 
-				/* Compression */
-				if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-				{
-					DecompressData(data.reference().get(), packetSize, peer->network.getUncompressedSize());
-				}
-			}
+		++RateLimitCounters.disconnected;
+		peer->network.clear();
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_FrameTooBig);
+		return false;
+	}
 
-			// we have reached the end of reading
-			if (offset + NET_PACKET_FOOTER_LEN >= peer->network.getDataFullSize())
-				break;
+	// backpressure: the workers did not catch up with the packets of this peer, only its socket is left alone meanwhile
+	if (PacketPipelinePool.full(peer) || PacketTaskPool.full(peer))
+	{
+		peer->bDelayed = true;
+		peer->network.setDataFullSize(0);
+		peer->network.SetDataOffset(0);
+		return false;
+	}
 
-		} while (true);
+	if (peer->packets_bucket.allow(1) && peer->bytes_bucket.allow(static_cast<double>(size)))
+	{
+		peer->packets_bucket.take(1);
+		peer->bytes_bucket.take(static_cast<double>(size));
+		peer->bDelayed = false;
+		return true;
 	}
-	else
+
+	switch (action)
 	{
-		auto offset = peer->network.getDataOffset() + 1;
+	case NET_RATE_LIMIT_DROP:
+		++RateLimitCounters.dropped;
+		peer->network.skipData(size);
+		return false;
 
-		do
+	case NET_RATE_LIMIT_DISCONNECT:
+		++RateLimitCounters.disconnected;
+		peer->network.clear();
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_RateLimit);
+		return false;
+
+	default:
+		if (!peer->bDelayed)
 		{
-			// look for raw data tag
-			if (!memcmp(&peer->network.getData()[offset], NET_RAW_DATA_KEY, NET_RAW_DATA_KEY_LEN))
-			{
-				offset += NET_RAW_DATA_KEY_LEN;
+			peer->bDelayed = true;
+			++RateLimitCounters.delayed;
+		}
 
-				// read size
-				NET_CPOINTER<BYTE> key;
-				size_t KeySize = 0;
-				{
-					for (auto y = offset; y < peer->network.getDataSize(); ++y)
-					{
-						if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-						{
-							const auto psize = y - offset - 1;
-							NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-							memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-							dataSizeStr.get()[psize] = '\0';
-							KeySize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-							dataSizeStr.free();
-
-							offset += psize + 2;
-							break;
-						}
-					}
+		// the header gets read again once the peer is allowed to continue
+		peer->network.setDataFullSize(0);
+		peer->network.SetDataOffset(0);
+		return false;
+	}
+}
 
-					// read the data
-					key = ALLOC<BYTE>(KeySize + 1);
-					memcpy(key.get(), &peer->network.getData()[offset], KeySize);
-					key.get()[KeySize] = '\0';
+/*
+* binary framing: the packet id has been read from the header of an admitted frame
+* returns false if the frame must not be processed, it got dropped or the peer has been disconnected
+*/
+bool Net::Server::Server::RouteFrame(NET_PEER peer, const int id)
+{
+	if (id < 0)
+	{
+		peer->network.clear();
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_MemberIDInvalid);
+		return false;
+	}
 
-					offset += KeySize;
-				}
+	// the same result the execution would have had, without receiving, decrypting and parsing the body first
+	if ((Isset(NET_OPT_REJECT_UNKNOWN_PACKETS) ? GetOption<bool>(NET_OPT_REJECT_UNKNOWN_PACKETS) : NET_OPT_DEFAULT_REJECT_UNKNOWN_PACKETS)
+		&& !IsPacketDefined(peer, id))
+	{
+		peer->network.clear();
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
+		return false;
+	}
 
-				// looking for raw data original size tag
-				/* Compression */
-				size_t originalSize = 0;
-				if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-				{
-					if (!memcmp(&peer->network.getData()[offset], NET_RAW_DATA_ORIGINAL_SIZE, NET_RAW_DATA_ORIGINAL_SIZE_LEN))
-					{
-						offset += NET_RAW_DATA_ORIGINAL_SIZE_LEN;
-
-						// read original size
-						for (auto y = offset; y < peer->network.getDataSize(); ++y)
-						{
-							if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-							{
-								const auto psize = y - offset - 1;
-								NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-								memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-								dataSizeStr.get()[psize] = '\0';
-								originalSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-								dataSizeStr.free();
-
-								offset += psize + 2;
-								break;
-							}
-						}
-					}
-				}
+	if (!OnPacketFilter(peer, id))
+	{
+		++RateLimitCounters.filtered;
+		peer->network.skipData(peer->network.getDataFullSize());
+		return false;
+	}
 
-				if (!memcmp(&peer->network.getData()[offset], NET_RAW_DATA, NET_RAW_DATA_LEN))
-				{
-					offset += NET_RAW_DATA_LEN;
+	return true;
+}
 
-					// read size
-					size_t packetSize = 0;
-					{
-						for (auto y = offset; y < peer->network.getDataSize(); ++y)
-						{
-							if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-							{
-								const auto psize = y - offset - 1;
-								NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-								memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-								dataSizeStr.get()[psize] = '\0';
-								packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-								dataSizeStr.free();
-
-								offset += psize + 2;
-								break;
-							}
-						}
-					}
+bool Net::Server::Server::IsPacketDefined(NET_PEER peer, const int id)
+{
+	Net::Packet probe;
+	probe.SetProbe(true);
 
-					Net::RawData_t entry = { (char*)key.get(), &peer->network.getData()[offset], packetSize, false };
+	return CheckDataN(peer, id, probe) || CheckData(peer, id, probe);
+}
 
-					/* Compression */
-					if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-					{
-						BYTE* copy = ALLOC<BYTE>(entry.size());
-						memcpy(copy, entry.value(), entry.size());
-						entry.set(copy);
+void Net::Server::Server::ContinueDelayed(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
 
-						entry.set_original_size(originalSize);
-						DecompressData(entry.value(), entry.size(), entry.original_size());
-						entry.set_original_size(entry.size());
-					}
+	if (peer->bDelayed)
+		ProcessPackets(peer);
+}
 
-					/* in seperate thread we need to create a copy of this data-set */
-					if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
-					{
-						BYTE* copy = ALLOC<BYTE>(entry.size());
-						memcpy(copy, entry.value(), entry.size());
-						entry.set(copy);
-					}
+/* a single read might contain several frames, execute all of them before waiting for more */
+void Net::Server::Server::ProcessPackets(NET_PEER peer)
+{
+	while (ProcessPacket(peer))
+	{
+		if (peer->bErase)
+			break;
+	}
+}
 
-					pPacket.get()->AddRaw(entry);
-					key.free();
+struct TPacketExcecute
+{
+	Net::Packet* m_packet;
+	Net::Server::Server* m_server;
+	NET_PEER m_peer;
+	int m_packetId;
+};
 
-					offset += packetSize;
-				}
-			}
+static void PacketExecuteTask(void* param)
+{
+	auto tpe = (TPacketExcecute*)param;
+	if (!tpe)
+	{
+		return;
+	}
 
-			// look for data tag
-			if (!memcmp(&peer->network.getData()[offset], NET_DATA, NET_DATA_LEN))
-			{
-				offset += NET_DATA_LEN;
+#ifdef NET_USE_COROUTINES
+	// a suspended handler continues on the strand of its peer
+	Net::Coroutine::Scope_t scope(tpe->m_server->PacketPool(), tpe->m_peer);
+#endif
 
-				// read size
-				size_t packetSize = 0;
-				{
-					for (auto y = offset; y < peer->network.getDataSize(); ++y)
-					{
-						if (!memcmp(&peer->network.getData()[y], NET_PACKET_BRACKET_CLOSE, 1))
-						{
-							const auto psize = y - offset - 1;
-							NET_CPOINTER<BYTE> dataSizeStr(ALLOC<BYTE>(psize + 1));
-							memcpy(dataSizeStr.get(), &peer->network.getData()[offset + 1], psize);
-							dataSizeStr.get()[psize] = '\0';
-							packetSize = strtoull(reinterpret_cast<const char*>(dataSizeStr.get()), nullptr, 10);
-							dataSizeStr.free();
-
-							offset += psize + 2;
-							break;
-						}
-					}
-				}
+	if (!tpe->m_server->CheckDataN(tpe->m_peer, tpe->m_packetId, *tpe->m_packet))
+		if (!tpe->m_server->CheckData(tpe->m_peer, tpe->m_packetId, *tpe->m_packet))
+			tpe->m_server->DisconnectPeer(tpe->m_peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
 
-				// read the data
-				data = ALLOC<BYTE>(packetSize + 1);
-				memcpy(data.get(), &peer->network.getData()[offset], packetSize);
-				data.get()[packetSize] = '\0';
+	// the replies of the handler go out together
+	tpe->m_server->FlushCorked(tpe->m_peer);
 
-				offset += packetSize;
+	/* because we had to create a copy to work with this data in seperate thread, we also have to handle the deletion of this block */
+	if (tpe->m_packet->HasRawData())
+	{
+		std::vector<Net::RawData_t>& rawData = tpe->m_packet->GetRawData();
+		for (auto& data : rawData)
+		{
+			data.free();
+		}
+	}
 
-				/* Compression */
-				if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-				{
-					DecompressData(data.reference().get(), packetSize, peer->network.getUncompressedSize());
-				}
-			}
+	FREE<Net::Packet>(tpe->m_packet);
+	FREE<TPacketExcecute>(tpe);
+}
 
-			// we have reached the end of reading
-			if (offset + NET_PACKET_FOOTER_LEN >= peer->network.getDataFullSize())
-				break;
+void Net::Server::Server::ExecutePacket(NET_PEER peer, const received_frame_t& frame)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
 
-		} while (true);
+	NET_CPOINTER<BYTE> data;
+	NET_CPOINTER<Net::Packet> pPacket(ALLOC<Net::Packet>());
+	if (!pPacket.valid())
+	{
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
+		return;
 	}
 
-	if (!data.valid())
+	/* the sections are read in place, the json document and the raw data are the only things being copied */
+	if (!DecodeFrame(peer, frame, *pPacket.get(), data))
 	{
-		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
-		goto loc_packet_free;
+		pPacket.free();
 		return;
 	}
 
+	/*
+	* binary framing: the packet id is part of the header
+	* the handler parses the json document the first time it reads it
+	*/
+	int packetId = -1;
+	if (Net::Framing::is_binary(frame.data, frame.size))
+	{
+		packetId = Net::Framing::frame_id(frame.data);
+		if (packetId < 0)
+		{
+			data.free();
+			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_MemberIDInvalid);
+			goto loc_packet_free;
+			return;
+		}
+
+		pPacket.get()->SetBody(data.get());
+		data = nullptr;
+	}
 	/*
 	* parse json
 	* get packet id from it
@@ -2259,7 +3230,7 @@ void Net::Server::Server::ExecutePacket(NET_PEER peer)
 	*
 	* pass the json content into pPacket object
 	*/
-	int packetId = -1;
+	else
 	{
 		Net::Json::Document doc;
 		if (!doc.Deserialize(reinterpret_cast<char*>(data.get())))
@@ -2306,16 +3277,19 @@ void Net::Server::Server::ExecutePacket(NET_PEER peer)
 	}
 
 	/*
-	* check for option async to execute the callback in a seperate thread
+	* check for option async to execute the callback on the packet workers
+	* the peer is the key of the strand, soo its packets keep their order within their lane
+	* native packets change the state the next frame gets decoded with, they are never deferred
 	*/
-	if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
+	if ((Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
+		&& packetId >= NET_LAST_PACKET_ID)
 	{
 		TPacketExcecute* tpe = ALLOC<TPacketExcecute>();
 		tpe->m_packet = pPacket.get();
 		tpe->m_server = this;
 		tpe->m_peer = peer;
 		tpe->m_packetId = packetId;
-		if (Net::Thread::Create(ThreadPacketExecute, tpe))
+		if (PacketTaskPool.post(peer, &PacketExecuteTask, tpe, GetPacketLane(packetId)))
 		{
 			return;
 		}
@@ -2323,29 +3297,474 @@ void Net::Server::Server::ExecutePacket(NET_PEER peer)
 		FREE<TPacketExcecute>(tpe);
 	}
 
-	/*
-	* execute in current thread
-	*/
-	if (!CheckDataN(peer, packetId, *pPacket.ref().get()))
-		if (!CheckData(peer, packetId, *pPacket.ref().get()))
-			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
+	/*
+	* execute in current thread
+	*/
+	{
+#ifdef NET_USE_COROUTINES
+		// without packet workers a suspended handler continues where the packets of its peer are executed
+		Net::Coroutine::Scope_t scope(ResumePool(), peer, &peer->coroutines);
+#endif
+
+		if (!CheckDataN(peer, packetId, *pPacket.ref().get()))
+			if (!CheckData(peer, packetId, *pPacket.ref().get()))
+				DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
+
+		// the replies of the handler go out together
+		FlushCorked(peer);
+	}
+
+loc_packet_free:
+	// if we use compression mode here, then we had to take a copy of the buffer to process the algo to decompress the block, now we have to handle the deletion of this block
+	// the same applies to the copy being taken for the packet workers if they did not accept the packet
+	/* Compression */
+	if ((Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+		|| (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC))
+	{
+		if (pPacket.get()->HasRawData())
+		{
+			std::vector<Net::RawData_t>& rawData = pPacket.get()->GetRawData();
+			for (auto& data : rawData)
+			{
+				data.free();
+			}
+		}
+	}
+
+	pPacket.free();
+}
+
+/*
+* SetPacketStreaming: only the section table is buffered, the payload is consumed as soon as it has been received
+* the raw data gets decrypted in place and handed to OnPacketStream, the json document is kept for the handler
+* returns true once the frame is complete, soo the next one gets processed
+*/
+bool Net::Server::Server::ProcessStream(NET_PEER peer)
+{
+	auto& stream = peer->stream;
+
+	const auto fail = [&](const int code) -> bool
+	{
+		stream.clear();
+		peer->bDelayed = false;
+		peer->network.clear();
+		DisconnectPeer(peer, code);
+		return false;
+	};
+
+	if (stream.state == peerInfo::stream_t::State_t::TABLE)
+	{
+		if (peer->network.getDataSize() < Net::Framing::table_size(peer->network.getData()))
+			return false;
+
+		if (!stream.reader.begin(peer->network.getData()))
+			return fail(NET_ERROR_CODE::NET_ERR_InvalidFrameHeader);
+
+		// compressed frames are never streamed, both sides agree on it before the first frame
+		const bool cipher = (Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && peer->cryption.getHandshakeStatus();
+		const bool compression = Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION;
+		if (((Net::Framing::frame_flags(peer->network.getData()) & NET_FRAMING_V2_FLAG_CIPHER) != 0) != cipher || compression)
+			return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+		stream.cipher = cipher;
+		peer->network.consumeData(Net::Framing::table_size(peer->network.getData()));
+
+		// the packets received before are executed first, the stream keeps the order of the peer
+		stream.state = peerInfo::stream_t::State_t::START;
+		stream.started = false;
+		StartStream(peer);
+	}
+
+	if (stream.state == peerInfo::stream_t::State_t::START)
+	{
+		// the socket is not read until then, the peer gets visited again on each tick
+		if (!stream.started)
+		{
+			peer->bDelayed = true;
+			return false;
+		}
+
+		stream.state = peerInfo::stream_t::State_t::BODY;
+	}
+
+	for (;;)
+	{
+		// backpressure, the socket is not read until the stream gets resumed
+		if (stream.paused)
+		{
+			peer->bDelayed = true;
+			return false;
+		}
+
+		peer->bDelayed = false;
+
+		if (stream.reader.done())
+			return FinishStream(peer);
+
+		size_t consumed = 0;
+		Net::Framing::piece_t piece;
+		if (!stream.reader.read(peer->network.getData(), peer->network.getDataSize(), consumed, piece))
+			return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+		// keep going until we have received more
+		if (!consumed && !piece.complete)
+			return false;
+
+		switch (piece.type)
+		{
+		case Net::Framing::Section_t::AES_KEY:
+		case Net::Framing::Section_t::AES_IV:
+		{
+			auto& buffer = (piece.type == Net::Framing::Section_t::AES_KEY ? stream.key : stream.iv);
+			auto& buffer_size = (piece.type == Net::Framing::Section_t::AES_KEY ? stream.key_size : stream.iv_size);
+
+			if (piece.offset == 0)
+			{
+				if (!stream.cipher || stream.aes || buffer.valid() || piece.total > NET_STREAM_MAX_KEY_SIZE)
+					return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+				buffer_size = piece.total;
+				buffer = ALLOC<BYTE>(buffer_size + 1);
+				if (!buffer.valid())
+					return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+			}
+
+			memcpy(buffer.get() + piece.offset, piece.data, piece.size);
+			break;
+		}
+
+		default:
+			// key and iv are in front of the first section using them
+			if (stream.cipher && !stream.aes)
+			{
+				if (!stream.key.valid() || !stream.iv.valid())
+					return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+				if (!peer->cryption.RSA.decryptBase64(stream.key.reference().get(), stream.key_size))
+					return fail(NET_ERROR_CODE::NET_ERR_DecryptKeyBase64);
+
+				if (!peer->cryption.RSA.decryptBase64(stream.iv.reference().get(), stream.iv_size))
+					return fail(NET_ERROR_CODE::NET_ERR_DecryptIVBase64);
+
+				stream.aes = ALLOC<NET_AES>();
+				if (!stream.aes || !stream.aes->init(reinterpret_cast<const char*>(stream.key.get()), reinterpret_cast<const char*>(stream.iv.get())))
+					return fail(NET_ERROR_CODE::NET_ERR_InitAES);
+
+				stream.key.free();
+				stream.iv.free();
+			}
+
+			// each section is encrypted on its own
+			if (stream.cipher && piece.offset == 0 && !stream.aes->beginStream())
+				return fail(NET_ERROR_CODE::NET_ERR_DecryptAES);
+
+			if (stream.cipher && piece.size && !stream.aes->decryptStream(piece.data, piece.size))
+				return fail(NET_ERROR_CODE::NET_ERR_DecryptAES);
+
+			if (piece.type == Net::Framing::Section_t::RAW_DATA)
+			{
+				// nothing to hand out as long as the key of the section is incomplete
+				if ((piece.size || piece.complete)
+					&& !OnPacketStream(peer, stream.id, piece.key, piece.data, piece.size, piece.offset, piece.total))
+				{
+					if (peer->bErase)
+						return false;
+
+					return fail(NET_ERROR_CODE::NET_ERR_StreamAborted);
+				}
+
+				break;
+			}
+
+			// one json document per frame
+			if (piece.offset == 0)
+			{
+				if (stream.json.valid())
+					return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+				stream.json_size = piece.total;
+				stream.json = ALLOC<BYTE>(stream.json_size + 1);
+				if (!stream.json.valid())
+					return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+			}
+
+			memcpy(stream.json.get() + piece.offset, piece.data, piece.size);
+			break;
+		}
+
+		peer->network.consumeData(consumed);
+
+		// the handler might have disconnected the peer
+		if (peer->bErase)
+			return false;
+	}
+}
+
+struct TStreamStart
+{
+	Net::Server::Server* m_server;
+	NET_PEER m_peer;
+	Net::TaskPool::TaskPool_t* m_pool;
+	std::atomic<size_t> m_pending;
+};
+
+static void StreamStartTask(void* param)
+{
+	auto tss = (TStreamStart*)param;
+	if (!tss)
+	{
+		return;
+	}
+
+	// the tasks of a lane are executed in order, the last one runs behind every packet received before
+	if (--tss->m_pending)
+		return;
+
+	tss->m_server->StartStream(tss->m_peer, tss->m_pool);
+	FREE<TStreamStart>(tss);
+}
+
+void Net::Server::Server::StartStream(NET_PEER peer, Net::TaskPool::TaskPool_t* passed)
+{
+	// the pipeline hands its packets over to the packet workers, soo it has to be passed first
+	Net::TaskPool::TaskPool_t* pool = nullptr;
+	if (!passed && PacketPipelinePool.is_running())
+		pool = &PacketPipelinePool;
+	else if (passed != &PacketTaskPool && PacketTaskPool.is_running())
+		pool = &PacketTaskPool;
+
+	if (!pool)
+	{
+		peer->stream.started = true;
+		return;
+	}
+
+	TStreamStart* tss = ALLOC<TStreamStart>();
+	if (!tss)
+	{
+		// out of memory, wait for the strand instead
+		pool->wait(peer);
+		StartStream(peer, pool);
+		return;
+	}
+
+	tss->m_server = this;
+	tss->m_peer = peer;
+	tss->m_pool = pool;
+	tss->m_pending = NET_LANES;
+
+	for (size_t lane = 0; lane < NET_LANES; ++lane)
+	{
+		if (!pool->post(peer, &StreamStartTask, tss, static_cast<Net::Lane::Lane_t>(lane)))
+			StreamStartTask(tss);
+	}
+}
+
+/* the raw data has been handed out, the handler gets executed with the json document */
+bool Net::Server::Server::FinishStream(NET_PEER peer)
+{
+	auto& stream = peer->stream;
+	const auto packetId = stream.id;
+
+	NET_CPOINTER<Net::Packet> pPacket;
+	if (stream.json.valid())
+		pPacket = ALLOC<Net::Packet>();
+
+	if (!pPacket.valid())
+	{
+		stream.clear();
+		peer->network.clear();
+		DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_DataInvalid);
+		return false;
+	}
+
+	pPacket.get()->SetBody(stream.json.get());
+	stream.json = nullptr;
+	stream.clear();
+
+	// the remaining bytes already belong to the next packet
+	peer->network.setDataFullSize(0);
+	peer->network.SetDataOffset(0);
+	peer->network.SetUncompressedSize(0);
+
+	// native packets are never streamed
+	if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
+	{
+		TPacketExcecute* tpe = ALLOC<TPacketExcecute>();
+		if (tpe)
+		{
+			tpe->m_packet = pPacket.get();
+			tpe->m_server = this;
+			tpe->m_peer = peer;
+			tpe->m_packetId = packetId;
+			if (PacketTaskPool.post(peer, &PacketExecuteTask, tpe, GetPacketLane(packetId)))
+				return true;
+
+			FREE<TPacketExcecute>(tpe);
+		}
+	}
+
+	{
+#ifdef NET_USE_COROUTINES
+		Net::Coroutine::Scope_t scope(ResumePool(), peer, &peer->coroutines);
+#endif
+
+		if (!CheckDataN(peer, packetId, *pPacket.ref().get()))
+			if (!CheckData(peer, packetId, *pPacket.ref().get()))
+				DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
+
+		// the replies of the handler go out together
+		FlushCorked(peer);
+	}
+
+	pPacket.free();
+	return !peer->bErase;
+}
+
+/*
+* both framings go through the same view: every length has been validated once, the sections are read in place
+* both sides agree on cipher and compression before the first frame, the flags have to match them
+*/
+bool Net::Server::Server::DecodeFrame(NET_PEER peer, const received_frame_t& frame, Net::Packet& packet, NET_CPOINTER<BYTE>& data)
+{
+	const bool cipher = (Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER) && peer->cryption.getHandshakeStatus();
+	const bool compression = Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION;
+	const bool copy = compression || (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC);
+
+	NET_CPOINTER<BYTE> AESKey;
+	size_t AESKeySize = 0;
+	NET_CPOINTER<BYTE> AESIV;
+	size_t AESIVSize = 0;
+	NET_AES aes;
+	bool aes_ready = false;
+
+	const auto fail = [&](const int code) -> bool
+	{
+		AESKey.free();
+		AESIV.free();
+		data.free();
+
+		// the raw data copies belong to us until the packet gets executed
+		if (copy)
+		{
+			for (auto& entry : packet.GetRawData())
+				entry.free();
+		}
+
+		DisconnectPeer(peer, code);
+		return false;
+	};
+
+	Net::Framing::View_t view;
+	if (!view.parse(frame.data, frame.size))
+		return fail(NET_ERROR_CODE::NET_ERR_InvalidFrameHeader);
+
+	if (((view.flags() & NET_FRAMING_V2_FLAG_CIPHER) != 0) != cipher
+		|| ((view.flags() & NET_FRAMING_V2_FLAG_COMPRESSION) != 0) != compression)
+		return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+	Net::Framing::section_t section;
+	while (view.next(section))
+	{
+		switch (section.type)
+		{
+		case Net::Framing::Section_t::AES_KEY:
+			if (!cipher || AESKey.valid())
+				return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+			AESKeySize = section.size;
+			AESKey = ALLOC<BYTE>(AESKeySize + 1);
+			memcpy(AESKey.get(), section.data, AESKeySize);
+			AESKey.get()[AESKeySize] = '\0';
+			break;
+
+		case Net::Framing::Section_t::AES_IV:
+			if (!cipher || AESIV.valid())
+				return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+			AESIVSize = section.size;
+			AESIV = ALLOC<BYTE>(AESIVSize + 1);
+			memcpy(AESIV.get(), section.data, AESIVSize);
+			AESIV.get()[AESIVSize] = '\0';
+			break;
+
+		default:
+			// key and iv are in front of the first section using them
+			if (cipher && !aes_ready)
+			{
+				if (!AESKey.valid() || !AESIV.valid())
+					return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+				if (!peer->cryption.RSA.decryptBase64(AESKey.reference().get(), AESKeySize))
+					return fail(NET_ERROR_CODE::NET_ERR_DecryptKeyBase64);
+
+				if (!peer->cryption.RSA.decryptBase64(AESIV.reference().get(), AESIVSize))
+					return fail(NET_ERROR_CODE::NET_ERR_DecryptIVBase64);
+
+				if (!aes.init(reinterpret_cast<const char*>(AESKey.get()), reinterpret_cast<const char*>(AESIV.get())))
+					return fail(NET_ERROR_CODE::NET_ERR_InitAES);
 
-loc_packet_free:
-	// if we use compression mode here, then we had to take a copy of the buffer to process the algo to decompress the block, now we have to handle the deletion of this block
-	/* Compression */
-	if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
-	{
-		if (pPacket.get()->HasRawData())
-		{
-			std::vector<Net::RawData_t>& rawData = pPacket.get()->GetRawData();
-			for (auto& data : rawData)
+				AESKey.free();
+				AESIV.free();
+				aes_ready = true;
+			}
+
+			if (section.type == Net::Framing::Section_t::RAW_DATA)
 			{
-				data.free();
+				Net::RawData_t entry = { section.key, section.data, section.size, false };
+
+				/* decrypt aes */
+				if (cipher && !aes.decrypt(entry.value(), entry.size()))
+					return fail(NET_ERROR_CODE::NET_ERR_DecryptAES);
+
+				/* Compression */
+				if (compression)
+				{
+					BYTE* buffer = ALLOC<BYTE>(entry.size());
+					memcpy(buffer, entry.value(), entry.size());
+					entry.set(buffer);
+
+					entry.set_original_size(section.original_size);
+					DecompressData(entry.value(), entry.size(), entry.original_size());
+					entry.set_original_size(entry.size());
+				}
+				/* in seperate thread we need to create a copy of this data-set */
+				else if (copy)
+				{
+					BYTE* buffer = ALLOC<BYTE>(entry.size());
+					memcpy(buffer, entry.value(), entry.size());
+					entry.set(buffer);
+				}
+
+				packet.AddRaw(entry);
+				break;
 			}
+
+			// one json document per frame
+			if (data.valid())
+				return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+			size_t dataSize = section.size;
+			data = ALLOC<BYTE>(dataSize + 1);
+			memcpy(data.get(), section.data, dataSize);
+			data.get()[dataSize] = '\0';
+
+			/* decrypt aes */
+			if (cipher && !aes.decrypt(data.get(), dataSize))
+				return fail(NET_ERROR_CODE::NET_ERR_DecryptAES);
+
+			/* Compression */
+			if (compression)
+				DecompressData(data.reference().get(), dataSize, section.original_size);
+
+			break;
 		}
 	}
 
-	pPacket.free();
+	if (!data.valid())
+		return fail(NET_ERROR_CODE::NET_ERR_DataInvalid);
+
+	return true;
 }
 
 void Net::Server::Server::CompressData(BYTE*& data, size_t& size)
@@ -2519,9 +3938,18 @@ if ((majorVersion == Version::Major())
 {
 	peer->NetVersionMatched = true;
 
+	// the client offers the binary framing, the answer still goes out using the text framing
+	const bool binary = UseBinaryFraming()
+		&& PKG[CSTRING("Framing")] && PKG[CSTRING("Framing")]->is_int()
+		&& PKG[CSTRING("Framing")]->as_int() >= NET_FRAMING_V2;
+
 	Packet estabilish;
+	if (binary) estabilish[CSTRING("Framing")] = NET_FRAMING_V2;
 	NET_SEND(peer, NET_NATIVE_PACKET_ID::PKG_Estabilish, estabilish);
 
+	if (binary)
+		peer->framing = NET_FRAMING_V2;
+
 	peer->estabilished = true;
 
 	NET_LOG_PEER(CSTRING("'%s' :: [%s] => estabilished"), SERVERNAME(this), peer->IPAddr().get());
@@ -2529,6 +3957,9 @@ if ((majorVersion == Version::Major())
 	Net::Timer::WaitSingleObjectStopped(peer->hWaitForNetProtocol);
 	peer->hWaitForNetProtocol = nullptr;
 
+	// broadcasts only reach peers that completed the handshake
+	PeerRegistry.add(peer->UniqueID, peer);
+
 	// callback
 	OnPeerEstabilished(peer);
 }
@@ -2551,8 +3982,25 @@ void Net::Server::Server::add_to_peer_threadpool(Net::PeerPool::peerInfo_t * pin
 	PeerPoolManager.add(pinfo);
 }
 
+#ifdef BUILD_LINUX
+bool Net::Server::Server::add_to_peer_reactor(SOCKET fd, Net::PeerPool::peerInfo_t info, size_t worker)
+{
+	return PeerReactorManager.add(fd, info, worker);
+}
+
+bool Net::Server::Server::peer_reactor_uses_uring() const
+{
+	return PeerReactorManager.is_running() && PeerReactorManager.uses_uring();
+}
+#endif
+
 size_t Net::Server::Server::count_peers_all()
 {
+#ifdef BUILD_LINUX
+	if (PeerReactorManager.is_running())
+		return PeerReactorManager.count_peers_all();
+#endif
+
 	return PeerPoolManager.count_peers_all();
 }
 
@@ -2566,6 +4014,379 @@ size_t Net::Server::Server::count_pools()
 	return PeerPoolManager.count_pools();
 }
 
+Net::TaskPool::TaskPool_t* Net::Server::Server::PacketPool()
+{
+	return PacketTaskPool.is_running() ? &PacketTaskPool : nullptr;
+}
+
+Net::TaskPool::TaskPool_t* Net::Server::Server::ResumePool()
+{
+	if (PacketTaskPool.is_running())
+		return &PacketTaskPool;
+
+	return PacketPipelinePool.is_running() ? &PacketPipelinePool : nullptr;
+}
+
+size_t Net::Server::Server::GetPacketQueueDepth() const
+{
+	return PacketTaskPool.depth();
+}
+
+size_t Net::Server::Server::GetPacketQueuePeak() const
+{
+	return PacketTaskPool.peak_depth();
+}
+
+size_t Net::Server::Server::GetPacketQueueThrottled() const
+{
+	return PacketTaskPool.throttled();
+}
+
+size_t Net::Server::Server::GetPipelineQueueDepth() const
+{
+	return PacketPipelinePool.depth();
+}
+
+size_t Net::Server::Server::GetPipelineQueuePeak() const
+{
+	return PacketPipelinePool.peak_depth();
+}
+
+size_t Net::Server::Server::GetPipelineQueueThrottled() const
+{
+	return PacketPipelinePool.throttled();
+}
+
+void Net::Server::Server::SetPacketLane(const int id, const Net::Lane::Lane_t lane)
+{
+	if (id < NET_LAST_PACKET_ID)
+		return;
+
+	if (static_cast<size_t>(id) >= PacketLanes.size())
+		PacketLanes.resize(static_cast<size_t>(id) + 1, Net::Lane::Lane_t::BULK);
+
+	PacketLanes[id] = lane;
+}
+
+Net::Lane::Lane_t Net::Server::Server::GetPacketLane(const int id) const
+{
+	if (id < NET_LAST_PACKET_ID)
+		return Net::Lane::Lane_t::NATIVE;
+
+	if (static_cast<size_t>(id) >= PacketLanes.size())
+		return Net::Lane::Lane_t::BULK;
+
+	return PacketLanes[id];
+}
+
+void Net::Server::Server::SetPacketStreaming(const int id, const bool enable)
+{
+	if (id < NET_LAST_PACKET_ID)
+		return;
+
+	if (static_cast<size_t>(id) >= PacketStreams.size())
+		PacketStreams.resize(static_cast<size_t>(id) + 1, false);
+
+	PacketStreams[id] = enable;
+}
+
+bool Net::Server::Server::IsPacketStreaming(const int id) const
+{
+	if (id < NET_LAST_PACKET_ID || static_cast<size_t>(id) >= PacketStreams.size())
+		return false;
+
+	return PacketStreams[id];
+}
+
+void Net::Server::Server::PauseStream(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	// the state belongs to the worker of the peer, it applies the request on its next visit
+	peer->stream.paused = true;
+}
+
+void Net::Server::Server::ResumeStream(NET_PEER peer)
+{
+	PEER_NOT_VALID(peer,
+		return;
+	);
+
+	peer->stream.paused = false;
+}
+
+NET_PEER Net::Server::Server::GetPeer(const NET_UID uid)
+{
+	return static_cast<NET_PEER>(PeerRegistry.find(uid));
+}
+
+size_t Net::Server::Server::GetPeerCount() const
+{
+	return PeerRegistry.count();
+}
+
+size_t Net::Server::Server::ForEachPeer(void (*fnc)(NET_PEER peer, void* param), void* param)
+{
+	if (!fnc)
+		return 0;
+
+	return PeerRegistry.for_each([fnc, param](void* peer) { (*fnc)(static_cast<NET_PEER>(peer), param); });
+}
+
+bool Net::Server::Server::JoinGroup(NET_PEER peer, const char* group)
+{
+	PEER_NOT_VALID(peer,
+		return false;
+	);
+
+	return PeerRegistry.join(group, peer->UniqueID);
+}
+
+bool Net::Server::Server::LeaveGroup(NET_PEER peer, const char* group)
+{
+	PEER_NOT_VALID(peer,
+		return false;
+	);
+
+	return PeerRegistry.leave(group, peer->UniqueID);
+}
+
+size_t Net::Server::Server::GetGroupSize(const char* group) const
+{
+	return PeerRegistry.count(group);
+}
+
+/* serialized and compressed once, shared by all recipients of a broadcast */
+struct Net::Server::Server::broadcast_t
+{
+	int id;
+	BYTE* data;
+	size_t size;
+	size_t original_size;
+	std::vector<Net::RawData_t> raw;
+
+	/* the complete unencrypted frame per framing, encoded for the first recipient that needs it */
+	Net::Frame::Shared_t* plain[NET_FRAMING_V2];
+
+	broadcast_t()
+	{
+		id = 0;
+		data = nullptr;
+		size = 0;
+		original_size = 0;
+
+		for (auto& entry : plain)
+			entry = nullptr;
+	}
+
+	~broadcast_t()
+	{
+		FREE<BYTE>(data);
+
+		for (auto& entry : raw)
+			entry.free();
+
+		for (const auto entry : plain)
+			if (entry) entry->release();
+	}
+
+	/* EncodeFrame consumes what it gets, every call gets its own copy */
+	BYTE* copy_data() const
+	{
+		auto copy = ALLOC<BYTE>(size + 1);
+		memcpy(copy, data, size);
+		copy[size] = '\0';
+		return copy;
+	}
+
+	std::vector<Net::RawData_t> copy_raw() const
+	{
+		std::vector<Net::RawData_t> copies;
+		copies.reserve(raw.size());
+		for (const auto& entry : raw)
+		{
+			auto copy = ALLOC<byte>(entry.size() + 1);
+			memcpy(copy, entry.value(), entry.size());
+
+			Net::RawData_t data(entry.key(), copy, entry.size(), true);
+			data.set_original_size(entry.original_size());
+			copies.emplace_back(data);
+		}
+
+		return copies;
+	}
+};
+
+bool Net::Server::Server::EncodeBroadcast(const int id, NET_PACKET& pkg, broadcast_t& encoded)
+{
+	// the copies are taken from memory
+	if (PKG.HasRawData() && !PKG.LoadRawFiles())
+		return false;
+
+	Net::Json::Document doc;
+	doc[CSTRING("ID")] = id;
+	doc[CSTRING("CONTENT")] = pkg.Data();
+
+	auto buffer = doc.Serialize(Net::Json::SerializeType::UNFORMATTED);
+
+	encoded.id = id;
+	encoded.size = buffer.size();
+	encoded.data = ALLOC<BYTE>(encoded.size + 1);
+	memcpy(encoded.data, buffer.get().get(), encoded.size);
+	encoded.data[encoded.size] = '\0';
+	buffer.clear();
+
+	// the packet stays untouched, it can be reused by the caller
+	for (auto& entry : PKG.GetRawData())
+	{
+		auto copy = ALLOC<byte>(entry.size() + 1);
+		memcpy(copy, entry.value(), entry.size());
+		encoded.raw.emplace_back(entry.key(), copy, entry.size(), true);
+	}
+
+	/* Compression */
+	encoded.original_size = encoded.size;
+	if (Isset(NET_OPT_USE_COMPRESSION) ? GetOption<bool>(NET_OPT_USE_COMPRESSION) : NET_OPT_DEFAULT_USE_COMPRESSION)
+	{
+		CompressData(encoded.data, encoded.size);
+
+		for (auto& entry : encoded.raw)
+		{
+			entry.set_original_size(entry.size());
+			CompressData(entry.value(), entry.size());
+		}
+	}
+
+	return true;
+}
+
+/*
+* only the per peer steps are done for every recipient
+* the plain frame is referenced by all send queues without copying it, TOTP masks a private copy
+* peers using the cipher get the compressed bytes encrypted using their own session key
+* returns false if the peer did not get it
+*/
+bool Net::Server::Server::DoSendEncoded(NET_PEER peer, broadcast_t& encoded)
+{
+	PEER_NOT_VALID(peer,
+		return false;
+	);
+
+	// the framing and the session key are negotiated during the handshake
+	if (peer->bErase || !peer->estabilished)
+		return false;
+
+	const bool totp = Isset(NET_OPT_USE_TOTP) ? GetOption<bool>(NET_OPT_USE_TOTP) : NET_OPT_DEFAULT_USE_TOTP;
+	const bool cipher = Isset(NET_OPT_USE_CIPHER) ? GetOption<bool>(NET_OPT_USE_CIPHER) : NET_OPT_DEFAULT_USE_CIPHER;
+
+	// never fall back to the plain encoding if the server requires the cipher
+	if (cipher && !peer->cryption.getHandshakeStatus())
+		return false;
+
+	Net::Frame::Frame_t* frame = nullptr;
+	if (cipher)
+	{
+		NET_CPOINTER<BYTE> data(encoded.copy_data());
+
+		NET_PACKET PKG;
+		PKG.SetRaw(encoded.copy_raw());
+
+		frame = EncodeFrame(peer, true, peer->framing, encoded.id, data, encoded.size, encoded.original_size, pkg);
+		if (!frame)
+		{
+			data.free();
+			return false;
+		}
+	}
+	else
+	{
+		auto& shared = encoded.plain[peer->framing - 1];
+		if (!shared)
+		{
+			NET_CPOINTER<BYTE> data(encoded.copy_data());
+
+			NET_PACKET PKG;
+			PKG.SetRaw(encoded.copy_raw());
+
+			const auto plain = EncodeFrame(nullptr, false, peer->framing, encoded.id, data, encoded.size, encoded.original_size, pkg);
+			shared = Net::Frame::Shared_t::create(plain->flatten(), plain->size());
+			FREE<Net::Frame::Frame_t>(plain);
+
+			if (!shared)
+				return false;
+		}
+
+		frame = ALLOC<Net::Frame::Frame_t>();
+		frame->share(shared);
+
+#ifdef BUILD_LINUX
+		if (!totp)
+			frame->set_zerocopy(UseZeroCopy(peer, shared->size()));
+#endif
+	}
+
+	if (totp)
+	{
+		const auto sendToken = Net::Coding::TOTP::generateToken(peer->totp_secret, peer->totp_secret_len, Isset(NET_OPT_USE_NTP) ? GetOption<bool>(NET_OPT_USE_NTP) : NET_OPT_DEFAULT_USE_NTP ? curTime : time(nullptr), Isset(NET_OPT_TOTP_INTERVAL) ? (int)(GetOption<int>(NET_OPT_TOTP_INTERVAL) / 2) : (int)(NET_OPT_DEFAULT_TOTP_INTERVAL / 2));
+		frame->mask(sendToken);
+	}
+
+	return EnqueueSend(peer, frame, GetPacketLane(encoded.id));
+}
+
+size_t Net::Server::Server::Broadcast(const int id, NET_PACKET& pkg)
+{
+	broadcast_t encoded;
+	if (!EncodeBroadcast(id, pkg, encoded))
+		return 0;
+
+	size_t sent = 0;
+	PeerRegistry.for_each([this, &encoded, &sent](void* peer) { if (DoSendEncoded(static_cast<NET_PEER>(peer), encoded)) ++sent; });
+	return sent;
+}
+
+size_t Net::Server::Server::Multicast(const char* group, const int id, NET_PACKET& pkg)
+{
+	// nobody is going to receive it
+	if (GetGroupSize(group) == 0)
+		return 0;
+
+	broadcast_t encoded;
+	if (!EncodeBroadcast(id, pkg, encoded))
+		return 0;
+
+	size_t sent = 0;
+	PeerRegistry.for_each(group, [this, &encoded, &sent](void* peer) { if (DoSendEncoded(static_cast<NET_PEER>(peer), encoded)) ++sent; });
+	return sent;
+}
+
+size_t Net::Server::Server::GetRateLimitDropped() const
+{
+	return RateLimitCounters.dropped;
+}
+
+size_t Net::Server::Server::GetRateLimitDelayed() const
+{
+	return RateLimitCounters.delayed;
+}
+
+size_t Net::Server::Server::GetRateLimitDisconnected() const
+{
+	return RateLimitCounters.disconnected;
+}
+
+size_t Net::Server::Server::GetRejectedConnections() const
+{
+	return RateLimitCounters.rejected;
+}
+
+size_t Net::Server::Server::GetFilteredFrames() const
+{
+	return RateLimitCounters.filtered;
+}
+
 bool Net::Server::Server::CreateTOTPSecret(NET_PEER peer)
 {
 	PEER_NOT_VALID(peer,
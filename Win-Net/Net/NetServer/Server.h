@@ -28,6 +28,12 @@
 #define NET_IPEER Net::Server::Server::peerInfo
 #define NET_PEER Net::Server::Server::peerInfo*
 
+/* bytes of the outbound queue that are committed to the wire order, a packet of a higher lane only has to wait for them */
+#define NET_SEND_COMMIT_SIZE (64 * 1024)
+
+/* SetPacketStreaming: the aes key and iv of a streamed frame are buffered, anything larger is not a key */
+#define NET_STREAM_MAX_KEY_SIZE (64 * 1024)
+
 #define PEER peer
 #define PKG pkg
 #define FUNCTION_NAME NET_FUNCTIONNAME
@@ -37,6 +43,13 @@
 #define NET_END_PACKET }
 #define NET_DECLARE_PACKET(fnc) void On##fnc(NET_PEER, NET_PACKET&)
 
+/* NET_USE_COROUTINES: the handler is a coroutine, end it using NET_END_PACKET as well */
+#define NET_BEGIN_PACKET_CO(cs, fnc) Net::Coroutine::Task_t cs::On##fnc(NET_PEER PEER, Net::Coroutine::Packet_t packet_owner) { \
+	NET_PACKET& PKG = packet_owner.get(); \
+	const char* NET_FUNCTIONNAME = CASTRING("On"#fnc);
+
+#define NET_DECLARE_PACKET_CO(fnc) Net::Coroutine::Task_t On##fnc(NET_PEER, Net::Coroutine::Packet_t)
+
 #define NET_NATIVE_PACKET_DEFINITION_BEGIN(classname) \
 bool classname::CheckDataN(NET_PEER peer, const int id, NET_PACKET& pkg) \
 { \
@@ -56,7 +69,8 @@ switch (id) \
 #define NET_DEFINE_PACKET(xxx, yyy) \
     case yyy: \
     { \
-      On##xxx(peer, pkg); \
+      if (!pkg.IsProbe()) \
+        On##xxx(peer, pkg); \
       break; \
     }
 
@@ -75,6 +89,7 @@ return true; \
 
 #include <Net/Net/Net.h>
 #include <Net/Net/NetPacket.h>
+#include <Net/Net/NetFrame.h>
 #include <Net/Net/NetCodes.h>
 #include <Net/Net/NetVersion.h>
 
@@ -93,6 +108,16 @@ return true; \
 #include <Net/assets/timer.h>
 
 #include <Net/Net/NetPeerPool.h>
+#include <Net/Net/NetReactor.h>
+#include <Net/Net/NetTaskPool.h>
+#include <Net/Net/NetCoroutine.h>
+#include <Net/Net/NetLane.h>
+#include <Net/Net/NetRegistry.h>
+#include <Net/Net/NetRateLimit.h>
+#include <Net/Net/NetFraming.h>
+
+#include <chrono>
+#include <condition_variable>
 
 #ifndef BUILD_LINUX
 #pragma warning(disable: 4302)
@@ -105,7 +130,6 @@ return true; \
 #define LAST_ERROR Ws2_32::WSAGetLastError()
 #endif
 
-NET_DSA_BEGIN
 namespace Net
 {
 	namespace Server
@@ -125,31 +149,90 @@ namespace Net
 		{
 			struct network_t
 			{
-				byte _dataReceive[NET_OPT_DEFAULT_MAX_PACKET_SIZE];
+				/*
+				* receive buffer, bytes are appended at the write cursor and consumed at the read cursor
+				* unread bytes are only moved to the front if there is no space left at the end
+				*/
 				NET_CPOINTER<byte> _data;
-				size_t _data_size;
+				size_t _data_capacity;
+				size_t _data_read;
+				size_t _data_write;
 				size_t _data_full_size;
 				size_t _data_offset;
 				size_t _data_original_uncompressed_size;
+				size_t _data_skip; /* bytes of a dropped frame that have not been received yet */
 				std::mutex _mutex_send;
 
+				/*
+				* outbound queue, guarded by _mutex_send
+				* frames wait in the queue of their lane and are committed to the wire order in small portions,
+				* a committed frame goes out completely before the next one
+				* the queues only exist while frames are pending, an idle peer does not hold them
+				*/
+				struct send_queue_t
+				{
+					std::deque<Net::Frame::Frame_t*> lanes[NET_LANES];
+					std::deque<Net::Frame::Frame_t*> queue;
+
+#ifdef BUILD_LINUX
+					/* MSG_ZEROCOPY: sent frames waiting for their completion id */
+					std::deque<std::pair<uint32_t, Net::Frame::Frame_t*>> zerocopy_pending;
+#endif
+				};
+
+				send_queue_t* _send;
+				Net::Lane::Scheduler_t _send_scheduler;
+				size_t _send_queue_committed;
+				size_t _send_queue_size;
+				bool _send_queue_full;
+
+				/* write coalescing, guarded by _mutex_send */
+				bool _send_coalesce;
+				size_t _send_corked; /* bytes queued since the last flush */
+				std::chrono::steady_clock::time_point _send_corked_until; /* end of the window */
+
+#ifdef BUILD_LINUX
+				/* MSG_ZEROCOPY, guarded by _mutex_send */
+				uint32_t _zerocopy_next;
+				int _zerocopy; /* 0 = not requested yet, 1 = enabled, -1 = not supported */
+#endif
+
 				network_t()
 				{
-					reset();
+					_send = nullptr;
+					_send_queue_committed = 0;
+					_send_queue_size = 0;
+					_send_queue_full = false;
+					_send_coalesce = false;
+					_send_corked = 0;
+#ifdef BUILD_LINUX
+					_zerocopy_next = 0;
+					_zerocopy = 0;
+#endif
+
 					clear();
 				}
 
-				void setData(byte*);
+				~network_t()
+				{
+					clearSendQueue();
+					deallocData();
+				}
 
-				void allocData(size_t);
 				void deallocData();
 
+				/* ensure there is space for atleast the amount of bytes starting at the read cursor */
+				bool reserveData(size_t);
+				bool appendData(const byte*, size_t);
+				void consumeData(size_t);
+
+				/* discards the current frame, including the part that is still on the way */
+				void skipData(size_t);
+
 				byte* getData() const;
 
-				void reset();
 				void clear();
 
-				void setDataSize(size_t);
 				size_t getDataSize() const;
 
 				void setDataFullSize(size_t);
@@ -163,7 +246,15 @@ namespace Net
 
 				bool dataValid() const;
 
-				byte* getDataReceive();
+				/* per thread scratch space, see Net::ReceiveBuffer */
+				static byte* getDataReceive();
+
+				/* creates the queues on the first send */
+				send_queue_t* getSendQueue();
+				void releaseSendQueue();
+
+				void commitSendQueue();
+				void clearSendQueue();
 			};
 
 			struct cryption_t
@@ -198,9 +289,18 @@ namespace Net
 				/* Erase Handler */
 				bool bErase;
 
+				/* NET_OPT_RATE_LIMIT_* */
+				Net::RateLimit::Bucket_t bytes_bucket;
+				Net::RateLimit::Bucket_t packets_bucket;
+				bool bDelayed; /* the next frame waits for tokens, the socket is not read meanwhile */
+				bool bCountedAddress; /* counted for NET_OPT_MAX_CONNECTIONS_PER_IP */
+
 				/* Net Version */
 				bool NetVersionMatched;
 
+				/* framing of the frames we send, negotiated during the version exchange */
+				int framing;
+
 				typeLatency latency;
 				NET_HANDLE_TIMER hCalcLatency;
 
@@ -216,6 +316,59 @@ namespace Net
 
 				std::mutex _mutex_disconnectPeer;
 
+				/* a frame of a streamed packet (see SetPacketStreaming), only its section table and the json document are kept */
+				struct stream_t
+				{
+					enum class State_t : uint8_t
+					{
+						IDLE = 0,
+						TABLE,
+						START, /* waits for the packets received before, see StartStream */
+						BODY
+					};
+
+					State_t state;
+					int id;
+					bool cipher;
+					std::atomic<bool> paused; /* requested from any thread, applied by the worker of the peer */
+					std::atomic<bool> started;
+
+					Net::Framing::Reader_t reader;
+					NET_AES* aes;
+
+					NET_CPOINTER<BYTE> key;
+					size_t key_size;
+					NET_CPOINTER<BYTE> iv;
+					size_t iv_size;
+					NET_CPOINTER<BYTE> json;
+					size_t json_size;
+
+					stream_t()
+					{
+						state = State_t::IDLE;
+						id = -1;
+						cipher = false;
+						paused = false;
+						started = false;
+						aes = nullptr;
+						key_size = 0;
+						iv_size = 0;
+						json_size = 0;
+					}
+
+					~stream_t()
+					{
+						clear();
+					}
+
+					void clear();
+				} stream;
+
+#ifdef NET_USE_COROUTINES
+				/* handlers executed on the receiving worker continue in between the packets of the peer */
+				Net::Coroutine::Inbox_t coroutines;
+#endif
+
 				peerInfo()
 				{
 					UniqueID = INVALID_UID;
@@ -223,7 +376,10 @@ namespace Net
 					client_addr = sockaddr_in();
 					estabilished = false;
 					bErase = false;
+					bDelayed = false;
+					bCountedAddress = false;
 					NetVersionMatched = false;
+					framing = NET_FRAMING_V1;
 					latency = -1;
 					hCalcLatency = nullptr;
 					totp_secret = nullptr;
@@ -240,6 +396,55 @@ namespace Net
 
 		private:
 			Net::PeerPool::PeerPool_t PeerPoolManager;
+#ifdef BUILD_LINUX
+			Net::Reactor::Reactor_t PeerReactorManager;
+#endif
+
+			/* NET_OPT_EXECUTE_PACKET_ASYNC: one strand per peer */
+			Net::TaskPool::TaskPool_t PacketTaskPool;
+
+			/* NET_OPT_PIPELINE: decodes the frames before they are being dispatched, one strand per peer */
+			Net::TaskPool::TaskPool_t PacketPipelinePool;
+
+			/* priority class per packet id, ids without an entry are bulk */
+			std::vector<Net::Lane::Lane_t> PacketLanes;
+
+			/* packet ids whose raw data is handed to OnPacketStream while being received */
+			std::vector<bool> PacketStreams;
+
+			/* connected peers by their unique id and the groups they joined */
+			Net::Registry::Registry_t PeerRegistry;
+
+			/* Broadcast & Multicast: the packet gets encoded once */
+			struct broadcast_t;
+			bool EncodeBroadcast(int, NET_PACKET&, broadcast_t&);
+			bool DoSendEncoded(NET_PEER, broadcast_t&);
+
+			/* admission control */
+			Net::RateLimit::Counters_t RateLimitCounters;
+			std::unordered_map<uint32_t, size_t> ConnectionsPerIP;
+			std::mutex ConnectionsPerIPMutex;
+
+			/*
+			* write coalescing: peers holding back frames, in the order their window ends - the window is the same for all of them
+			* only the frame starting a window adds the peer, a dedicated thread flushes it once the window has passed
+			*/
+			struct corked_t
+			{
+				NET_PEER peer;
+				std::chrono::steady_clock::time_point until;
+			};
+
+			std::deque<corked_t> CorkedPeers;
+			std::mutex CorkedPeersMutex;
+			std::condition_variable CorkedPeersCondition;
+			NET_PEER CorkedPeerFlushing; /* taken off the list and being flushed by the thread right now */
+
+			void Cork(NET_PEER, std::chrono::steady_clock::time_point until);
+
+			/* erase: the peer leaves the list, a flush that is still running finishes first */
+			void Uncork(NET_PEER);
+			void FlushExpired(NET_PEER);
 
 		public:
 			/* time */
@@ -254,7 +459,7 @@ namespace Net
 			size_t GetReceivedPacketSize(NET_PEER);
 			float GetReceivedPacketSizeAsPerc(NET_PEER);
 
-			DWORD optionBitFlag;
+			uint64_t optionBitFlag;
 			std::vector<OptionInterface_t*> option;
 
 			DWORD socketOptionBitFlag;
@@ -265,8 +470,16 @@ namespace Net
 			bool bRunning;
 
 			bool ValidHeader(NET_PEER, bool&);
+			bool ProcessPacket(NET_PEER);
 			void ProcessPackets(NET_PEER);
-			void ExecutePacket(NET_PEER);
+			bool AdmitFrame(NET_PEER);
+
+			/* binary framing */
+			bool UseBinaryFraming();
+			bool ProcessFrame(NET_PEER);
+			bool RouteFrame(NET_PEER, int id);
+			bool ProcessStream(NET_PEER);
+			bool FinishStream(NET_PEER);
 
 			/* Native Packets */
 			NET_DECLARE_PACKET(RSAHandshake);
@@ -278,6 +491,23 @@ namespace Net
 			void DecompressData(BYTE*&, BYTE*&, size_t&, size_t, bool = false);
 			bool CreateTOTPSecret(NET_PEER);
 
+			Net::Frame::Frame_t* EncodeFrame(NET_PEER, bool, int, int, NET_CPOINTER<BYTE>&, size_t, size_t, NET_PACKET&);
+			bool EnqueueSend(NET_PEER, Net::Frame::Frame_t*, Net::Lane::Lane_t = Net::Lane::Lane_t::BULK);
+			bool FlushSendQueue(NET_PEER);
+
+			bool CreateTCPListener();
+
+#ifdef BUILD_LINUX
+			bool UseReusePort();
+			SOCKET CreateReusePortListener();
+
+			const char* UnixPath();
+			SOCKET CreateUnixListener(const char*);
+
+			bool UseZeroCopy(NET_PEER, size_t);
+			void ReapZeroCopy(NET_PEER);
+#endif
+
 		public:
 			Server();
 			virtual ~Server();
@@ -310,10 +540,10 @@ namespace Net
 				optionBitFlag |= o.opt;
 			}
 
-			bool Isset(DWORD) const;
+			bool Isset(uint64_t) const;
 
 			template <class T>
-			T GetOption(const DWORD opt)
+			T GetOption(const uint64_t opt)
 			{
 				if (!Isset(opt)) return NULL;
 				for (auto& entry : option)
@@ -368,16 +598,128 @@ namespace Net
 			void SingleSend(NET_PEER, NET_CPOINTER<BYTE>&, size_t, bool&, uint32_t = INVALID_UINT_SIZE);
 			void SingleSend(NET_PEER, Net::RawData_t&, bool&, uint32_t = INVALID_UINT_SIZE);
 			void DoSend(NET_PEER, int, NET_PACKET&);
+			void DoFlush(NET_PEER);
+
+			/* write coalescing of the peer, see NET_OPT_COALESCE */
+			void SetCoalescing(NET_PEER, bool);
+			bool IsCoalescing(NET_PEER);
+
+			/* writes the queued frames of the peer right away, for latency critical paths of coalescing peers */
+			void Flush(NET_PEER);
+
+			/* writes the frames the coalescing peer is holding back */
+			void FlushCorked(NET_PEER);
+
+			/* flushes the corked peers as soon as their window has passed, runs until the server stops */
+			void FlushCorkedLoop();
 
 			void add_to_peer_threadpool(Net::PeerPool::peerInfo_t);
 			void add_to_peer_threadpool(Net::PeerPool::peerInfo_t*);
+#ifdef BUILD_LINUX
+			bool add_to_peer_reactor(SOCKET, Net::PeerPool::peerInfo_t, size_t = INVALID_SIZE);
+			bool peer_reactor_uses_uring() const;
+#endif
 
 			size_t count_peers_all();
 			size_t count_peers(Net::PeerPool::peer_threadpool_t* pool);
 			size_t count_pools();
 
+			/* NET_OPT_EXECUTE_PACKET_ASYNC: packets waiting for their execution, the highest amount seen and how often receiving had to wait */
+			size_t GetPacketQueueDepth() const;
+			size_t GetPacketQueuePeak() const;
+			size_t GetPacketQueueThrottled() const;
+
+			/* NET_OPT_PIPELINE: the same for the frames waiting to be decoded */
+			size_t GetPipelineQueueDepth() const;
+			size_t GetPipelineQueuePeak() const;
+			size_t GetPipelineQueueThrottled() const;
+
+			/*
+			* has to be set before Run - the packets of a higher class are executed and sent before the queued packets of lower classes
+			* native packets are always of the native class
+			*/
+			void SetPacketLane(int id, Net::Lane::Lane_t lane);
+			Net::Lane::Lane_t GetPacketLane(int id) const;
+
+			/*
+			* has to be set before Run - binary framing: the raw data of the packet is handed to OnPacketStream while it is being received
+			* the frame is never buffered as a whole, the handler is executed afterwards with the json document only
+			* compressed frames are buffered as usual, native packets can not be streamed
+			*/
+			void SetPacketStreaming(int id, bool enable);
+			bool IsPacketStreaming(int id) const;
+
+			/* backpressure of a stream, the socket of the peer is not read while it is paused - it continues with the next tick after resuming, a pause without a running stream has no effect */
+			void PauseStream(NET_PEER);
+			void ResumeStream(NET_PEER);
+
+			/* estabilished peers, a peer is registered before OnPeerEstabilished and unregistered before OnPeerDisconnect */
+			NET_PEER GetPeer(NET_UID);
+			size_t GetPeerCount() const;
+			size_t ForEachPeer(void (*fnc)(NET_PEER peer, void* param), void* param);
+
+			/* named groups (rooms), a group exists as long as it has members - only estabilished peers can join */
+			bool JoinGroup(NET_PEER, const char* group);
+			bool LeaveGroup(NET_PEER, const char* group);
+			size_t GetGroupSize(const char* group) const;
+
+			/*
+			* sends the packet to every peer (of the group) and returns the amount of peers it has been queued for, the packet can be reused afterwards
+			* the peers are visited while holding the registry lock, callbacks raised meanwhile (ForEachPeer, OnPeerSendQueueFull) must not join, leave or broadcast
+			*/
+			size_t Broadcast(int id, NET_PACKET&);
+			size_t Multicast(const char* group, int id, NET_PACKET&);
+
+			/* NET_OPT_RATE_LIMIT_* and NET_OPT_MAX_CONNECTIONS_PER_IP */
+			size_t GetRateLimitDropped() const;
+			size_t GetRateLimitDelayed() const;
+			size_t GetRateLimitDisconnected() const;
+			size_t GetRejectedConnections() const;
+
+			/* binary framing: frames dropped by OnPacketFilter */
+			size_t GetFilteredFrames() const;
+
+			/* asks the packet definitions without executing them, only if NET_OPT_REJECT_UNKNOWN_PACKETS has been enabled */
+			bool IsPacketDefined(NET_PEER, int id);
+
+			/* processes the frame of a delayed peer as soon as it got enough tokens, called on each peer tick */
+			void ContinueDelayed(NET_PEER);
+
 			void Acceptor();
+#ifdef BUILD_LINUX
+			void DrainAcceptor(SOCKET, size_t);
+			void AcceptPeer(SOCKET, size_t);
+#endif
 			bool DoReceive(NET_PEER);
+			bool DoReceive(NET_PEER, const byte*, int64);
+
+			/* a complete frame, delimited and unmasked by the receiving thread */
+			struct received_frame_t
+			{
+				byte* data;
+				size_t size;
+			};
+
+			bool DecodeAsync(NET_PEER, const received_frame_t&);
+			void ExecutePacket(NET_PEER, const received_frame_t&);
+
+			/* reads the sections of either framing into the packet and the json buffer, the peer has been disconnected if it fails */
+			bool DecodeFrame(NET_PEER, const received_frame_t&, Net::Packet&, NET_CPOINTER<BYTE>&);
+
+			/* the packet workers if they are running */
+			Net::TaskPool::TaskPool_t* PacketPool();
+
+			/* where a handler that has been executed inline continues: the pipeline workers if they are running, nullptr for the receiving workers */
+			Net::TaskPool::TaskPool_t* ResumePool();
+
+			/*
+			* a streamed frame starts behind the packets received before it, without waiting for them
+			* one task per lane passes the pipeline and afterwards the packet workers, the last one of them marks the stream as started
+			*/
+			void StartStream(NET_PEER, Net::TaskPool::TaskPool_t* passed = nullptr);
+
+			/* closes the connection and clears the peer, once its suspended handlers have finished */
+			void FinishErasePeer(NET_PEER);
 
 			NET_DEFINE_CALLBACK(void, OnPeerUpdate, NET_PEER) {}
 
@@ -385,7 +727,20 @@ namespace Net
 			NET_DEFINE_CALLBACK(void, OnPeerConnect, NET_PEER) {}
 			NET_DEFINE_CALLBACK(void, OnPeerDisconnect, NET_PEER, int last_error) {}
 			NET_DEFINE_CALLBACK(void, OnPeerEstabilished, NET_PEER) {}
+			NET_DEFINE_CALLBACK(void, OnPeerSendQueueFull, NET_PEER, size_t queued_bytes) {}
+
+			/*
+			* binary framing: raised on the receiving thread as soon as the header of a frame has been read, before its body has been received
+			* return false to drop the frame, the peer can be disconnected from within
+			*/
+			NET_DEFINE_CALLBACK(bool, OnPacketFilter, NET_PEER, int id) { return true; }
+
+			/*
+			* SetPacketStreaming: raised on the receiving thread for each piece of a raw data section as soon as it has been received and decrypted
+			* offset and total tell the position within the section, the piece is only valid during the call
+			* return false to abort the stream, the peer gets disconnected
+			*/
+			NET_DEFINE_CALLBACK(bool, OnPacketStream, NET_PEER, int id, const char* key, const byte* data, size_t size, size_t offset, size_t total) { return true; }
 		};
 	}
 }
-NET_DSA_END
\ No newline at end of file
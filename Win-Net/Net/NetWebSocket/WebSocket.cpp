@@ -63,7 +63,7 @@ Net::WebSocket::Server::~Server()
 	option.clear();
 }
 
-bool Net::WebSocket::Server::Isset(const DWORD opt) const
+bool Net::WebSocket::Server::Isset(const uint64_t opt) const
 {
 	// use the bit flag to perform faster checks
 	return optionBitFlag & opt;
@@ -128,11 +128,6 @@ byte* Net::WebSocket::Server::network_t::getDataFragmented() const
 	return _dataFragment.get();
 }
 
-void Net::WebSocket::Server::network_t::reset()
-{
-	memset(_dataReceive, NULL, NET_OPT_DEFAULT_MAX_PACKET_SIZE * sizeof(byte));
-}
-
 void Net::WebSocket::Server::network_t::clear()
 {
 	deallocData();
@@ -172,7 +167,7 @@ bool Net::WebSocket::Server::network_t::dataFragmentValid() const
 
 byte* Net::WebSocket::Server::network_t::getDataReceive()
 {
-	return _dataReceive;
+	return Net::ReceiveBuffer();
 }
 #pragma endregion
 
@@ -292,6 +287,14 @@ bool Net::WebSocket::Server::ErasePeer(NET_PEER peer, bool clear)
 
 	if (clear)
 	{
+		// the packets of this peer that are still queued must not see it being freed
+		PacketTaskPool.wait(peer);
+
+#ifdef NET_USE_COROUTINES
+		// suspended handlers of this peer
+		Net::Coroutine::Wait(peer);
+#endif
+
 		// close endpoint
 		SOCKET_VALID(peer->pSocket)
 		{
@@ -360,7 +363,6 @@ void Net::WebSocket::Server::peerInfo::clear()
 	hCalcLatency = nullptr;
 
 	network.clear();
-	network.reset();
 
 	if (ssl)
 	{
@@ -632,6 +634,16 @@ bool Net::WebSocket::Server::Run()
 		return false;
 	}
 
+	if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
+	{
+		PacketTaskPool.set_num_threads(Isset(NET_OPT_EXECUTE_PACKET_THREADS) ? GetOption<size_t>(NET_OPT_EXECUTE_PACKET_THREADS) : NET_OPT_DEFAULT_EXECUTE_PACKET_THREADS);
+		PacketTaskPool.set_max_depth(Isset(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) ? GetOption<size_t>(NET_OPT_EXECUTE_PACKET_QUEUE_LIMIT) : NET_OPT_DEFAULT_EXECUTE_PACKET_QUEUE_LIMIT);
+
+		// packets are still being executed, just on the receiving thread
+		if (!PacketTaskPool.start())
+			NET_LOG_ERROR(CSTRING("[%s] - Unable to start the packet workers, executing packets synchronously"), SERVERNAME(this));
+	}
+
 	Thread::Create(TickThread, this);
 	Thread::Create(AcceptorThread, this);
 
@@ -650,6 +662,9 @@ bool Net::WebSocket::Server::Close()
 
 	SetRunning(false);
 
+	// execute the packets that are left
+	PacketTaskPool.stop();
+
 	if (GetListenSocket())
 		Ws2_32::closesocket(GetListenSocket());
 
@@ -677,7 +692,6 @@ short Net::WebSocket::Server::Handshake(NET_PEER peer)
 		if (data_size <= 0)
 		{
 			const auto err = SSL_get_error(peer->ssl, data_size);
-			peer->network.reset();
 			if (err != SSL_ERROR_SSL && err != SSL_ERROR_WANT_READ)
 			{
 				ErasePeer(peer);
@@ -704,16 +718,12 @@ short Net::WebSocket::Server::Handshake(NET_PEER peer)
 			peer->network.setDataSize(peer->network.getDataSize() + data_size);
 			peer->network.setData(newBuffer); // pointer swap
 		}
-
-		peer->network.reset();
 	}
 	else
 	{
 		const auto data_size = Ws2_32::recv(peer->pSocket, reinterpret_cast<char*>(peer->network.getDataReceive()), NET_OPT_DEFAULT_MAX_PACKET_SIZE, 0);
 		if (data_size == SOCKET_ERROR)
 		{
-			peer->network.reset();
-
 #ifdef BUILD_LINUX
 			if (errno != EWOULDBLOCK)
 #else
@@ -737,7 +747,6 @@ short Net::WebSocket::Server::Handshake(NET_PEER peer)
 		// graceful disconnect
 		if (data_size == 0)
 		{
-			peer->network.reset();
 			ErasePeer(peer);
 			NET_LOG_PEER(CSTRING("[%s] - Peer ('%s'): connection has been gracefully closed"), SERVERNAME(this), peer->IPAddr().get());
 			return WebServerHandshake::HandshakeRet_t::error;
@@ -757,8 +766,6 @@ short Net::WebSocket::Server::Handshake(NET_PEER peer)
 			peer->network.setDataSize(peer->network.getDataSize() + data_size);
 			peer->network.setData(newBuffer); // pointer swap
 		}
-
-		peer->network.reset();
 	}
 
 	std::string tmp(reinterpret_cast<const char*>(peer->network.getData()));
@@ -1249,7 +1256,6 @@ DWORD Net::WebSocket::Server::DoReceive(NET_PEER peer)
 		if (data_size <= 0)
 		{
 			const auto err = SSL_get_error(peer->ssl, data_size);
-			peer->network.reset();
 			if (err != SSL_ERROR_SSL && err != SSL_ERROR_WANT_READ)
 			{
 				ErasePeer(peer);
@@ -1275,16 +1281,12 @@ DWORD Net::WebSocket::Server::DoReceive(NET_PEER peer)
 			peer->network.setDataSize(peer->network.getDataSize() + data_size);
 			peer->network.setData(newBuffer); // pointer swap
 		}
-
-		peer->network.reset();
 	}
 	else
 	{
 		const auto data_size = Ws2_32::recv(peer->pSocket, reinterpret_cast<char*>(peer->network.getDataReceive()), NET_OPT_DEFAULT_MAX_PACKET_SIZE, 0);
 		if (data_size == SOCKET_ERROR)
 		{
-			peer->network.reset();
-
 #ifdef BUILD_LINUX
 			if (errno != EWOULDBLOCK)
 #else
@@ -1308,7 +1310,6 @@ DWORD Net::WebSocket::Server::DoReceive(NET_PEER peer)
 		// graceful disconnect
 		if (data_size == 0)
 		{
-			peer->network.reset();
 			ErasePeer(peer);
 			NET_LOG_PEER(CSTRING("[%s] - Peer ('%s'): connection has been gracefully closed"), SERVERNAME(this), peer->IPAddr().get());
 			return FREQUENZ(this);
@@ -1328,8 +1329,6 @@ DWORD Net::WebSocket::Server::DoReceive(NET_PEER peer)
 			peer->network.setDataSize(peer->network.getDataSize() + data_size);
 			peer->network.setData(newBuffer); // pointer swap
 		}
-
-		peer->network.reset();
 	}
 
 	DecodeFrame(peer);
@@ -1520,21 +1519,25 @@ struct TPacketExcecute
 	int m_packetId;
 };
 
-NET_THREAD(ThreadPacketExecute)
+static void PacketExecuteTask(void* param)
 {
-	auto tpe = (TPacketExcecute*)parameter;
+	auto tpe = (TPacketExcecute*)param;
 	if (!tpe)
 	{
-		return 1;
+		return;
 	}
 
+#ifdef NET_USE_COROUTINES
+	// a suspended handler continues on the strand of its peer
+	Net::Coroutine::Scope_t scope(tpe->m_server->getPacketPool(), tpe->m_peer);
+#endif
+
 	if (!tpe->m_server->CheckDataN(tpe->m_peer, tpe->m_packetId, *tpe->m_packet))
 		if (!tpe->m_server->CheckData(tpe->m_peer, tpe->m_packetId, *tpe->m_packet))
 			tpe->m_server->DisconnectPeer(tpe->m_peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
 
 	FREE<Net::Packet>(tpe->m_packet);
 	FREE<TPacketExcecute>(tpe);
-	return 0;
 }
 
 void Net::WebSocket::Server::ProcessPacket(NET_PEER peer, BYTE* data, const size_t size)
@@ -1607,7 +1610,8 @@ void Net::WebSocket::Server::ProcessPacket(NET_PEER peer, BYTE* data, const size
 	}
 
 	/*
-	* check for option async to execute the callback in a seperate thread
+	* check for option async to execute the callback on the packet workers
+	* the peer is the key of the strand, soo its packets keep their order
 	*/
 	if (Isset(NET_OPT_EXECUTE_PACKET_ASYNC) ? GetOption<bool>(NET_OPT_EXECUTE_PACKET_ASYNC) : NET_OPT_DEFAULT_EXECUTE_PACKET_ASYNC)
 	{
@@ -1616,7 +1620,10 @@ void Net::WebSocket::Server::ProcessPacket(NET_PEER peer, BYTE* data, const size
 		tpe->m_server = this;
 		tpe->m_peer = peer;
 		tpe->m_packetId = packetId;
-		if (Net::Thread::Create(ThreadPacketExecute, tpe))
+
+		// every peer has its own receiving thread, only this one waits until the workers caught up
+		PacketTaskPool.throttle(peer);
+		if (PacketTaskPool.post(peer, &PacketExecuteTask, tpe))
 		{
 			return;
 		}
@@ -1627,9 +1634,16 @@ void Net::WebSocket::Server::ProcessPacket(NET_PEER peer, BYTE* data, const size
 	/*
 	* execute in current thread
 	*/
-	if (!CheckDataN(peer, packetId, *pPacket.ref().get()))
-		if (!CheckData(peer, packetId, *pPacket.ref().get()))
-			DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
+	{
+#ifdef NET_USE_COROUTINES
+		// without packet workers a suspended handler continues on the coroutine workers, still serialized per peer
+		Net::Coroutine::Scope_t scope(getPacketPool(), peer);
+#endif
+
+		if (!CheckDataN(peer, packetId, *pPacket.ref().get()))
+			if (!CheckData(peer, packetId, *pPacket.ref().get()))
+				DisconnectPeer(peer, NET_ERROR_CODE::NET_ERR_UndefinedFrame);
+	}
 
 	pPacket.free();
 }
@@ -1649,5 +1663,25 @@ size_t Net::WebSocket::Server::getCountPeers() const
 	return _CounterPeersTable;
 }
 
+Net::TaskPool::TaskPool_t* Net::WebSocket::Server::getPacketPool()
+{
+	return PacketTaskPool.is_running() ? &PacketTaskPool : nullptr;
+}
+
+size_t Net::WebSocket::Server::getPacketQueueDepth() const
+{
+	return PacketTaskPool.depth();
+}
+
+size_t Net::WebSocket::Server::getPacketQueuePeak() const
+{
+	return PacketTaskPool.peak_depth();
+}
+
+size_t Net::WebSocket::Server::getPacketQueueThrottled() const
+{
+	return PacketTaskPool.throttled();
+}
+
 NET_NATIVE_PACKET_DEFINITION_BEGIN(Net::WebSocket::Server)
 NET_PACKET_DEFINITION_END
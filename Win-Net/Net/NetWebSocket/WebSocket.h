@@ -36,6 +36,13 @@
 #define NET_END_PACKET }
 #define NET_DECLARE_PACKET(fnc) void On##fnc(NET_PEER, NET_PACKET&)
 
+/* NET_USE_COROUTINES: the handler is a coroutine, end it using NET_END_PACKET as well */
+#define NET_BEGIN_PACKET_CO(cs, fnc) Net::Coroutine::Task_t cs::On##fnc(NET_PEER PEER, Net::Coroutine::Packet_t packet_owner) { \
+	NET_PACKET& PKG = packet_owner.get(); \
+	const char* NET_FUNCTIONNAME = CASTRING("On"#fnc);
+
+#define NET_DECLARE_PACKET_CO(fnc) Net::Coroutine::Task_t On##fnc(NET_PEER, Net::Coroutine::Packet_t)
+
 #define NET_NATIVE_PACKET_DEFINITION_BEGIN(classname) \
 bool classname::CheckDataN(NET_PEER peer, const int id, NET_PACKET& pkg) \
 { \
@@ -115,13 +122,14 @@ CONSTEXPR auto NET_WS_PAYLOAD_LENGTH_63 = 127;
 
 #include <Net/Protocol/ICMP.h>
 
+#include <Net/Net/NetTaskPool.h>
+#include <Net/Net/NetCoroutine.h>
 #include <Net/assets/thread.h>
 #include <Net/assets/timer.h>
 #include <Net/assets/manager/filemanager.h>
 
 #include <mutex>
 
-NET_DSA_BEGIN
 namespace Net
 {
 	namespace WebSocket
@@ -141,7 +149,6 @@ namespace Net
 		{
 			struct network_t
 			{
-				byte _dataReceive[NET_OPT_DEFAULT_MAX_PACKET_SIZE];
 				NET_CPOINTER<byte> _data;
 				size_t _data_size;
 				NET_CPOINTER<byte> _dataFragment;
@@ -150,7 +157,6 @@ namespace Net
 
 				network_t()
 				{
-					reset();
 					clear();
 				}
 
@@ -166,7 +172,6 @@ namespace Net
 				byte* getData() const;
 				byte* getDataFragmented() const;
 
-				void reset();
 				void clear();
 
 				void setDataSize(size_t);
@@ -178,7 +183,8 @@ namespace Net
 				bool dataValid() const;
 				bool dataFragmentValid() const;
 
-				byte* getDataReceive();
+				/* per thread scratch space, see Net::ReceiveBuffer */
+				static byte* getDataReceive();
 			};
 
 		public:
@@ -230,7 +236,7 @@ namespace Net
 			void DecreasePeersCounter();
 			NET_PEER CreatePeer(sockaddr_in, SOCKET);
 
-			DWORD optionBitFlag;
+			uint64_t optionBitFlag;
 			std::vector<OptionInterface_t*> option;
 
 			DWORD socketOptionBitFlag;
@@ -242,6 +248,9 @@ namespace Net
 			bool bRunning;
 			bool bShuttingDown;
 
+			/* NET_OPT_EXECUTE_PACKET_ASYNC: one strand per peer */
+			Net::TaskPool::TaskPool_t PacketTaskPool;
+
 			void DecodeFrame(NET_PEER);
 			void EncodeFrame(BYTE*, size_t, NET_PEER, unsigned char = NET_OPCODE_TEXT);
 			void ProcessPacket(NET_PEER, BYTE*, size_t);
@@ -277,10 +286,10 @@ namespace Net
 				optionBitFlag |= o.opt;
 			}
 
-			bool Isset(DWORD) const;
+			bool Isset(uint64_t) const;
 
 			template <class T>
-			T GetOption(const DWORD opt)
+			T GetOption(const uint64_t opt)
 			{
 				if (!Isset(opt)) return NULL;
 				for (auto& entry : option)
@@ -346,6 +355,14 @@ namespace Net
 
 			size_t getCountPeers() const;
 
+			/* NET_OPT_EXECUTE_PACKET_ASYNC: packets waiting for their execution, the highest amount seen and how often receiving had to wait */
+			size_t getPacketQueueDepth() const;
+			size_t getPacketQueuePeak() const;
+			size_t getPacketQueueThrottled() const;
+
+			/* the packet workers if they are running */
+			Net::TaskPool::TaskPool_t* getPacketPool();
+
 			DWORD DoReceive(NET_PEER);
 
 			NET_DEFINE_CALLBACK(void, OnPeerEstabilished, NET_PEER) {}
@@ -358,4 +375,3 @@ namespace Net
 		};
 	}
 }
-NET_DSA_END
\ No newline at end of file